@@ -0,0 +1,749 @@
+/*
+ * Knight Engine 2D - Audio Mixer Implementation
+ */
+
+#include "audio/audio.h"
+#include "util/alloc.h"
+#include "util/log.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUDIO_SIMD_NEON 1
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define AUDIO_CHANNELS 2
+#define AUDIO_COMMAND_MASK (AUDIO_COMMAND_QUEUE_SIZE - 1)
+#define AUDIO_STREAM_RING_MASK (AUDIO_STREAM_RING_FRAMES - 1)
+
+/* Queue positions wrap; compare through unsigned subtraction */
+static int position_diff(int a, int b) {
+    return (int)((unsigned int)a - (unsigned int)b);
+}
+
+static int position_add(int a, int n) {
+    return (int)((unsigned int)a + (unsigned int)n);
+}
+
+/* ============================================================================
+ * MIXING KERNELS
+ * ============================================================================ */
+
+/*
+ * dst += src * gain over interleaved stereo frames, separate L/R gains
+ */
+static void mix_add_stereo(float *dst, const float *src, int frames,
+                           float gain_l, float gain_r) {
+    int n = frames * AUDIO_CHANNELS;
+    int i = 0;
+
+#if defined(AUDIO_SIMD_SSE2)
+    __m128 gain = _mm_setr_ps(gain_l, gain_r, gain_l, gain_r);
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(dst + i),
+                              _mm_mul_ps(_mm_loadu_ps(src + i), gain));
+        __m128 b = _mm_add_ps(_mm_loadu_ps(dst + i + 4),
+                              _mm_mul_ps(_mm_loadu_ps(src + i + 4), gain));
+        _mm_storeu_ps(dst + i, a);
+        _mm_storeu_ps(dst + i + 4, b);
+    }
+#elif defined(AUDIO_SIMD_NEON)
+    const float gains[4] = { gain_l, gain_r, gain_l, gain_r };
+    float32x4_t gain = vld1q_f32(gains);
+    for (; i + 8 <= n; i += 8) {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+        vst1q_f32(dst + i + 4, vmlaq_f32(vld1q_f32(dst + i + 4), vld1q_f32(src + i + 4), gain));
+    }
+#endif
+
+    /* Scalar tail (and the whole buffer without SIMD); n is always even */
+    for (; i < n; i += 2) {
+        dst[i] += src[i] * gain_l;
+        dst[i + 1] += src[i + 1] * gain_r;
+    }
+}
+
+/*
+ * Scale the float mix by the master volume and write saturated S16 samples
+ */
+static void mix_to_s16(Sint16 *out, const float *mix, int samples, float master) {
+    float scale = 32767.0f * master;
+    int i = 0;
+
+#if defined(AUDIO_SIMD_SSE2)
+    __m128 vscale = _mm_set1_ps(scale);
+    __m128 lo = _mm_set1_ps(-32768.0f);
+    __m128 hi = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= samples; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(mix + i), vscale), lo), hi);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(mix + i + 4), vscale), lo), hi);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128((__m128i *)(void *)(out + i), packed);
+    }
+#elif defined(AUDIO_SIMD_NEON)
+    float32x4_t vscale = vdupq_n_f32(scale);
+    for (; i + 8 <= samples; i += 8) {
+        /* Float->int conversion and the narrowing both saturate */
+        int32x4_t a = vcvtq_s32_f32(vmulq_f32(vld1q_f32(mix + i), vscale));
+        int32x4_t b = vcvtq_s32_f32(vmulq_f32(vld1q_f32(mix + i + 4), vscale));
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+#endif
+
+    for (; i < samples; i++) {
+        float v = mix[i] * scale;
+        if (v > 32767.0f) {
+            v = 32767.0f;
+        } else if (v < -32768.0f) {
+            v = -32768.0f;
+        }
+        out[i] = (Sint16)v;
+    }
+}
+
+/* ============================================================================
+ * AUDIO THREAD
+ * ============================================================================ */
+
+static audio_voice_t *find_voice(audio_t *audio, audio_voice_handle_t handle) {
+    for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+        if (audio->voices[i].handle == handle) {
+            return &audio->voices[i];
+        }
+    }
+    return NULL;
+}
+
+static void start_voice(audio_t *audio, const audio_cmd_t *cmd, bool is_stream) {
+    /* A stream has a single read position, so it can only feed one voice */
+    if (is_stream) {
+        for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+            if (audio->voices[i].handle != 0 && audio->voices[i].stream == cmd->source) {
+                audio->voices[i].handle = 0;
+            }
+        }
+    }
+
+    audio_voice_t *voice = find_voice(audio, 0);
+    if (!voice) {
+        SDL_AtomicAdd(&audio->voice_overflows, 1);
+        return;
+    }
+
+    voice->handle = cmd->handle;
+    voice->sound = is_stream ? -1 : cmd->source;
+    voice->stream = is_stream ? cmd->source : -1;
+    voice->position = 0;
+    voice->volume = cmd->volume;
+    voice->pan = cmd->pan;
+    voice->loop = cmd->loop;
+}
+
+static void apply_command(audio_t *audio, const audio_cmd_t *cmd) {
+    audio_voice_t *voice;
+
+    switch (cmd->type) {
+        case AUDIO_CMD_PLAY_SOUND:
+            start_voice(audio, cmd, false);
+            break;
+        case AUDIO_CMD_PLAY_STREAM:
+            start_voice(audio, cmd, true);
+            break;
+        case AUDIO_CMD_STOP:
+            voice = find_voice(audio, cmd->handle);
+            if (voice) {
+                voice->handle = 0;
+            }
+            break;
+        case AUDIO_CMD_STOP_ALL:
+            for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+                audio->voices[i].handle = 0;
+            }
+            break;
+        case AUDIO_CMD_VOLUME:
+            voice = find_voice(audio, cmd->handle);
+            if (voice) {
+                voice->volume = cmd->volume;
+            }
+            break;
+        case AUDIO_CMD_MASTER_VOLUME:
+            audio->master_volume = cmd->volume;
+            break;
+    }
+}
+
+static void drain_commands(audio_t *audio) {
+    int read = SDL_AtomicGet(&audio->cmd_read);
+    int write = SDL_AtomicGet(&audio->cmd_write);
+
+    while (read != write) {
+        apply_command(audio, &audio->commands[read & AUDIO_COMMAND_MASK]);
+        read = position_add(read, 1);
+    }
+    /* Hand the slots back to the game thread */
+    SDL_AtomicSet(&audio->cmd_read, read);
+}
+
+static void voice_gains(const audio_voice_t *voice, float *gain_l, float *gain_r) {
+    float pan = voice->pan < -1.0f ? -1.0f : (voice->pan > 1.0f ? 1.0f : voice->pan);
+    *gain_l = voice->volume * (pan > 0.0f ? 1.0f - pan : 1.0f);
+    *gain_r = voice->volume * (pan < 0.0f ? 1.0f + pan : 1.0f);
+}
+
+/*
+ * Mix a sound voice into the buffer - returns true when it has finished
+ */
+static bool mix_sound_voice(audio_t *audio, audio_voice_t *voice, float *mix, int frames) {
+    const audio_sound_t *sound = &audio->sounds[voice->sound];
+    float gain_l, gain_r;
+    int written = 0;
+
+    voice_gains(voice, &gain_l, &gain_r);
+    while (written < frames) {
+        int remaining = sound->frames - voice->position;
+        if (remaining <= 0) {
+            if (!voice->loop || sound->frames == 0) {
+                return true;
+            }
+            voice->position = 0;
+            continue;
+        }
+
+        int n = remaining < frames - written ? remaining : frames - written;
+        mix_add_stereo(mix + written * AUDIO_CHANNELS,
+                       sound->samples + voice->position * AUDIO_CHANNELS,
+                       n, gain_l, gain_r);
+        voice->position += n;
+        written += n;
+    }
+    return !voice->loop && voice->position >= sound->frames;
+}
+
+/*
+ * Mix a stream voice from its ring buffer - returns true when the track
+ * has ended and the ring is drained
+ */
+static bool mix_stream_voice(audio_t *audio, audio_voice_t *voice, float *mix, int frames) {
+    audio_stream_t *stream = &audio->streams[voice->stream];
+    int read = SDL_AtomicGet(&stream->read_pos);
+    int available = position_diff(SDL_AtomicGet(&stream->write_pos), read);
+    int n = available < frames ? available : frames;
+    float gain_l, gain_r;
+
+    voice_gains(voice, &gain_l, &gain_r);
+
+    /* The readable region may wrap around the end of the ring */
+    int start = read & AUDIO_STREAM_RING_MASK;
+    int first = AUDIO_STREAM_RING_FRAMES - start;
+    if (first > n) {
+        first = n;
+    }
+    mix_add_stereo(mix, stream->ring + start * AUDIO_CHANNELS, first, gain_l, gain_r);
+    mix_add_stereo(mix + first * AUDIO_CHANNELS, stream->ring, n - first, gain_l, gain_r);
+
+    read = position_add(read, n);
+    SDL_AtomicSet(&stream->read_pos, read);
+
+    if (n < frames) {
+        /* The producer writes all data before raising finished */
+        if (SDL_AtomicGet(&stream->finished) &&
+            SDL_AtomicGet(&stream->write_pos) == read) {
+            return true;
+        }
+        SDL_AtomicAdd(&audio->underruns, frames - n);
+    }
+    return false;
+}
+
+static void audio_callback(void *userdata, Uint8 *stream, int len) {
+    audio_t *audio = userdata;
+    Sint16 *out = (Sint16 *)(void *)stream;
+    int total = len / (int)(sizeof(Sint16) * AUDIO_CHANNELS);
+    int active = 0;
+
+    drain_commands(audio);
+
+    /* SDL normally asks for exactly one device buffer; loop in case it doesn't */
+    while (total > 0) {
+        int frames = total < audio->spec.samples ? total : audio->spec.samples;
+        float *mix = audio->mix_buffer;
+
+        memset(mix, 0, sizeof(float) * (size_t)(frames * AUDIO_CHANNELS));
+        active = 0;
+
+        for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+            audio_voice_t *voice = &audio->voices[i];
+            if (voice->handle == 0) {
+                continue;
+            }
+
+            bool done = voice->stream >= 0
+                ? mix_stream_voice(audio, voice, mix, frames)
+                : mix_sound_voice(audio, voice, mix, frames);
+            if (done) {
+                voice->handle = 0;
+            } else {
+                active++;
+            }
+        }
+
+        mix_to_s16(out, mix, frames * AUDIO_CHANNELS, audio->master_volume);
+        out += frames * AUDIO_CHANNELS;
+        total -= frames;
+    }
+
+    SDL_AtomicSet(&audio->active_voices, active);
+}
+
+/* ============================================================================
+ * STREAMING (GAME THREAD)
+ * ============================================================================ */
+
+/*
+ * Walk the RIFF chunks of a WAV file up to the PCM data
+ * Only 16-bit PCM at the mixer rate is streamed, so no resampling is needed.
+ */
+static bool stream_parse_wav(audio_stream_t *stream, const char *path) {
+    SDL_RWops *rw = stream->file;
+    char id[4];
+    int format = 0, channels = 0, rate = 0, bits = 0;
+
+    if (SDL_RWread(rw, id, 1, 4) != 4 || memcmp(id, "RIFF", 4) != 0) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Stream %s is not a RIFF file", path);
+        return false;
+    }
+    SDL_ReadLE32(rw);
+    if (SDL_RWread(rw, id, 1, 4) != 4 || memcmp(id, "WAVE", 4) != 0) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Stream %s is not a WAVE file", path);
+        return false;
+    }
+
+    for (;;) {
+        if (SDL_RWread(rw, id, 1, 4) != 4) {
+            LOG_ERROR(LOG_CAT_AUDIO, "Stream %s has no data chunk", path);
+            return false;
+        }
+        Uint32 size = SDL_ReadLE32(rw);
+
+        if (memcmp(id, "fmt ", 4) == 0) {
+            if (size < 16) {
+                LOG_ERROR(LOG_CAT_AUDIO, "Stream %s has a truncated fmt chunk (%u bytes)",
+                          path, size);
+                return false;
+            }
+            format = SDL_ReadLE16(rw);
+            channels = SDL_ReadLE16(rw);
+            rate = (int)SDL_ReadLE32(rw);
+            SDL_ReadLE32(rw);  /* Byte rate */
+            SDL_ReadLE16(rw);  /* Block align */
+            bits = SDL_ReadLE16(rw);
+            SDL_RWseek(rw, (Sint64)(size - 16) + (size & 1), RW_SEEK_CUR);
+        } else if (memcmp(id, "data", 4) == 0) {
+            stream->data_start = SDL_RWtell(rw);
+            stream->data_size = size;
+            break;
+        } else {
+            /* Chunks are padded to an even size */
+            SDL_RWseek(rw, (Sint64)size + (size & 1), RW_SEEK_CUR);
+        }
+    }
+
+    if (format != 1 || bits != 16 || (channels != 1 && channels != 2) ||
+        rate != AUDIO_FREQUENCY) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Stream %s must be 16-bit PCM mono/stereo at %d Hz "
+                  "(got format %d, %d-bit, %d ch, %d Hz)",
+                  path, AUDIO_FREQUENCY, format, bits, channels, rate);
+        return false;
+    }
+
+    stream->channels = channels;
+    return true;
+}
+
+static void stream_rewind(audio_stream_t *stream) {
+    SDL_RWseek(stream->file, stream->data_start, RW_SEEK_SET);
+    stream->data_read = 0;
+}
+
+/*
+ * Read up to frames frames of PCM into the ring at dst
+ * Returns the number of frames actually read (0 at end of data).
+ */
+static int stream_read(audio_stream_t *stream, float *dst, int frames) {
+    int frame_bytes = stream->channels * (int)sizeof(Sint16);
+    Sint64 remaining = (stream->data_size - stream->data_read) / frame_bytes;
+
+    if (frames > remaining) {
+        frames = (int)remaining;
+    }
+    if (frames <= 0) {
+        return 0;
+    }
+
+    size_t got = SDL_RWread(stream->file, stream->pcm, (size_t)frame_bytes, (size_t)frames);
+    stream->data_read += (Sint64)got * frame_bytes;
+
+    for (size_t i = 0; i < got; i++) {
+        float left = (Sint16)SDL_SwapLE16((Uint16)stream->pcm[i * stream->channels]) / 32768.0f;
+        float right = stream->channels == 2
+            ? (Sint16)SDL_SwapLE16((Uint16)stream->pcm[i * 2 + 1]) / 32768.0f
+            : left;
+        dst[i * 2] = left;
+        dst[i * 2 + 1] = right;
+    }
+    return (int)got;
+}
+
+static void stream_refill(audio_stream_t *stream) {
+    while (!SDL_AtomicGet(&stream->finished)) {
+        int write = SDL_AtomicGet(&stream->write_pos);
+        int used = position_diff(write, SDL_AtomicGet(&stream->read_pos));
+        if (AUDIO_STREAM_RING_FRAMES - used < AUDIO_STREAM_CHUNK_FRAMES) {
+            break;
+        }
+
+        /* Fill one chunk, split at the end of the ring */
+        int start = write & AUDIO_STREAM_RING_MASK;
+        int wanted = AUDIO_STREAM_RING_FRAMES - start;
+        if (wanted > AUDIO_STREAM_CHUNK_FRAMES) {
+            wanted = AUDIO_STREAM_CHUNK_FRAMES;
+        }
+
+        int got = stream_read(stream, stream->ring + start * AUDIO_CHANNELS, wanted);
+        if (got > 0) {
+            SDL_AtomicSet(&stream->write_pos, position_add(write, got));
+        }
+
+        if (got < wanted) {
+            int frame_bytes = stream->channels * (int)sizeof(Sint16);
+            bool at_end = stream->data_size - stream->data_read < frame_bytes;
+            if (stream->loop && at_end && stream->data_size >= frame_bytes) {
+                stream_rewind(stream);
+            } else {
+                /* End of a one-shot track, or a read error */
+                SDL_AtomicSet(&stream->finished, 1);
+            }
+        }
+    }
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ============================================================================ */
+
+bool audio_init(audio_t *audio) {
+    audio->enabled = false;
+    audio->device = 0;
+    audio->sound_count = 0;
+    audio->stream_count = 0;
+    audio->next_handle = 0;
+    audio->master_volume = AUDIO_MASTER_VOLUME;
+    audio->mix_buffer = NULL;
+    audio->commands_dropped = 0;
+    SDL_AtomicSet(&audio->cmd_write, 0);
+    SDL_AtomicSet(&audio->cmd_read, 0);
+    SDL_AtomicSet(&audio->active_voices, 0);
+    SDL_AtomicSet(&audio->underruns, 0);
+    SDL_AtomicSet(&audio->voice_overflows, 0);
+    for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
+        audio->voices[i].handle = 0;
+    }
+
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        LOG_WARN(LOG_CAT_AUDIO, "Audio disabled - SDL audio init failed: %s", SDL_GetError());
+        return false;
+    }
+
+    SDL_AudioSpec want;
+    SDL_zero(want);
+    want.freq = AUDIO_FREQUENCY;
+    want.format = AUDIO_S16SYS;
+    want.channels = AUDIO_CHANNELS;
+    want.samples = AUDIO_BUFFER_FRAMES;
+    want.callback = audio_callback;
+    want.userdata = audio;
+
+    /* No allowed changes: SDL converts if the hardware differs, so the
+     * callback always sees exactly this format */
+    audio->device = SDL_OpenAudioDevice(NULL, 0, &want, &audio->spec, 0);
+    if (audio->device == 0) {
+        LOG_WARN(LOG_CAT_AUDIO, "Audio disabled - could not open device: %s", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+
+    audio->mix_buffer = ENGINE_MALLOC(sizeof(float) * (size_t)(audio->spec.samples * AUDIO_CHANNELS));
+    if (!audio->mix_buffer) {
+        LOG_WARN(LOG_CAT_AUDIO, "Audio disabled - failed to allocate mix buffer");
+        SDL_CloseAudioDevice(audio->device);
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        audio->device = 0;
+        return false;
+    }
+
+    audio->enabled = true;
+    SDL_PauseAudioDevice(audio->device, 0);
+
+    LOG_INFO(LOG_CAT_AUDIO, "Audio: %s driver, %d Hz, %d frame buffer",
+             SDL_GetCurrentAudioDriver(), audio->spec.freq, audio->spec.samples);
+    return true;
+}
+
+void audio_shutdown(audio_t *audio) {
+    if (!audio->enabled) {
+        return;
+    }
+
+    /* Closing the device waits for a running callback to return */
+    SDL_CloseAudioDevice(audio->device);
+    audio->device = 0;
+    audio->enabled = false;
+
+    for (int i = 0; i < audio->sound_count; i++) {
+        ENGINE_FREE(audio->sounds[i].samples);
+        audio->sounds[i].samples = NULL;
+    }
+    for (int i = 0; i < audio->stream_count; i++) {
+        SDL_RWclose(audio->streams[i].file);
+        ENGINE_FREE(audio->streams[i].ring);
+        ENGINE_FREE(audio->streams[i].pcm);
+    }
+    audio->sound_count = 0;
+    audio->stream_count = 0;
+
+    ENGINE_FREE(audio->mix_buffer);
+    audio->mix_buffer = NULL;
+
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+int audio_load_sound(audio_t *audio, const char *path) {
+    if (!audio->enabled) {
+        return -1;
+    }
+    if (audio->sound_count >= AUDIO_MAX_SOUNDS) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Sound table full, cannot load %s", path);
+        return -1;
+    }
+
+    SDL_AudioSpec spec;
+    Uint8 *wav = NULL;
+    Uint32 wav_len = 0;
+    if (!SDL_LoadWAV(path, &spec, &wav, &wav_len)) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Failed to load sound %s: %s", path, SDL_GetError());
+        return -1;
+    }
+
+    /* Convert once at load so the mixer only ever sees stereo float */
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq,
+                          AUDIO_F32SYS, AUDIO_CHANNELS, AUDIO_FREQUENCY) < 0) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Cannot convert sound %s: %s", path, SDL_GetError());
+        SDL_FreeWAV(wav);
+        return -1;
+    }
+
+    cvt.len = (int)wav_len;
+    cvt.buf = ENGINE_MALLOC((size_t)wav_len * (size_t)cvt.len_mult);
+    if (!cvt.buf) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Failed to allocate sound %s", path);
+        SDL_FreeWAV(wav);
+        return -1;
+    }
+    memcpy(cvt.buf, wav, wav_len);
+    SDL_FreeWAV(wav);
+
+    if (SDL_ConvertAudio(&cvt) < 0) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Cannot convert sound %s: %s", path, SDL_GetError());
+        ENGINE_FREE(cvt.buf);
+        return -1;
+    }
+
+    audio_sound_t *sound = &audio->sounds[audio->sound_count];
+    sound->samples = (float *)(void *)cvt.buf;
+    sound->frames = cvt.len_cvt / (int)(sizeof(float) * AUDIO_CHANNELS);
+    return audio->sound_count++;
+}
+
+int audio_create_tone(audio_t *audio, float frequency, float duration) {
+    if (!audio->enabled) {
+        return -1;
+    }
+    if (audio->sound_count >= AUDIO_MAX_SOUNDS) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Sound table full, cannot create tone");
+        return -1;
+    }
+
+    int frames = (int)(duration * AUDIO_FREQUENCY);
+    float *samples = ENGINE_MALLOC(sizeof(float) * (size_t)(frames * AUDIO_CHANNELS));
+    if (!samples) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Failed to allocate tone");
+        return -1;
+    }
+
+    for (int i = 0; i < frames; i++) {
+        float t = (float)i / AUDIO_FREQUENCY;
+        /* 2 ms attack avoids a click; exponential decay over the duration */
+        float attack = t < 0.002f ? t / 0.002f : 1.0f;
+        float env = attack * expf(-5.0f * t / duration);
+        float v = sinf(2.0f * (float)M_PI * frequency * t) * env;
+        samples[i * 2] = v;
+        samples[i * 2 + 1] = v;
+    }
+
+    audio_sound_t *sound = &audio->sounds[audio->sound_count];
+    sound->samples = samples;
+    sound->frames = frames;
+    return audio->sound_count++;
+}
+
+int audio_open_stream(audio_t *audio, const char *path, bool loop) {
+    if (!audio->enabled) {
+        return -1;
+    }
+    if (audio->stream_count >= AUDIO_MAX_STREAMS) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Stream table full, cannot open %s", path);
+        return -1;
+    }
+
+    audio_stream_t *stream = &audio->streams[audio->stream_count];
+    stream->file = SDL_RWFromFile(path, "rb");
+    if (!stream->file) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Failed to open stream %s: %s", path, SDL_GetError());
+        return -1;
+    }
+
+    if (!stream_parse_wav(stream, path)) {
+        SDL_RWclose(stream->file);
+        return -1;
+    }
+
+    stream->ring = ENGINE_MALLOC(sizeof(float) * AUDIO_STREAM_RING_FRAMES * AUDIO_CHANNELS);
+    stream->pcm = ENGINE_MALLOC(sizeof(Sint16) * AUDIO_STREAM_CHUNK_FRAMES * AUDIO_CHANNELS);
+    if (!stream->ring || !stream->pcm) {
+        LOG_ERROR(LOG_CAT_AUDIO, "Failed to allocate stream buffers for %s", path);
+        ENGINE_FREE(stream->ring);
+        ENGINE_FREE(stream->pcm);
+        SDL_RWclose(stream->file);
+        return -1;
+    }
+
+    stream->loop = loop;
+    stream->data_read = 0;
+    SDL_AtomicSet(&stream->write_pos, 0);
+    SDL_AtomicSet(&stream->read_pos, 0);
+    SDL_AtomicSet(&stream->finished, 0);
+
+    /* Prime the ring so playback can start immediately */
+    stream_refill(stream);
+    return audio->stream_count++;
+}
+
+/*
+ * Enqueue a command for the audio thread - never blocks
+ */
+static bool audio_push_command(audio_t *audio, const audio_cmd_t *cmd) {
+    int write = SDL_AtomicGet(&audio->cmd_write);
+    int read = SDL_AtomicGet(&audio->cmd_read);
+
+    if (position_diff(write, read) >= AUDIO_COMMAND_QUEUE_SIZE) {
+        audio->commands_dropped++;
+        return false;
+    }
+
+    audio->commands[write & AUDIO_COMMAND_MASK] = *cmd;
+    /* Publish: the slot is written before the audio thread sees the new index */
+    SDL_AtomicSet(&audio->cmd_write, position_add(write, 1));
+    return true;
+}
+
+static audio_voice_handle_t audio_new_handle(audio_t *audio) {
+    audio->next_handle++;
+    if (audio->next_handle == 0) {
+        audio->next_handle = 1;
+    }
+    return audio->next_handle;
+}
+
+audio_voice_handle_t audio_play(audio_t *audio, int sound, float volume,
+                                float pan, bool loop) {
+    if (!audio->enabled || sound < 0 || sound >= audio->sound_count) {
+        return 0;
+    }
+
+    audio_cmd_t cmd = { AUDIO_CMD_PLAY_SOUND, audio_new_handle(audio), sound, volume, pan, loop };
+    return audio_push_command(audio, &cmd) ? cmd.handle : 0;
+}
+
+audio_voice_handle_t audio_play_stream(audio_t *audio, int stream, float volume) {
+    if (!audio->enabled || stream < 0 || stream >= audio->stream_count) {
+        return 0;
+    }
+
+    /* A one-shot track that played out starts over; otherwise playback
+     * resumes where the ring left off */
+    audio_stream_t *s = &audio->streams[stream];
+    if (SDL_AtomicGet(&s->finished) &&
+        SDL_AtomicGet(&s->write_pos) == SDL_AtomicGet(&s->read_pos)) {
+        stream_rewind(s);
+        SDL_AtomicSet(&s->finished, 0);
+        stream_refill(s);
+    }
+
+    audio_cmd_t cmd = { AUDIO_CMD_PLAY_STREAM, audio_new_handle(audio), stream, volume, 0.0f, false };
+    return audio_push_command(audio, &cmd) ? cmd.handle : 0;
+}
+
+void audio_stop(audio_t *audio, audio_voice_handle_t handle) {
+    if (!audio->enabled || handle == 0) {
+        return;
+    }
+    audio_cmd_t cmd = { AUDIO_CMD_STOP, handle, -1, 0.0f, 0.0f, false };
+    audio_push_command(audio, &cmd);
+}
+
+void audio_stop_all(audio_t *audio) {
+    if (!audio->enabled) {
+        return;
+    }
+    audio_cmd_t cmd = { AUDIO_CMD_STOP_ALL, 0, -1, 0.0f, 0.0f, false };
+    audio_push_command(audio, &cmd);
+}
+
+void audio_set_volume(audio_t *audio, audio_voice_handle_t handle, float volume) {
+    if (!audio->enabled || handle == 0) {
+        return;
+    }
+    audio_cmd_t cmd = { AUDIO_CMD_VOLUME, handle, -1, volume, 0.0f, false };
+    audio_push_command(audio, &cmd);
+}
+
+void audio_set_master_volume(audio_t *audio, float volume) {
+    if (!audio->enabled) {
+        return;
+    }
+    audio_cmd_t cmd = { AUDIO_CMD_MASTER_VOLUME, 0, -1, volume, 0.0f, false };
+    audio_push_command(audio, &cmd);
+}
+
+void audio_update(audio_t *audio) {
+    if (!audio->enabled) {
+        return;
+    }
+    for (int i = 0; i < audio->stream_count; i++) {
+        stream_refill(&audio->streams[i]);
+    }
+}
+
+int audio_active_voices(audio_t *audio) {
+    return SDL_AtomicGet(&audio->active_voices);
+}
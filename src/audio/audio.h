@@ -0,0 +1,195 @@
+/*
+ * Knight Engine 2D - Audio Mixer
+ *
+ * Mixes many voices on SDL's audio callback thread. The game thread never
+ * touches mixer state directly and never takes a lock: play, stop and
+ * volume requests go through a single-producer/single-consumer command
+ * queue that the callback drains at the start of every buffer.
+ *
+ * Sounds are decoded and converted to the mixer format (stereo float at
+ * AUDIO_FREQUENCY) at load time, so mixing is a straight multiply-add,
+ * vectorized with SSE2 or NEON where available.
+ *
+ * Long tracks stream from disk: audio_update (game thread, once per frame)
+ * reads the WAV file in AUDIO_STREAM_CHUNK_FRAMES chunks into a per-stream
+ * ring buffer that the callback consumes.
+ *
+ * Audio is optional. If no device can be opened the module stays disabled
+ * and every call is a no-op. For headless testing use SDL's dummy or disk
+ * driver, e.g. SDL_AUDIODRIVER=disk writes the mixed output to sdlaudio.raw.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "core/config.h"
+
+/* Handle returned by play calls; 0 means "no voice" */
+typedef Uint32 audio_voice_handle_t;
+
+/*
+ * A fully decoded sound, stereo float frames at AUDIO_FREQUENCY
+ */
+typedef struct {
+    float *samples;  /* Interleaved L/R */
+    int frames;
+} audio_sound_t;
+
+/*
+ * A WAV file streamed from disk through a ring buffer
+ * The game thread writes frames, the audio thread reads them.
+ */
+typedef struct {
+    SDL_RWops *file;
+    Sint64 data_start;     /* Offset of the PCM data in the file */
+    Sint64 data_size;      /* Bytes of PCM data */
+    Sint64 data_read;      /* Bytes consumed so far this pass */
+    int channels;          /* 1 or 2 (16-bit PCM only) */
+    bool loop;
+    float *ring;           /* Interleaved L/R, AUDIO_STREAM_RING_FRAMES frames */
+    Sint16 *pcm;           /* Disk read buffer, one chunk */
+    SDL_atomic_t write_pos;  /* Frames produced (game thread) */
+    SDL_atomic_t read_pos;   /* Frames consumed (audio thread) */
+    SDL_atomic_t finished;   /* Producer reached the end (non-looping) */
+} audio_stream_t;
+
+/*
+ * Mixer voice - owned by the audio thread
+ */
+typedef struct {
+    audio_voice_handle_t handle;  /* 0 = free */
+    int sound;        /* Sound index, or -1 when playing a stream */
+    int stream;       /* Stream index, or -1 when playing a sound */
+    int position;     /* Frame position within the sound */
+    float volume;
+    float pan;        /* -1 = left, 0 = center, 1 = right */
+    bool loop;
+} audio_voice_t;
+
+/*
+ * Commands sent from the game thread to the mixer
+ */
+typedef enum {
+    AUDIO_CMD_PLAY_SOUND,
+    AUDIO_CMD_PLAY_STREAM,
+    AUDIO_CMD_STOP,
+    AUDIO_CMD_STOP_ALL,
+    AUDIO_CMD_VOLUME,
+    AUDIO_CMD_MASTER_VOLUME
+} audio_cmd_type_t;
+
+typedef struct {
+    audio_cmd_type_t type;
+    audio_voice_handle_t handle;
+    int source;    /* Sound or stream index */
+    float volume;
+    float pan;
+    bool loop;
+} audio_cmd_t;
+
+/*
+ * Audio system state
+ */
+typedef struct {
+    bool enabled;
+    SDL_AudioDeviceID device;
+    SDL_AudioSpec spec;
+
+    /* Loaded data - written before publishing the index through a command */
+    audio_sound_t sounds[AUDIO_MAX_SOUNDS];
+    int sound_count;
+    audio_stream_t streams[AUDIO_MAX_STREAMS];
+    int stream_count;
+
+    /* Game thread -> audio thread command queue (SPSC) */
+    audio_cmd_t commands[AUDIO_COMMAND_QUEUE_SIZE];
+    SDL_atomic_t cmd_write;
+    SDL_atomic_t cmd_read;
+    audio_voice_handle_t next_handle;  /* Game thread only */
+
+    /* Audio thread only */
+    audio_voice_t voices[AUDIO_MAX_VOICES];
+    float master_volume;
+    float *mix_buffer;  /* Float accumulation buffer, one device buffer long */
+
+    /* Statistics - written by the audio thread */
+    SDL_atomic_t active_voices;
+    SDL_atomic_t underruns;        /* Stream frames the ring could not supply */
+    SDL_atomic_t voice_overflows;  /* Plays dropped because every voice was busy */
+    int commands_dropped;          /* Game thread: queue was full */
+} audio_t;
+
+/*
+ * Open the audio device and start the mixer
+ * Returns false (leaving audio disabled) if no device is available;
+ * the engine keeps running without sound.
+ */
+bool audio_init(audio_t *audio);
+
+/*
+ * Stop the mixer, close the device and free all sounds and streams
+ */
+void audio_shutdown(audio_t *audio);
+
+/*
+ * Load a WAV file fully into memory (converted to the mixer format)
+ * Returns a sound index, or -1 on failure.
+ */
+int audio_load_sound(audio_t *audio, const char *path);
+
+/*
+ * Synthesize a short decaying sine blip
+ * Returns a sound index, or -1 on failure.
+ */
+int audio_create_tone(audio_t *audio, float frequency, float duration);
+
+/*
+ * Open a 16-bit PCM WAV file at AUDIO_FREQUENCY for streaming
+ * Returns a stream index, or -1 on failure.
+ */
+int audio_open_stream(audio_t *audio, const char *path, bool loop);
+
+/*
+ * Start playing a loaded sound
+ * Returns a voice handle for later stop/volume calls (0 if disabled).
+ */
+audio_voice_handle_t audio_play(audio_t *audio, int sound, float volume,
+                                float pan, bool loop);
+
+/*
+ * Start playing an open stream (one voice per stream at a time)
+ * Stopping a stream voice pauses the track; playing it again resumes it.
+ * A one-shot track that has played out starts over.
+ */
+audio_voice_handle_t audio_play_stream(audio_t *audio, int stream, float volume);
+
+/*
+ * Stop a voice (no-op if it already finished)
+ */
+void audio_stop(audio_t *audio, audio_voice_handle_t handle);
+
+/*
+ * Stop every voice
+ */
+void audio_stop_all(audio_t *audio);
+
+/*
+ * Change the volume of a playing voice
+ */
+void audio_set_volume(audio_t *audio, audio_voice_handle_t handle, float volume);
+
+/*
+ * Change the master volume (0..1)
+ */
+void audio_set_master_volume(audio_t *audio, float volume);
+
+/*
+ * Refill stream ring buffers from disk - call once per frame
+ */
+void audio_update(audio_t *audio);
+
+/*
+ * Number of voices the mixer is currently playing
+ */
+int audio_active_voices(audio_t *audio);
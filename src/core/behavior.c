@@ -0,0 +1,337 @@
+/*
+ * Knight Engine 2D - Coroutine Behaviors Implementation
+ */
+
+#include "core/behavior.h"
+#include "util/alloc.h"
+#include "util/log.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * Timer heap (min-heap on wake_time, positions stored in the state blocks)
+ * ============================================================================ */
+
+static void heap_swap(behavior_scheduler_t *sched, int a, int b) {
+    int ea = sched->heap[a];
+    int eb = sched->heap[b];
+    sched->heap[a] = eb;
+    sched->heap[b] = ea;
+    sched->states[eb].heap_pos = a;
+    sched->states[ea].heap_pos = b;
+}
+
+static double heap_key(const behavior_scheduler_t *sched, int pos) {
+    return sched->states[sched->heap[pos]].wake_time;
+}
+
+static void heap_sift_up(behavior_scheduler_t *sched, int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (heap_key(sched, parent) <= heap_key(sched, pos)) {
+            break;
+        }
+        heap_swap(sched, pos, parent);
+        pos = parent;
+    }
+}
+
+static void heap_sift_down(behavior_scheduler_t *sched, int pos) {
+    for (;;) {
+        int left = pos * 2 + 1;
+        int right = left + 1;
+        int smallest = pos;
+
+        if (left < sched->heap_count && heap_key(sched, left) < heap_key(sched, smallest)) {
+            smallest = left;
+        }
+        if (right < sched->heap_count && heap_key(sched, right) < heap_key(sched, smallest)) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        heap_swap(sched, pos, smallest);
+        pos = smallest;
+    }
+}
+
+static void heap_push(behavior_scheduler_t *sched, int entity) {
+    int pos = sched->heap_count++;
+    sched->heap[pos] = entity;
+    sched->states[entity].heap_pos = pos;
+    heap_sift_up(sched, pos);
+}
+
+static void heap_remove(behavior_scheduler_t *sched, int pos) {
+    int last = --sched->heap_count;
+    if (pos != last) {
+        heap_swap(sched, pos, last);
+        heap_sift_down(sched, pos);
+        heap_sift_up(sched, pos);
+    }
+}
+
+/* ============================================================================
+ * Signal wait lists (intrusive, doubly linked through the state blocks)
+ * ============================================================================ */
+
+static void signal_link(behavior_scheduler_t *sched, int entity) {
+    behavior_state_t *co = &sched->states[entity];
+    int head = sched->signal_heads[co->signal];
+
+    co->link.prev = -1;
+    co->link.next = head;
+    if (head >= 0) {
+        sched->states[head].link.prev = entity;
+    }
+    sched->signal_heads[co->signal] = entity;
+}
+
+static void signal_unlink(behavior_scheduler_t *sched, int entity) {
+    behavior_state_t *co = &sched->states[entity];
+
+    if (co->link.prev >= 0) {
+        sched->states[co->link.prev].link.next = co->link.next;
+    } else {
+        sched->signal_heads[co->signal] = co->link.next;
+    }
+    if (co->link.next >= 0) {
+        sched->states[co->link.next].link.prev = co->link.prev;
+    }
+}
+
+/* Take an entity out of whatever it is waiting on */
+static void detach(behavior_scheduler_t *sched, int entity) {
+    behavior_state_t *co = &sched->states[entity];
+
+    switch (co->status) {
+        case BEHAVIOR_WAIT_TIME:
+            heap_remove(sched, co->heap_pos);
+            break;
+        case BEHAVIOR_WAIT_SIGNAL:
+            signal_unlink(sched, entity);
+            break;
+        case BEHAVIOR_READY:
+            /* Stays in the ready list (queued) and is skipped unless restarted */
+            break;
+        case BEHAVIOR_IDLE:
+            break;
+    }
+}
+
+static void make_ready(behavior_scheduler_t *sched, int entity) {
+    behavior_state_t *co = &sched->states[entity];
+    co->status = BEHAVIOR_READY;
+    if (!co->queued) {
+        co->queued = 1;
+        sched->ready[sched->ready_count++] = entity;
+    }
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+bool behavior_scheduler_init(behavior_scheduler_t *sched, int capacity) {
+    sched->states = ENGINE_CALLOC((size_t)capacity, sizeof(behavior_state_t));
+    sched->heap = ENGINE_MALLOC(sizeof(int) * (size_t)capacity);
+    sched->ready = ENGINE_MALLOC(sizeof(int) * (size_t)capacity);
+    sched->running = ENGINE_MALLOC(sizeof(int) * (size_t)capacity);
+    sched->capacity = capacity;
+    sched->heap_count = 0;
+    sched->ready_count = 0;
+    sched->active = 0;
+    sched->resumed_last_run = 0;
+    for (int i = 0; i < BEHAVIOR_MAX_SIGNALS; i++) {
+        sched->signal_heads[i] = -1;
+    }
+    for (int i = 0; i < BEHAVIOR_MAX_TYPES; i++) {
+        sched->table[i] = NULL;
+    }
+
+    if (!sched->states || !sched->heap || !sched->ready || !sched->running) {
+        LOG_ERROR(LOG_CAT_GAME, "Failed to allocate behavior scheduler (%d entities)", capacity);
+        behavior_scheduler_cleanup(sched);
+        return false;
+    }
+    return true;
+}
+
+bool behavior_scheduler_reserve(behavior_scheduler_t *sched, int capacity) {
+    if (capacity <= sched->capacity) {
+        return true;
+    }
+
+    /* Swapped in one at a time - a larger array is still valid if a later
+     * one fails, and the old capacity keeps working */
+    behavior_state_t *states = ENGINE_REALLOC(sched->states,
+                                              sizeof(behavior_state_t) * (size_t)capacity);
+    if (states) {
+        memset(states + sched->capacity, 0,
+               sizeof(behavior_state_t) * (size_t)(capacity - sched->capacity));
+        sched->states = states;
+    }
+    int *heap = ENGINE_REALLOC(sched->heap, sizeof(int) * (size_t)capacity);
+    if (heap) {
+        sched->heap = heap;
+    }
+    int *ready = ENGINE_REALLOC(sched->ready, sizeof(int) * (size_t)capacity);
+    if (ready) {
+        sched->ready = ready;
+    }
+    int *running = ENGINE_REALLOC(sched->running, sizeof(int) * (size_t)capacity);
+    if (running) {
+        sched->running = running;
+    }
+
+    if (!states || !heap || !ready || !running) {
+        LOG_ERROR(LOG_CAT_GAME, "Failed to grow behavior scheduler to %d entities", capacity);
+        return false;
+    }
+    sched->capacity = capacity;
+    return true;
+}
+
+void behavior_scheduler_cleanup(behavior_scheduler_t *sched) {
+    ENGINE_FREE(sched->states);
+    ENGINE_FREE(sched->heap);
+    ENGINE_FREE(sched->ready);
+    ENGINE_FREE(sched->running);
+    sched->states = NULL;
+    sched->heap = NULL;
+    sched->ready = NULL;
+    sched->running = NULL;
+    sched->capacity = 0;
+    sched->heap_count = 0;
+    sched->ready_count = 0;
+    sched->active = 0;
+}
+
+void behavior_register(behavior_scheduler_t *sched, int id, behavior_fn fn) {
+    if (id < 0 || id >= BEHAVIOR_MAX_TYPES) {
+        LOG_ERROR(LOG_CAT_GAME, "Behavior id %d out of range", id);
+        return;
+    }
+    sched->table[id] = fn;
+}
+
+void behavior_start(behavior_scheduler_t *sched, int entity, int id) {
+    if (entity < 0 || entity >= sched->capacity ||
+        id < 0 || id >= BEHAVIOR_MAX_TYPES || !sched->table[id]) {
+        return;
+    }
+
+    behavior_state_t *co = &sched->states[entity];
+    if (co->status == BEHAVIOR_IDLE) {
+        sched->active++;
+    } else {
+        detach(sched, entity);
+    }
+
+    co->line = 0;
+    co->behavior = (Uint8)id;
+    for (int i = 0; i < BEHAVIOR_LOCALS; i++) {
+        co->locals[i] = 0.0f;
+    }
+    make_ready(sched, entity);
+}
+
+void behavior_stop(behavior_scheduler_t *sched, int entity) {
+    if (entity < 0 || entity >= sched->capacity) {
+        return;
+    }
+
+    behavior_state_t *co = &sched->states[entity];
+    if (co->status == BEHAVIOR_IDLE) {
+        return;
+    }
+    detach(sched, entity);
+    co->status = BEHAVIOR_IDLE;
+    sched->active--;
+}
+
+void behavior_signal(behavior_scheduler_t *sched, int signal) {
+    if (signal < 0 || signal >= BEHAVIOR_MAX_SIGNALS) {
+        return;
+    }
+
+    int entity = sched->signal_heads[signal];
+    sched->signal_heads[signal] = -1;
+    while (entity >= 0) {
+        int next = sched->states[entity].link.next;
+        make_ready(sched, entity);
+        entity = next;
+    }
+}
+
+void behavior_scheduler_run(behavior_scheduler_t *sched, void *user, double now) {
+    /* Move expired timers onto the ready list first, so anything that waits
+     * again during this run lands back in the heap for a later run */
+    while (sched->heap_count > 0 && heap_key(sched, 0) <= now) {
+        int entity = sched->heap[0];
+        heap_remove(sched, 0);
+        make_ready(sched, entity);
+    }
+
+    /* Swap lists: entities made ready while this run executes (signals,
+     * restarts) queue up for the next run instead */
+    int *running = sched->ready;
+    int count = sched->ready_count;
+    sched->ready = sched->running;
+    sched->running = running;
+    sched->ready_count = 0;
+    sched->resumed_last_run = 0;
+
+    for (int i = 0; i < count; i++) {
+        int entity = running[i];
+        behavior_state_t *co = &sched->states[entity];
+        co->queued = 0;
+
+        /* Stopped after being queued */
+        if (co->status != BEHAVIOR_READY) {
+            continue;
+        }
+
+        behavior_status_t status = sched->table[co->behavior](co, entity, user, now);
+        sched->resumed_last_run++;
+
+        /* Another entity's behavior may not touch this one, but be safe if it
+         * was stopped or restarted during the call */
+        if (co->status != BEHAVIOR_READY || co->queued) {
+            continue;
+        }
+
+        switch (status) {
+            case BEHAVIOR_WAIT_TIME:
+                co->status = BEHAVIOR_WAIT_TIME;
+                heap_push(sched, entity);
+                break;
+            case BEHAVIOR_WAIT_SIGNAL:
+                if (co->signal >= BEHAVIOR_MAX_SIGNALS) {
+                    LOG_ERROR(LOG_CAT_GAME, "Behavior %d waits on invalid signal %d - stopped",
+                              co->behavior, co->signal);
+                    co->status = BEHAVIOR_IDLE;
+                    sched->active--;
+                    break;
+                }
+                co->status = BEHAVIOR_WAIT_SIGNAL;
+                signal_link(sched, entity);
+                break;
+            case BEHAVIOR_READY:
+                /* Treated as a yield */
+                co->wake_time = now;
+                co->status = BEHAVIOR_WAIT_TIME;
+                heap_push(sched, entity);
+                break;
+            case BEHAVIOR_IDLE:
+                co->status = BEHAVIOR_IDLE;
+                sched->active--;
+                break;
+        }
+    }
+}
+
+int behavior_active_count(const behavior_scheduler_t *sched) {
+    return sched->active;
+}
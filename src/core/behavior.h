@@ -0,0 +1,169 @@
+/*
+ * Knight Engine 2D - Coroutine Behaviors
+ *
+ * Stackless, switch-based coroutines (protothread style) for scripting
+ * many entities. A behavior is a plain function whose position is saved
+ * in a small per-entity state block; waiting returns to the scheduler
+ * and the next resume jumps back to the line after the wait.
+ *
+ *   static behavior_status_t blink(behavior_state_t *co, int entity,
+ *                                  void *user, double now) {
+ *       BEHAVIOR_BEGIN(co);
+ *       for (;;) {
+ *           ...turn on...
+ *           BEHAVIOR_WAIT(co, now, 0.5);
+ *           ...turn off...
+ *           BEHAVIOR_WAIT_SIGNAL(co, SIGNAL_BLINK);
+ *       }
+ *       BEHAVIOR_END(co);
+ *   }
+ *
+ * Rules: local variables do not survive a wait - keep state in co->locals.
+ * Waits cannot be placed inside a nested switch statement, and only one
+ * wait may appear per source line (the line number is the resume label).
+ * A behavior ends by reaching BEHAVIOR_END; it must not start or stop its
+ * own entity.
+ *
+ * The scheduler only touches entities that are due: timed waits sit in a
+ * min-heap keyed by wake time, signal waits in per-signal lists. An idle
+ * entity costs nothing per step.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#define BEHAVIOR_MAX_TYPES   16
+#define BEHAVIOR_MAX_SIGNALS 16
+#define BEHAVIOR_LOCALS      4
+
+/*
+ * What a behavior is waiting for after it returns
+ */
+typedef enum {
+    BEHAVIOR_IDLE = 0,     /* Not running (finished or never started) */
+    BEHAVIOR_WAIT_TIME,    /* Sleeping until wake_time */
+    BEHAVIOR_WAIT_SIGNAL,  /* Parked until its signal is raised */
+    BEHAVIOR_READY         /* Queued to resume on the next run */
+} behavior_status_t;
+
+/*
+ * Per-entity coroutine state (40 bytes)
+ */
+typedef struct {
+    Uint16 line;      /* Resume point (__LINE__ of the last wait), 0 = start */
+    Uint8 behavior;   /* Index into the scheduler's behavior table */
+    Uint8 status;     /* behavior_status_t */
+    Uint16 signal;    /* Signal awaited while in BEHAVIOR_WAIT_SIGNAL */
+    Uint8 queued;     /* Present in the scheduler's ready list */
+    double wake_time; /* Simulation time a timed wait expires */
+    union {
+        int heap_pos;             /* Position in the timer heap */
+        struct {
+            int prev, next;       /* Neighbours in the signal wait list */
+        } link;
+    };
+    float locals[BEHAVIOR_LOCALS];  /* Behavior-private state across waits */
+} behavior_state_t;
+
+/*
+ * Behavior function - resumes the coroutine, returns what it now waits on
+ * entity: slot index the behavior runs for
+ * user:   pointer passed to behavior_scheduler_run (e.g. game state)
+ * now:    current simulation time in seconds
+ */
+typedef behavior_status_t (*behavior_fn)(behavior_state_t *co, int entity,
+                                         void *user, double now);
+
+/* Coroutine macros - see the example at the top of this file */
+#define BEHAVIOR_BEGIN(co) switch ((co)->line) { case 0:
+
+#define BEHAVIOR_END(co) } (co)->line = 0; return BEHAVIOR_IDLE
+
+#define BEHAVIOR_WAIT(co, now, seconds)                 \
+    do {                                                \
+        (co)->wake_time = (now) + (seconds);            \
+        (co)->line = __LINE__;                          \
+        return BEHAVIOR_WAIT_TIME;                      \
+        case __LINE__:;                                 \
+    } while (0)
+
+#define BEHAVIOR_WAIT_SIGNAL(co, sig)                   \
+    do {                                                \
+        (co)->signal = (Uint16)(sig);                   \
+        (co)->line = __LINE__;                          \
+        return BEHAVIOR_WAIT_SIGNAL;                    \
+        case __LINE__:;                                 \
+    } while (0)
+
+/* Give up the rest of this step; resume on the next run */
+#define BEHAVIOR_YIELD(co, now) BEHAVIOR_WAIT(co, now, 0.0)
+
+/*
+ * Scheduler - one state block per entity slot
+ */
+typedef struct {
+    behavior_state_t *states;  /* capacity entries, indexed by entity */
+    int capacity;
+    int *heap;                 /* Min-heap of entities by wake_time */
+    int heap_count;
+    int *ready;                /* Entities to resume on the next run */
+    int ready_count;
+    int *running;              /* Ready list being drained by the current run */
+    int signal_heads[BEHAVIOR_MAX_SIGNALS];  /* First waiter per signal, -1 = none */
+    behavior_fn table[BEHAVIOR_MAX_TYPES];
+    int active;                /* Entities with a running behavior */
+    int resumed_last_run;      /* Resumes performed by the last run */
+} behavior_scheduler_t;
+
+/*
+ * Allocate a scheduler for entity slots 0..capacity-1
+ * Returns true on success, false on allocation failure.
+ */
+bool behavior_scheduler_init(behavior_scheduler_t *sched, int capacity);
+
+/*
+ * Grow to at least capacity entity slots (never shrinks), keeping every
+ * running behavior. Not from inside behavior_scheduler_run.
+ * Returns false on allocation failure, leaving the old capacity usable.
+ */
+bool behavior_scheduler_reserve(behavior_scheduler_t *sched, int capacity);
+
+/*
+ * Free scheduler storage
+ */
+void behavior_scheduler_cleanup(behavior_scheduler_t *sched);
+
+/*
+ * Register a behavior function under an id (0..BEHAVIOR_MAX_TYPES-1)
+ */
+void behavior_register(behavior_scheduler_t *sched, int id, behavior_fn fn);
+
+/*
+ * Start (or restart) a behavior on an entity - it first runs on the next
+ * behavior_scheduler_run
+ */
+void behavior_start(behavior_scheduler_t *sched, int entity, int id);
+
+/*
+ * Stop an entity's behavior and remove it from any wait
+ */
+void behavior_stop(behavior_scheduler_t *sched, int entity);
+
+/*
+ * Wake every entity waiting on a signal (they resume on the next run)
+ */
+void behavior_signal(behavior_scheduler_t *sched, int signal);
+
+/*
+ * Resume every entity whose timer has expired or whose signal was raised
+ * Entities that wait again during this call resume no earlier than the
+ * next run, so a zero-length wait is a yield rather than a busy loop.
+ */
+void behavior_scheduler_run(behavior_scheduler_t *sched, void *user, double now);
+
+/*
+ * Number of entities with a running behavior
+ */
+int behavior_active_count(const behavior_scheduler_t *sched);
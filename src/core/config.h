@@ -27,9 +27,40 @@
 #define PLAYER_START_X ((WINDOW_WIDTH - SPRITE_WIDTH) / 2.0f)
 #define PLAYER_START_Y ((WINDOW_HEIGHT - SPRITE_HEIGHT) / 2.0f)
 
-/* Maximum sprites in scene */
+/* Sprite slots allocated at startup - the stress test grows the array past this */
 #define SPRITE_MAX_COUNT 256
 
+/* ============================================================================
+ * RENDER SETTINGS
+ * ============================================================================ */
+
+/* Render commands per frame (sprites + debug shapes; rotated bounds use 4),
+ * plus one per stress test sprite */
+#define RENDER_CMD_MAX_COUNT (SPRITE_MAX_COUNT * 8)
+
+/* Solid-color quads drawn per geometry call at most */
+#define RENDER_SOLID_BATCH_QUADS 1024
+
+/* Sprites outside the view are not recorded (r_cull default) */
+#define RENDER_CULL_ENABLED 1
+
+/* Rotation cache - opted-in textures pre-rendered at fixed angles so the
+ * software renderer copies instead of resampling (renderer_cache_rotations) */
+#define RENDER_ROT_CACHE_FRAMES       64                 /* Angles per texture (5.6 degree steps) */
+#define RENDER_ROT_CACHE_MAX_TEXTURES 16
+#define RENDER_ROT_CACHE_MAX_BYTES    (8u * 1024 * 1024) /* All pages together */
+
+/* Dynamic resolution - scene renders offscreen at a scaled size, then upscales */
+#define DYNRES_ENABLED         1      /* r_dynres default; 0 = always render at full size */
+#define DYNRES_MIN_SCALE       0.5f   /* Lowest fraction of WINDOW_WIDTH x WINDOW_HEIGHT */
+#define DYNRES_MAX_SCALE       1.0f
+#define DYNRES_TARGET_MS       (1000.0f / TARGET_FPS * 0.85f)  /* Leave 15% slack */
+#define DYNRES_HEADROOM        0.7f   /* Grow only when below 70% of the target */
+#define DYNRES_SMOOTHING       0.1f   /* EMA weight of the newest frame time */
+#define DYNRES_MAX_STEP        0.15f  /* Largest single shrink (fraction of scale) */
+#define DYNRES_QUANTUM         32.0f  /* Scale snaps to multiples of 1/32 */
+#define DYNRES_COOLDOWN_FRAMES 15     /* Frames to wait after each change */
+
 /* ============================================================================
  * FRAME RATE & TIMING
  * ============================================================================ */
@@ -37,12 +68,64 @@
 #define TARGET_FPS        60
 #define FIXED_TIMESTEP    (1.0f / TARGET_FPS)  /* Fixed update rate for physics */
 #define MAX_DELTA_TIME    0.1f   /* Cap delta time to prevent large jumps */
-#define MAX_ACCUMULATOR   0.25f  /* Prevent spiral of death on slow frames */
+#define MAX_ACCUMULATOR   0.25f  /* Ceiling on deferred simulation time; excess is dropped */
+
+/* Rendering on demand - a frame whose recorded commands match the last
+ * presented frame is not drawn or presented, and the loop sleeps until
+ * the next fixed step or input event instead of spinning (r_on_demand) */
+#define RENDER_ON_DEMAND     1
+#define UNFOCUSED_FPS        20   /* Frame rate cap while the window lacks focus */
+#define BACKGROUND_WAIT_MS   100  /* Event wait per tick while minimized or hidden */
+#define BACKGROUND_SIM_STEPS 1    /* Fixed steps per tick while hidden; the rest is dropped */
 
-/* FPS counter settings */
+/* Batch simulation - renderer-free worlds for testing and bots (core/sim_batch.h) */
+#define SIM_BATCH_MAX_THREADS  64
+#define SIM_BATCH_SPRITE_SIZE  32
+#define SIM_BATCH_SPRITE_SPEED 100.0f  /* Largest sprite speed per axis (px/s) */
+
+/* Frame budget governor - sheds low-priority work when frames run long */
+#define GOVERNOR_BUDGET_MS       (1000.0f / TARGET_FPS)
+#define GOVERNOR_HEADROOM        0.75f  /* Below 75% of budget counts as headroom */
+#define GOVERNOR_ESCALATE_FRAMES 2      /* Over-budget frames before shedding more */
+#define GOVERNOR_RELAX_FRAMES    30     /* Headroom frames before shedding less */
+#define GOVERNOR_MAX_FRAME_SKIP  2      /* Max consecutive frames without rendering */
+
+/* Frame statistics - rolling window behind the FPS display, debug output
+ * and telemetry percentiles (util/frame_stats.h) */
+#define FRAME_STATS_WINDOW 256  /* Frames kept (power of 2) */
+
+/* FPS display settings */
 #define FPS_UPDATE_INTERVAL 500  /* Update FPS display every N milliseconds */
-#define FPS_DISPLAY_ENABLED 1    /* Set to 0 to disable FPS in window title */
-#define FPS_DEBUG_LOG       0    /* Set to 1 to log FPS vs target to console */
+#define FPS_DISPLAY_ENABLED 1    /* fps_display default - FPS in the window title */
+#define FPS_DEBUG_LOG       0    /* fps_log default - log FPS vs target to console */
+
+/* Simulation LOD - entities further outside the view update less often */
+#define SIM_LOD_ENABLED      1       /* sim_lod default */
+#define SIM_LOD_NEAR_MARGIN  128.0f  /* Pixels outside the view still updated every step */
+#define SIM_LOD_MID_MARGIN   768.0f  /* Beyond this, entities are far */
+#define SIM_LOD_MID_INTERVAL 4       /* Steps between mid-tier updates */
+#define SIM_LOD_FAR_INTERVAL 30      /* Steps between far-tier updates */
+
+/* Flow-field navigation - stress sprites chase the player across the
+ * stress test area (-WINDOW to 2x WINDOW on each axis) */
+#define FLOW_FIELD_CELL_SIZE 32.0f  /* World pixels per grid cell */
+#define FLOW_FIELD_COLS ((int)((WINDOW_WIDTH * 3 + FLOW_FIELD_CELL_SIZE - 1) / FLOW_FIELD_CELL_SIZE))
+#define FLOW_FIELD_ROWS ((int)((WINDOW_HEIGHT * 3 + FLOW_FIELD_CELL_SIZE - 1) / FLOW_FIELD_CELL_SIZE))
+#define FLOW_AGENT_SPEED     90.0f  /* Pixels per second while chasing */
+#define FLOW_SAMPLE_BATCH    256    /* Agents gathered per sampling pass */
+
+/* Transform hierarchy - nodes for attached objects (the player's weapon, etc.) */
+#define TRANSFORM_MAX_NODES 64
+
+/* Player weapon - hangs off a pivot at the player's center that turns
+ * toward the movement direction */
+#define WEAPON_WIDTH     40
+#define WEAPON_HEIGHT    10
+#define WEAPON_REACH     44.0f   /* Pivot to weapon center (pixels) */
+#define WEAPON_TURN_RATE 720.0f  /* Degrees per second */
+
+/* Gameplay event bus - ring slots per event type (rounded up to a power of 2) */
+#define EVENT_QUEUE_CAPACITY 1024
 
 /* ============================================================================
  * CAMERA SETTINGS
@@ -57,12 +140,57 @@
 #define TEXTURE_MAX_ENTRIES  32
 #define TEXTURE_PATH_MAX_LEN 128
 
+/* Storage format per category (a texture_format_t). 16-bit formats halve
+ * texture memory where the renderer supports them, else fall back to 32-bit */
+#define TEXTURE_POLICY_SPRITES    TEXTURE_FORMAT_ARGB8888  /* Loaded sprite images */
+#define TEXTURE_POLICY_BACKGROUND TEXTURE_FORMAT_RGB565    /* Opaque backdrops */
+#define TEXTURE_POLICY_GENERATED  TEXTURE_FORMAT_RGB565    /* Solid-color fills */
+
+/* ============================================================================
+ * AUDIO SETTINGS
+ * ============================================================================ */
+
+#define AUDIO_FREQUENCY            48000   /* Mixer and device sample rate (Hz) */
+#define AUDIO_BUFFER_FRAMES        1024    /* Device buffer size (~21 ms latency) */
+#define AUDIO_MAX_VOICES           64      /* Voices mixed simultaneously */
+#define AUDIO_MAX_SOUNDS           32      /* Sounds held in memory */
+#define AUDIO_MAX_STREAMS          4       /* Tracks streamed from disk */
+#define AUDIO_COMMAND_QUEUE_SIZE   256     /* Pending commands (power of 2) */
+#define AUDIO_STREAM_CHUNK_FRAMES  4096    /* Frames read from disk per refill */
+#define AUDIO_STREAM_RING_FRAMES   16384   /* Stream buffer, ~340 ms (power of 2) */
+#define AUDIO_MASTER_VOLUME        0.8f
+#define AUDIO_MUSIC_VOLUME         0.5f
+
+/* Bounce blip - synthesized, limited per frame so stress tests stay audible */
+#define AUDIO_BOUNCE_FREQUENCY     660.0f
+#define AUDIO_BOUNCE_DURATION      0.08f
+#define AUDIO_BOUNCE_VOLUME        0.25f
+#define AUDIO_BOUNCE_MAX_PER_FRAME 4
+
+/* ============================================================================
+ * PHYSICS SETTINGS
+ * ============================================================================ */
+
+#define PHYSICS_GRAVITY               900.0f  /* Pixels per second squared (down) */
+#define PHYSICS_ITERATIONS            8       /* Velocity solver passes per step */
+#define PHYSICS_ALLOWED_PENETRATION   0.5f    /* Pixels of overlap left uncorrected */
+#define PHYSICS_BIAS_FACTOR           0.2f    /* Fraction of overlap corrected per step */
+#define PHYSICS_SPECULATIVE_DISTANCE  4.0f    /* Gap at which contacts start acting (px) */
+#define PHYSICS_RESTITUTION_THRESHOLD 30.0f   /* Slower impacts don't bounce (px/s) */
+#define PHYSICS_SLEEP_LINEAR          4.0f    /* Below this speed a body may sleep (px/s) */
+#define PHYSICS_SLEEP_ANGULAR         0.05f   /* Below this spin a body may sleep (rad/s) */
+#define PHYSICS_TIME_TO_SLEEP         0.5f    /* Seconds at rest before an island sleeps */
+#define PHYSICS_GRID_CELL             64.0f   /* Spatial hash cell for static/sleeping bodies */
+#define PHYSICS_MAX_BODIES            1024    /* Capacity of the in-game world */
+#define PHYSICS_DEMO_BOXES            120     /* Boxes dropped by the demo */
+
 /* ============================================================================
  * ASSET PATHS
  * ============================================================================ */
 
 #define PLAYER_TEXTURE_PATH "assets/player.png"
 #define BACKGROUND_TEXTURE_PATH "assets/background.png"
+#define MUSIC_TRACK_PATH "assets/music.wav"  /* Optional, 16-bit PCM at AUDIO_FREQUENCY */
 
 /* ============================================================================
  * COLORS (RGB)
@@ -84,6 +212,53 @@
 
 #define DEBUG_OUTPUT_INTERVAL 500  /* Milliseconds between debug prints */
 
+/* Allocation tracking - flags heap allocations in game_update and render
+ * once warmed up: 0 = off, 1 = report each call site once, 2 = abort */
+#define ALLOC_HOT_PATH_CHECK 1
+#define ALLOC_WARMUP_FRAMES  120  /* Frames before the check arms */
+
+/* Logging - lines are queued per thread and written by a background thread
+ * (util/log.h). Levels: LOG_LEVEL_DEBUG, _INFO, _WARN, _ERROR */
+#define LOG_COMPILE_LEVEL     LOG_LEVEL_DEBUG  /* Lower levels are compiled out */
+#define LOG_DEFAULT_LEVEL     LOG_LEVEL_DEBUG  /* Runtime filter at startup */
+#define LOG_FILE_PATH         NULL             /* e.g. "knight_engine.log"; NULL = console */
+#define LOG_MAX_THREADS       8                /* Threads logging at once (one ring each) */
+#define LOG_RING_LINES        256              /* Queued lines per thread (power of 2) */
+#define LOG_LINE_MAX          512              /* Longer lines are truncated */
+#define LOG_FLUSH_INTERVAL_MS 50               /* Writer wakes at least this often */
+
+/* Telemetry - per-frame metrics sent to a local datagram socket (POSIX only)
+ * Read them with: ./knight_telemetry */
+#define TELEMETRY_ENABLED      1
+#define TELEMETRY_SOCKET_PATH  "/tmp/knight_engine.telemetry"
+#define TELEMETRY_RETRY_FRAMES 60  /* Frames to wait after finding no reader */
+
+/* Flight recorder - the last frames' timings, counts and events; a frame
+ * over the hitch threshold writes the window around it to a file
+ * (core/flight_recorder.h) */
+#define FLIGHT_RECORDER_ENABLED       1    /* flight_recorder cvar default */
+#define FLIGHT_RECORDER_FRAMES        300  /* Frames kept (5 s at 60 FPS) */
+#define FLIGHT_RECORDER_AFTER_FRAMES  60   /* Frames recorded after a hitch before writing */
+#define FLIGHT_RECORDER_HITCH_MS      (2.0f * 1000.0f / TARGET_FPS)  /* hitch_ms default */
+#define FLIGHT_RECORDER_WARMUP_FRAMES 120  /* Startup frames never count as hitches */
+#define FLIGHT_RECORDER_MAX_DUMPS     32   /* Reports written per run */
+#define FLIGHT_RECORDER_DIR           "."  /* Where hitch-*.txt reports go */
+#define FLIGHT_RECORDER_NOTE_MAX      96   /* Note text kept per frame */
+
+/* Hardware performance counters - cycles, instructions, cache and branch
+ * misses per engine phase via perf_event_open (Linux only, util/perf_counters.h) */
+#define PERF_COUNTERS_ENABLED     0    /* perf_counters cvar default */
+#define PERF_COUNTERS_MAX_REGIONS 8    /* Phases counted separately */
+
+/* Console variables - runtime settings, overriding the defaults above
+ * (util/cvar.h). Read from CVAR_CONFIG_PATH, then name=value arguments. */
+#define CVAR_CONFIG_PATH  "knight_engine.cfg"  /* Optional */
+#define CVAR_MAX_VARS     64
+#define CVAR_MAX_PENDING  32   /* Values set for names no cvar has registered */
+#define CVAR_MAX_BINDINGS 32   /* Keys toggling bool cvars */
+#define CVAR_NAME_MAX     32
+#define CVAR_VALUE_MAX    32
+
 /* ============================================================================
  * INPUT SETTINGS
  * ============================================================================ */
@@ -94,4 +269,11 @@
  * STRESS TEST SETTINGS (can be removed when not needed)
  * ============================================================================ */
 
-#define STRESS_TEST_SPRITE_COUNT 150
+/* Scenario presets live in core/stress_test.c; the first is active at startup
+ * and these bound what stepping can reach */
+#define STRESS_TEST_SPRITE_COUNT  150      /* Sprites in the default scenario */
+#define STRESS_TEST_MAX_COUNT     2000000  /* Stepping stops here (~90 bytes per sprite) */
+#define STRESS_TEST_STEP_SCALE    1.25f    /* Count multiplier per step key press */
+#define STRESS_TEST_MAX_TEXTURES  64       /* Distinct textures a scenario may ask for */
+#define STRESS_TEST_SPIN_SPEED    90.0f    /* Degrees per second of rotating sprites */
+#define STRESS_TEST_SEED          0x5EED5u /* Same scenario and count, same layout */
@@ -3,17 +3,27 @@
  */
 
 #include "core/engine.h"
+#include "audio/audio.h"
 #include "core/config.h"
 #include "core/game_logic.h"
 #include "core/game_state.h"
+#include "core/stress_test.h"
+#include "core/transform.h"
 #include "graphics/renderer.h"
 #include "graphics/sprite.h"
 #include "graphics/texture.h"
 #include "input/input.h"
 #include "input/input_config.h"
+#include "physics/physics.h"
+#include "util/alloc.h"
+#include "util/cvar.h"
 #include "util/debug.h"
+#include "util/log.h"
+#include "util/telemetry.h"
+#include "util/timer.h"
 #include <SDL2/SDL.h>
 #include <stdio.h>
+#include <string.h>
 
 /*
  * Process SDL events (window close, key presses, etc.)
@@ -33,57 +43,329 @@ static void engine_handle_events(game_state_t *game) {
                     game->running = false;
                 }
                 break;
+
+            case SDL_WINDOWEVENT:
+                switch (event.window.event) {
+                    case SDL_WINDOWEVENT_HIDDEN:
+                    case SDL_WINDOWEVENT_MINIMIZED:
+                        game->window_hidden = true;
+                        break;
+                    case SDL_WINDOWEVENT_SHOWN:
+                    case SDL_WINDOWEVENT_RESTORED:
+                    case SDL_WINDOWEVENT_MAXIMIZED:
+                        game->window_hidden = false;
+                        game->redraw_forced = true;
+                        break;
+                    case SDL_WINDOWEVENT_EXPOSED:
+                    case SDL_WINDOWEVENT_SIZE_CHANGED:
+                        game->redraw_forced = true;
+                        break;
+                    case SDL_WINDOWEVENT_FOCUS_GAINED:
+                        game->window_unfocused = false;
+                        break;
+                    case SDL_WINDOWEVENT_FOCUS_LOST:
+                        game->window_unfocused = true;
+                        break;
+                }
+                break;
         }
     }
 }
 
 /*
- * Render the game
+ * Default cvar toggle keys - a config file can rebind them
+ */
+static const struct {
+    SDL_Scancode key;
+    const char *cvar;
+} CVAR_KEYS[] = {
+    { KEY_DEBUG_TOGGLE,     "debug" },
+    { KEY_OVERDRAW_VIEW,    "r_overdraw" },
+    { KEY_STRESS_TEST,      "stress" },
+    { KEY_TOGGLE_CULL,      "r_cull" },
+    { KEY_TOGGLE_BATCH,     "r_batch" },
+    { KEY_TOGGLE_VSYNC,     "r_vsync" },
+    { KEY_TOGGLE_DYNRES,    "r_dynres" },
+    { KEY_TOGGLE_ON_DEMAND, "r_on_demand" },
+    { KEY_TOGGLE_SIM_LOD,   "sim_lod" },
+    { KEY_TOGGLE_LOG_ASYNC, "log_async" },
+};
+
+/*
+ * Hardware counter regions of a frame (perf_counters cvar) - the render
+ * phase is split so the command sort shows on its own
+ */
+enum {
+    PERF_REGION_INPUT,
+    PERF_REGION_SIM,
+    PERF_REGION_EVENTS,
+    PERF_REGION_AUDIO,
+    PERF_REGION_RECORD,    /* Recording commands */
+    PERF_REGION_SORT,      /* render_cmd_sort */
+    PERF_REGION_EXECUTE,   /* Frame hash and renderer_execute, on drawn frames */
+    PERF_REGION_PRESENT,
+    PERF_REGION_COUNT      /* At most PERF_COUNTERS_MAX_REGIONS */
+};
+
+static const char *const PERF_REGION_NAMES[PERF_REGION_COUNT] = {
+    "input", "sim", "events", "audio", "record", "sort", "execute", "present"
+};
+
+/*
+ * Whether any part of a sprite can be in view
+ * Tests a square around the sprite's center that holds it at any rotation.
+ */
+static bool engine_sprite_visible(const camera_t *camera, const sprite_t *spr) {
+    float reach = (spr->width + spr->height) * 0.5f;
+    float cx = spr->x + spr->width * 0.5f;
+    float cy = spr->y + spr->height * 0.5f;
+    return cx + reach >= camera->x && cx - reach <= camera->x + WINDOW_WIDTH &&
+           cy + reach >= camera->y && cy - reach <= camera->y + WINDOW_HEIGHT;
+}
+
+/*
+ * Record the frame
+ * Records and sorts the frame's commands; the caller decides whether the
+ * frame differs from the last one presented and executes it if so.
  */
 static void engine_render(game_state_t *game) {
-    SDL_Renderer *sdl_renderer = renderer_get_sdl(&game->renderer);
+    render_cmd_buffer_t *cmds = &game->render_cmds;
+    bool draw_debug = game->debug_enabled &&
+                      frame_governor_should_run(&game->governor, WORK_DEBUG_DRAW);
+    bool cull = game->cull_sprites;
+    int culled = 0;
 
-    renderer_clear(&game->renderer, COLOR_BG_R, COLOR_BG_G, COLOR_BG_B);
+    render_cmd_reset(cmds);
+    render_cmd_clear(cmds, COLOR_BG_R, COLOR_BG_G, COLOR_BG_B);
 
     if (game->background) {
-        SDL_RenderCopy(sdl_renderer, game->background, NULL, NULL);
+        /* Explicit logical size so the scene scale shrinks it with everything else */
+        SDL_Rect full = { 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT };
+        render_cmd_quad(cmds, render_key(RENDER_LAYER_BACKGROUND, 0, 0),
+                        game->background, NULL, &full,
+                        0.0, NULL, SDL_FLIP_NONE, 255, 255, 255);
     }
 
-    /* Sort sprites by z_index using quicksort - O(n log n) */
-    sprite_sort_by_z(game->sprites, game->render_order, game->sprite_count);
-
-    /* Render all sprites in sorted order - O(n) */
+    /* Record all sprites - draw order comes from the sort key, not this loop */
     for (int i = 0; i < game->sprite_count; i++) {
-        sprite_t *spr = &game->sprites[game->render_order[i]];
+        sprite_t *spr = &game->sprites[i];
+
+        if (cull && !engine_sprite_visible(&game->camera, spr)) {
+            culled++;
+            continue;
+        }
 
         if (spr->angle != 0.0 || spr->flip != SDL_FLIP_NONE) {
-            sprite_render_ex(sdl_renderer, spr, &game->camera, NULL,
+            sprite_render_ex(cmds, spr, &game->camera, NULL,
                              spr->angle, NULL, spr->flip,
                              255, 255, 255);
         } else {
-            sprite_render(sdl_renderer, spr, &game->camera, NULL);
+            sprite_render(cmds, spr, &game->camera, NULL);
         }
 
-        if (game->debug_enabled && spr->show_debug_bounds) {
-            debug_draw_rect_rotated(sdl_renderer, &game->camera,
+        if (draw_debug && spr->show_debug_bounds) {
+            debug_draw_rect_rotated(cmds, &game->camera,
                                     spr->x, spr->y, spr->width, spr->height,
                                     spr->angle,
                                     spr->debug_r, spr->debug_g, spr->debug_b, 255);
         }
     }
 
-    renderer_present(&game->renderer);
+    game->sprites_culled = culled;
+
+    if (game->physics_demo_active) {
+        debug_draw_physics(cmds, &game->camera, &game->physics);
+    }
+
+    /* Radix sort by key - O(n) */
+    perf_counters_mark(&game->perf, PERF_REGION_RECORD);
+    render_cmd_sort(cmds);
+    perf_counters_mark(&game->perf, PERF_REGION_SORT);
+
+    if (game->debug_dump_render) {
+        /* Written directly, in order with everything logged before it -
+         * the dump would overflow the log ring */
+        log_set_async(false);
+        render_cmd_dump(cmds);
+        game->log_async = log_set_async(game->log_async);
+        game->debug_dump_render = false;
+    }
+}
+
+/*
+ * Whether the recorded frame needs drawing
+ * Compares the command hash, plus renderer state the commands don't
+ * capture, against the last presented frame. A running stress test
+ * draws every frame - a static scenario measures draw cost too.
+ */
+static bool engine_frame_changed(game_state_t *game, Uint64 *hash_out) {
+    float scale = renderer_get_scale(&game->renderer);
+    Uint32 scale_bits;
+    memcpy(&scale_bits, &scale, sizeof(scale_bits));
+
+    Uint64 hash = render_cmd_hash(&game->render_cmds);
+    hash ^= ((Uint64)scale_bits << 1) | (Uint64)game->renderer.overdraw_view;
+    *hash_out = hash;
+
+    if (!game->render_on_demand) {
+        return true;
+    }
+    return game->redraw_forced || game->stress.active || hash != game->presented_hash;
+}
+
+/*
+ * Cvar change callbacks - for settings that take more than the new value
+ */
+static void engine_vsync_changed(void *user) {
+    renderer_t *rend = &((game_state_t *)user)->renderer;
+    if (!renderer_set_vsync(rend, rend->vsync)) {
+        rend->vsync = !rend->vsync;  /* Still as it was */
+    }
+}
+
+static void engine_dynres_changed(void *user) {
+    game_state_t *game = user;
+    if (!game->dynres_enabled) {
+        /* Back to full size, and start over from there when re-enabled */
+        render_scale_init(&game->render_scale, DYNRES_MIN_SCALE, DYNRES_MAX_SCALE,
+                          DYNRES_TARGET_MS);
+        renderer_set_scale(&game->renderer, render_scale_get(&game->render_scale));
+    }
+}
+
+static void engine_fps_display_changed(void *user) {
+    game_state_t *game = user;
+    if (!game->fps_display) {
+        renderer_set_title(&game->renderer, WINDOW_TITLE);
+    }
+}
+
+static void engine_log_level_changed(void *user) {
+    log_set_level(((game_state_t *)user)->log_level);
+}
+
+static void engine_log_async_changed(void *user) {
+    game_state_t *game = user;
+    game->log_async = log_set_async(game->log_async);
+}
+
+static void engine_perf_changed(void *user) {
+    game_state_t *game = user;
+    if (game->perf_enabled) {
+        game->perf_enabled = perf_counters_open(&game->perf);
+    } else {
+        perf_counters_close(&game->perf);
+    }
+    perf_counters_reset(&game->perf);
+    game->perf_sprite_frames = 0.0;
+    game->perf_frames = 0;
+}
+
+/*
+ * Log each phase's hardware counters since the last report, per sprite
+ */
+static void engine_log_perf(game_state_t *game) {
+    perf_counters_t *pc = &game->perf;
+    double sprites = game->perf_sprite_frames / game->perf_frames;
+
+    LOG_INFO(LOG_CAT_STATS, "[PERF] Last %u frames, %.0f sprites on average:",
+             game->perf_frames, sprites);
+    for (int r = 0; r < PERF_REGION_COUNT; r++) {
+        char text[160];
+        perf_counters_format(pc, r, sprites * pc->marks[r], "sprite", text, sizeof(text));
+        if (text[0]) {
+            LOG_INFO(LOG_CAT_STATS, "[PERF]   %-8s %s", PERF_REGION_NAMES[r], text);
+        }
+    }
+
+    perf_counters_reset(pc);
+    game->perf_sprite_frames = 0.0;
+    game->perf_frames = 0;
+}
+
+/*
+ * Expose the runtime settings as cvars and bind the default toggle keys
+ * Starts every setting at its config.h default.
+ */
+static void engine_register_cvars(game_state_t *game) {
+    game->render_on_demand = RENDER_ON_DEMAND;
+    game->dynres_enabled = DYNRES_ENABLED;
+    game->cull_sprites = RENDER_CULL_ENABLED;
+    game->sim_lod_enabled = SIM_LOD_ENABLED;
+    game->fps_display = FPS_DISPLAY_ENABLED;
+    game->fps_log = FPS_DEBUG_LOG;
+    game->log_level = LOG_DEFAULT_LEVEL;
+    game->log_async = log_set_async(true);
+    game->perf_enabled = PERF_COUNTERS_ENABLED && perf_counters_open(&game->perf);
+
+    renderer_t *rend = &game->renderer;
+    cvar_register_bool("r_cull", &game->cull_sprites,
+                       "Skip sprites outside the view", NULL, NULL);
+    cvar_register_bool("r_batch", &rend->batch_solids,
+                       "Batch solid quads into one draw call", NULL, NULL);
+    cvar_register_int("r_batch_quads", &rend->batch_quads, 1, RENDER_SOLID_BATCH_QUADS,
+                      "Solid quads per batch", NULL, NULL);
+    cvar_register_bool("r_vsync", &rend->vsync,
+                       "Present waits for vertical blank", engine_vsync_changed, game);
+    cvar_register_bool("r_dynres", &game->dynres_enabled,
+                       "Dynamic resolution", engine_dynres_changed, game);
+    cvar_register_bool("r_on_demand", &game->render_on_demand,
+                       "Skip drawing unchanged frames", NULL, NULL);
+    cvar_register_bool("r_overdraw", &rend->overdraw_view,
+                       "Overdraw heatmap instead of the scene", NULL, NULL);
+    cvar_register_bool("sim_lod", &game->sim_lod_enabled,
+                       "Update far stress sprites less often", NULL, NULL);
+    cvar_register_float("gov_budget_ms", &game->governor.budget_ms, 1.0f, 1000.0f,
+                        "Frame work budget before shedding", NULL, NULL);
+    cvar_register_bool("fps_display", &game->fps_display,
+                       "FPS in the window title", engine_fps_display_changed, game);
+    cvar_register_bool("fps_log", &game->fps_log,
+                       "Log FPS vs target", NULL, NULL);
+    cvar_register_bool("debug", &game->debug_enabled,
+                       "Debug output and bounds", NULL, NULL);
+    cvar_register_int("log_level", &game->log_level, LOG_LEVEL_DEBUG, LOG_LEVEL_ERROR,
+                      "0 debug, 1 info, 2 warn, 3 error", engine_log_level_changed, game);
+    cvar_register_bool("log_async", &game->log_async,
+                       "Log lines written by a background thread", engine_log_async_changed, game);
+    cvar_register_bool("flight_recorder", &game->flight.enabled,
+                       "Write a report around frames over hitch_ms", NULL, NULL);
+    cvar_register_float("hitch_ms", &game->flight.hitch_ms, 1.0f, 10000.0f,
+                        "Frame work + present time that counts as a hitch", NULL, NULL);
+    cvar_register_bool("perf_counters", &game->perf_enabled,
+                       "Hardware counters per phase (Linux)", engine_perf_changed, game);
+    stress_test_register_cvars(game);
+
+    for (size_t i = 0; i < sizeof(CVAR_KEYS) / sizeof(CVAR_KEYS[0]); i++) {
+        cvar_bind(CVAR_KEYS[i].key, CVAR_KEYS[i].cvar);
+    }
 }
 
 bool engine_init(game_state_t *game) {
+    /* Not open until telemetry_init and perf_counters_open - engine_cleanup
+     * after an early failure must not close fd 0 */
+    game->telemetry.fd = -1;
+    perf_counters_init(&game->perf);
+
     /* Initialize rendering system */
     if (!renderer_init(&game->renderer, WINDOW_TITLE, WINDOW_WIDTH, WINDOW_HEIGHT)) {
         return false;
     }
 
+    /* Allocate the per-frame render command buffer */
+    if (!render_cmd_buffer_init(&game->render_cmds, RENDER_CMD_MAX_COUNT)) {
+        return false;
+    }
+
     /* Initialize texture manager */
     texture_manager_init(&game->textures, renderer_get_sdl(&game->renderer));
 
+    /* Initialize dynamic resolution controller */
+    render_scale_init(&game->render_scale, DYNRES_MIN_SCALE, DYNRES_MAX_SCALE,
+                      DYNRES_TARGET_MS);
+
+    /* Initialize frame budget governor */
+    frame_governor_init(&game->governor, GOVERNOR_BUDGET_MS);
+
     /* Initialize input system */
     input_init(&game->input);
 
@@ -93,15 +375,74 @@ bool engine_init(game_state_t *game) {
 
     /* Initialize debug state */
     game->debug_enabled = false;
+    game->debug_dump_render = false;
     game->debug_last_output = 0;
-    game->debug_fps = 0.0f;
+    frame_stats_init(&game->frame_stats);
+    game->fps_last_update = SDL_GetTicks();
     game->debug_delta_time = 0.0f;
+    game->debug_bounce_count = 0;
 
     /* Initialize stress test state */
-    game->stress_test_active = false;
-    game->stress_test_base_index = 0;
+    stress_test_init(&game->stress);
 
-    /* Initialize sprite list */
+    /* Allocate coroutine behavior slots (one per sprite) */
+    if (!behavior_scheduler_init(&game->behaviors, SPRITE_MAX_COUNT)) {
+        return false;
+    }
+    game_register_behaviors(&game->behaviors);
+
+    /* Allocate event rings and hook up consumers */
+    if (!event_bus_init(&game->events, EVENT_QUEUE_CAPACITY)) {
+        return false;
+    }
+    game_subscribe_events(game);
+
+    /* Navigation grid over the stress test area */
+    if (!flow_field_init(&game->flow_field, -WINDOW_WIDTH, -WINDOW_HEIGHT,
+                         FLOW_FIELD_COLS, FLOW_FIELD_ROWS, FLOW_FIELD_CELL_SIZE)) {
+        return false;
+    }
+    game->flow_chase = false;
+    game->flow_sample_ms = 0.0f;
+
+    /* Rigid body world, empty until the physics demo starts */
+    if (!physics_world_init(&game->physics, PHYSICS_MAX_BODIES, 0.0f, PHYSICS_GRAVITY)) {
+        return false;
+    }
+    game->physics_demo_active = false;
+    game->physics_step_ms = 0.0f;
+
+    /* Telemetry is optional too - lines are dropped until a reader binds */
+#if TELEMETRY_ENABLED
+    telemetry_init(&game->telemetry, TELEMETRY_SOCKET_PATH);
+#endif
+
+    /* Hitch reports are optional too */
+    flight_recorder_init(&game->flight, FLIGHT_RECORDER_HITCH_MS);
+
+    /* Audio is optional - the game runs silently if no device opens */
+    game->sound_bounce = -1;
+    game->music_stream = -1;
+    game->music_voice = 0;
+    if (audio_init(&game->audio)) {
+        game->sound_bounce = audio_create_tone(&game->audio, AUDIO_BOUNCE_FREQUENCY,
+                                               AUDIO_BOUNCE_DURATION);
+    }
+
+    /* Initialize simulation clock */
+    game->sim_time = 0.0;
+    game->sim_step = 0;
+    for (int i = 0; i < SIM_LOD_TIER_COUNT; i++) {
+        game->sim_lod_counts[i] = 0;
+    }
+
+    /* Initialize sprite list - the stress test grows it on demand */
+    game->sprites = ENGINE_CALLOC(SPRITE_MAX_COUNT, sizeof(sprite_t));
+    if (!game->sprites) {
+        LOG_ERROR(LOG_CAT_ENGINE, "Failed to allocate sprites");
+        return false;
+    }
+    game->sprite_capacity = SPRITE_MAX_COUNT;
     game->sprite_count = 0;
 
     /* Add player sprite (index 0) */
@@ -109,14 +450,8 @@ bool engine_init(game_state_t *game) {
     game->player_index = 0;
     player->texture = texture_load(&game->textures, PLAYER_TEXTURE_PATH);
     if (!player->texture) {
-        printf("Creating fallback player sprite\n");
-        player->texture = texture_create_colored(renderer_get_sdl(&game->renderer),
-            SPRITE_WIDTH, SPRITE_HEIGHT,
-            COLOR_PLAYER_R, COLOR_PLAYER_G, COLOR_PLAYER_B);
-        if (!player->texture) {
-            fprintf(stderr, "Failed to create player texture\n");
-            return false;
-        }
+        LOG_INFO(LOG_CAT_ENGINE, "Creating fallback player sprite");
+        sprite_set_solid(player, COLOR_PLAYER_R, COLOR_PLAYER_G, COLOR_PLAYER_B);
     }
     player->x = PLAYER_START_X;
     player->y = PLAYER_START_Y;
@@ -134,8 +469,8 @@ bool engine_init(game_state_t *game) {
 
     /* Add test sprite (index 1) */
     sprite_t *test = &game->sprites[game->sprite_count++];
-    test->texture = texture_create_colored(renderer_get_sdl(&game->renderer),
-        SPRITE_WIDTH, SPRITE_HEIGHT, 255, 100, 100);
+    test->texture = NULL;
+    sprite_set_solid(test, 255, 100, 100);
     test->x = 100.0f;
     test->y = 100.0f;
     test->vel_x = 0.0f;
@@ -150,54 +485,122 @@ bool engine_init(game_state_t *game) {
     test->debug_g = 255;
     test->debug_b = 0;
 
+    /* Add weapon sprite (index 2) - positioned by the transform hierarchy */
+    sprite_t *weapon = &game->sprites[game->sprite_count++];
+    game->weapon_index = 2;
+    weapon->texture = NULL;
+    sprite_set_solid(weapon, 200, 200, 210);
+    weapon->vel_x = 0.0f;
+    weapon->vel_y = 0.0f;
+    weapon->width = WEAPON_WIDTH;
+    weapon->height = WEAPON_HEIGHT;
+    weapon->z_index = 55;
+    weapon->flip = SDL_FLIP_NONE;
+    weapon->show_debug_bounds = true;
+    weapon->debug_r = 0;
+    weapon->debug_g = 255;
+    weapon->debug_b = 255;
+
+    /* Player -> pivot -> weapon; moving the player carries the weapon along */
+    if (!transform_init(&game->transforms, TRANSFORM_MAX_NODES)) {
+        return false;
+    }
+    game->weapon_facing = 0.0f;
+    game->player_node = transform_add(&game->transforms, TRANSFORM_NONE,
+                                      player->x + player->width * 0.5f,
+                                      player->y + player->height * 0.5f, 0.0f);
+    game->weapon_pivot_node = transform_add(&game->transforms, game->player_node,
+                                            0.0f, 0.0f, game->weapon_facing);
+    game->weapon_node = transform_add(&game->transforms, game->weapon_pivot_node,
+                                      WEAPON_REACH, 0.0f, 0.0f);
+    transform_bind_sprite(&game->transforms, game->weapon_node, game->weapon_index);
+    transform_update(&game->transforms);
+    transform_apply_sprites(&game->transforms, game->sprites);
+
     /* Load background texture */
-    game->background = texture_load(&game->textures, "assets/background.png");
+    game->background = texture_load_format(&game->textures, BACKGROUND_TEXTURE_PATH,
+                                           TEXTURE_POLICY_BACKGROUND);
     if (!game->background) {
-        printf("Creating fallback background\n");
-        game->background = texture_create_colored(renderer_get_sdl(&game->renderer),
+        LOG_INFO(LOG_CAT_ENGINE, "Creating fallback background");
+        game->background = texture_create_colored_format(renderer_get_sdl(&game->renderer),
             WINDOW_WIDTH, WINDOW_HEIGHT,
-            COLOR_BG_R, COLOR_BG_G, COLOR_BG_B);
+            COLOR_BG_R, COLOR_BG_G, COLOR_BG_B, TEXTURE_POLICY_BACKGROUND);
     }
 
+    engine_register_cvars(game);
+
+    game->redraw_forced = true;
     game->running = true;
 
-    printf("Game initialized successfully\n");
+    LOG_INFO(LOG_CAT_ENGINE, "Game initialized successfully");
     return true;
 }
 
 void engine_cleanup(game_state_t *game) {
+    /* Stop the mixer before anything it might reference goes away */
+    audio_shutdown(&game->audio);
+
+    /* Stress sprites share textures the stress test owns */
+    stress_test_clear(game);
+
     /* Clean up sprite textures not in manager */
     for (int i = 0; i < game->sprite_count; i++) {
         SDL_Texture *tex = game->sprites[i].texture;
         if (tex && i != game->player_index) {
-            SDL_DestroyTexture(tex);
+            texture_destroy(tex);
         } else if (tex && !texture_get(&game->textures, PLAYER_TEXTURE_PATH)) {
-            SDL_DestroyTexture(tex);
+            texture_destroy(tex);
         }
     }
     if (game->background &&
         !texture_get(&game->textures, BACKGROUND_TEXTURE_PATH)) {
-        SDL_DestroyTexture(game->background);
+        texture_destroy(game->background);
     }
 
+    ENGINE_FREE(game->sprites);
+    game->sprites = NULL;
+    game->sprite_count = 0;
+    game->sprite_capacity = 0;
+
     texture_manager_cleanup(&game->textures);
+    render_cmd_buffer_cleanup(&game->render_cmds);
+    behavior_scheduler_cleanup(&game->behaviors);
+    event_bus_cleanup(&game->events);
+    flow_field_cleanup(&game->flow_field);
+    physics_world_cleanup(&game->physics);
+    transform_cleanup(&game->transforms);
+    telemetry_cleanup(&game->telemetry);
+    flight_recorder_cleanup(&game->flight);
+    perf_counters_close(&game->perf);
     renderer_cleanup(&game->renderer);
 
-    printf("Game cleaned up\n");
+    /* Cvars point into the game state */
+    cvar_shutdown();
+
+    LOG_INFO(LOG_CAT_ENGINE, "Game cleaned up");
 }
 
 void engine_run(game_state_t *game) {
-    printf("Controls: Arrow keys or WASD to move, P=debug, T=stress test, ESC to quit\n");
+    LOG_INFO(LOG_CAT_ENGINE,
+             "Controls: Arrow keys or WASD to move, P=debug, T=stress test, =/-=stress count, "
+             "N=stress scenario, G=scatter, F=chase player, B=physics boxes, M=music, "
+             "F1=list settings, F2-F8=toggle cull/batch/vsync/dynres/on-demand/sim LOD/async log, "
+             "F12=dump render commands, ESC to quit");
 
     Uint32 last_time = SDL_GetTicks();
+    Uint64 prev_frame_start = timer_now();  /* Unclamped frame time for telemetry */
+    Uint32 frame_index = 0;
     float accumulator = 0.0f;
 
-    /* FPS counter variables - same as original */
-    Uint32 fps_last_time = SDL_GetTicks();
-    int frame_count = 0;
-    float current_fps = 0.0f;
+    /* CPU use over each debug interval */
+    double cpu_last = timer_cpu_seconds();
+    Uint64 cpu_last_time = timer_now();
+
+    /* Settings changes seen, for flight recorder notes */
+    Uint32 cvar_changes_seen = cvar_changes();
 
     while (game->running) {
+        Uint64 frame_start = timer_now();
         Uint32 current_time = SDL_GetTicks();
         float delta_time = (current_time - last_time) / 1000.0f;
         last_time = current_time;
@@ -206,72 +609,386 @@ void engine_run(game_state_t *game) {
             delta_time = MAX_DELTA_TIME;
         }
 
-        /* FPS calculation - must increment every frame */
-        frame_count++;
-#if FPS_DISPLAY_ENABLED || FPS_DEBUG_LOG
-        if (current_time - fps_last_time >= FPS_UPDATE_INTERVAL) {
-            current_fps = frame_count * 1000.0f / (current_time - fps_last_time);
-            frame_count = 0;
-            fps_last_time = current_time;
-
-#if FPS_DISPLAY_ENABLED
-            char title_buffer[128];
-            snprintf(title_buffer, sizeof(title_buffer), "%s - %.1f FPS",
-                     WINDOW_TITLE, current_fps);
-            renderer_set_title(&game->renderer, title_buffer);
-#endif
-
-#if FPS_DEBUG_LOG
-            float fps_diff = current_fps - TARGET_FPS;
-            printf("[FPS] Actual: %.1f | Target: %d | Diff: %+.1f\n",
-                   current_fps, TARGET_FPS, fps_diff);
-#endif
+        /* FPS display - rolling statistics over the last FRAME_STATS_WINDOW frames */
+        if ((game->fps_display || game->fps_log) &&
+            current_time - game->fps_last_update >= FPS_UPDATE_INTERVAL) {
+            game->fps_last_update = current_time;
+            const frame_stats_t *fstats = &game->frame_stats;
+
+            if (game->fps_display &&
+                frame_governor_should_run(&game->governor, WORK_TELEMETRY)) {
+                char title_buffer[128];
+                snprintf(title_buffer, sizeof(title_buffer),
+                         "%s - %.1f FPS (p99 %.1f ms) - Res %d%%",
+                         WINDOW_TITLE, frame_stats_fps(fstats),
+                         frame_stats_percentile(fstats, FRAME_SERIES_FRAME, 0.99f),
+                         (int)(renderer_get_scale(&game->renderer) * 100.0f + 0.5f));
+                renderer_set_title(&game->renderer, title_buffer);
+            }
+
+            if (game->fps_log) {
+                float fps = frame_stats_fps(fstats);
+                LOG_DEBUG(LOG_CAT_STATS, "[FPS] Actual: %.1f | Target: %d | Diff: %+.1f | "
+                          "Frame min/p95/p99/max: %.2f/%.2f/%.2f/%.2fms",
+                          fps, TARGET_FPS, fps - TARGET_FPS,
+                          frame_stats_min(fstats, FRAME_SERIES_FRAME),
+                          frame_stats_percentile(fstats, FRAME_SERIES_FRAME, 0.95f),
+                          frame_stats_percentile(fstats, FRAME_SERIES_FRAME, 0.99f),
+                          frame_stats_max(fstats, FRAME_SERIES_FRAME));
+            }
         }
-#endif
 
         /* Store debug values */
-        game->debug_fps = current_fps;
         game->debug_delta_time = delta_time;
 
-        /* Debug output (when enabled) */
-        if (game->debug_enabled &&
-            current_time - game->debug_last_output >= DEBUG_OUTPUT_INTERVAL) {
+        /* CPU use and debug output (when enabled) - output is skipped, not
+         * retried, when shed */
+        if (current_time - game->debug_last_output >= DEBUG_OUTPUT_INTERVAL) {
             game->debug_last_output = current_time;
-            printf("[DEBUG] FPS: %.1f | Delta: %.4fs (%.2fms) | "
-                   "Sprites: %d | Player: (%.1f, %.1f) | Camera: (%.1f, %.1f)\n",
-                   game->debug_fps,
-                   game->debug_delta_time,
-                   game->debug_delta_time * 1000.0f,
-                   game->sprite_count,
-                   game->sprites[game->player_index].x,
-                   game->sprites[game->player_index].y,
-                   game->camera.x,
-                   game->camera.y);
+
+            double cpu_now = timer_cpu_seconds();
+            float wall_ms = timer_elapsed_ms(cpu_last_time, frame_start);
+            if (wall_ms > 0.0f) {
+                game->cpu_percent = (float)((cpu_now - cpu_last) * 1000.0 / wall_ms * 100.0);
+            }
+            cpu_last = cpu_now;
+            cpu_last_time = frame_start;
+
+            if (game->debug_enabled &&
+                frame_governor_should_run(&game->governor, WORK_TELEMETRY)) {
+                const frame_governor_t *gov = &game->governor;
+                const frame_stats_t *fstats = &game->frame_stats;
+                LOG_DEBUG(LOG_CAT_STATS,
+                          "[DEBUG] FPS: %.1f | Delta: %.4fs (%.2fms) | Res: %.0f%% (%.2fms avg) | "
+                          "Sprites: %d (%d culled) | Player: (%.1f, %.1f) | Camera: (%.1f, %.1f) | "
+                          "Transforms: %d (%d updated)",
+                          frame_stats_fps(fstats),
+                          game->debug_delta_time,
+                          game->debug_delta_time * 1000.0f,
+                          renderer_get_scale(&game->renderer) * 100.0f,
+                          game->render_scale.smoothed_ms,
+                          game->sprite_count,
+                          game->sprites_culled,
+                          game->sprites[game->player_index].x,
+                          game->sprites[game->player_index].y,
+                          game->camera.x,
+                          game->camera.y,
+                          game->transforms.count,
+                          game->transforms.updated_last);
+                char series_text[384];
+                int len = 0;
+                for (int s = 0; s < FRAME_SERIES_COUNT && len < (int)sizeof(series_text); s++) {
+                    len += snprintf(series_text + len, sizeof(series_text) - (size_t)len,
+                                    "%s %s %.2f/%.2f/%.2f/%.2f", s ? " |" : "",
+                                    frame_stats_series_name((frame_series_t)s),
+                                    frame_stats_mean(fstats, (frame_series_t)s),
+                                    frame_stats_percentile(fstats, (frame_series_t)s, 0.95f),
+                                    frame_stats_percentile(fstats, (frame_series_t)s, 0.99f),
+                                    frame_stats_max(fstats, (frame_series_t)s));
+                }
+                LOG_DEBUG(LOG_CAT_STATS, "[DEBUG] Frame times (last %d, mean/p95/p99/max ms):%s",
+                          fstats->series[FRAME_SERIES_FRAME].count, series_text);
+                LOG_DEBUG(LOG_CAT_STATS, "[DEBUG] Governor: level %d | Work: %.2f/%.2fms | "
+                          "Deferred sim/visuals/debug/telemetry/assets: %u/%u/%u/%u/%u | "
+                          "Sim dropped: %.3fs | LOD near/mid/far: %d/%d/%d | "
+                          "Behaviors: %d active, %d resumed | Bounces: %d (%d dropped) | "
+                          "Voices: %d (%d underrun frames)",
+                          gov->level, gov->last_work_ms, gov->budget_ms,
+                          gov->deferrals[WORK_SIMULATION],
+                          gov->deferrals[WORK_VISUALS],
+                          gov->deferrals[WORK_DEBUG_DRAW],
+                          gov->deferrals[WORK_TELEMETRY],
+                          gov->deferrals[WORK_ASSET_UPLOAD],
+                          gov->sim_dropped,
+                          game->sim_lod_counts[SIM_LOD_NEAR],
+                          game->sim_lod_counts[SIM_LOD_MID],
+                          game->sim_lod_counts[SIM_LOD_FAR],
+                          behavior_active_count(&game->behaviors),
+                          game->behaviors.resumed_last_run,
+                          game->debug_bounce_count,
+                          event_bus_dropped(&game->events, EVENT_ENTITY_BOUNCED),
+                          audio_active_voices(&game->audio),
+                          SDL_AtomicGet(&game->audio.underruns));
+                const renderer_stats_t *rstats = renderer_get_stats(&game->renderer);
+                LOG_DEBUG(LOG_CAT_STATS, "[DEBUG] Renderer: %u draws | %u texture binds | "
+                          "%u color / %u state changes | %u vertices | %.2fx overdraw | "
+                          "%u clears skipped | %u pre-rotated | "
+                          "Textures: %lu KB (%lu KB saved, %lu KB rotation cache)",
+                          rstats->draw_calls, rstats->texture_binds,
+                          rstats->color_changes, rstats->state_changes,
+                          rstats->vertices, renderer_overdraw(&game->renderer),
+                          rstats->clears_skipped, rstats->rotations_cached,
+                          (unsigned long)(texture_memory_bytes() / 1024),
+                          (unsigned long)(texture_memory_saved_bytes() / 1024),
+                          (unsigned long)(renderer_rotation_cache_bytes(&game->renderer) / 1024));
+                const alloc_frame_stats_t *allocs = alloc_last_frame();
+                LOG_DEBUG(LOG_CAT_STATS, "[DEBUG] Allocations: %u (%lu bytes), %u frees | "
+                          "input/sim/events/audio/render/present: %u/%u/%u/%u/%u/%u | "
+                          "Other threads: %d | Hot-path sites: %d",
+                          allocs->total_count, (unsigned long)allocs->total_bytes, allocs->frees,
+                          allocs->count[ALLOC_PHASE_INPUT], allocs->count[ALLOC_PHASE_SIM],
+                          allocs->count[ALLOC_PHASE_EVENTS], allocs->count[ALLOC_PHASE_AUDIO],
+                          allocs->count[ALLOC_PHASE_RENDER], allocs->count[ALLOC_PHASE_PRESENT],
+                          alloc_other_thread_count(), alloc_hot_path_reports());
+                LOG_DEBUG(LOG_CAT_STATS,
+                          "[DEBUG] Pacing: %d presented, %d unchanged skipped | Window: %s | "
+                          "CPU: %.1f%% of a core | Hitches: %u (%d reports, %d dropped)",
+                          game->frames_presented, game->frames_skipped,
+                          game->window_hidden ? "hidden" :
+                          game->window_unfocused ? "unfocused" : "focused",
+                          game->cpu_percent, game->flight.hitches, game->flight.dumps,
+                          game->flight.dumps_skipped);
+                if (game->flow_chase && game->stress.active) {
+                    int agents = game->stress.moving_end - game->stress.base_index;
+                    LOG_DEBUG(LOG_CAT_STATS,
+                              "[DEBUG] Flow field: %dx%d cells | Builds: %d (last %.3fms) | "
+                              "Sampling: %.3fms (%.1f ns/agent)",
+                              game->flow_field.width, game->flow_field.height,
+                              game->flow_field.builds, game->flow_field.last_build_ms,
+                              game->flow_sample_ms,
+                              agents > 0 ? game->flow_sample_ms * 1e6f / agents : 0.0f);
+                }
+                if (game->physics_demo_active) {
+                    const physics_world_t *world = &game->physics;
+                    LOG_DEBUG(LOG_CAT_STATS,
+                              "[DEBUG] Physics: %d bodies | Awake: %d | Sleeping: %d | "
+                              "Islands: %d | Pairs: %d | Contacts: %d | Step: %.3fms",
+                              world->body_count, world->stat_awake,
+                              physics_sleeping_count(world), world->stat_islands,
+                              world->stat_pairs, world->stat_contacts, game->physics_step_ms);
+                }
+            }
+            if (game->perf_enabled && game->perf_frames > 0) {
+                engine_log_perf(game);
+            }
+            game->frames_presented = 0;
+            game->frames_skipped = 0;
         }
 
+        alloc_frame_begin();
+        alloc_set_phase(ALLOC_PHASE_INPUT);
+        telemetry_frame_t tel = {0};
+        tel.frame_ms = timer_elapsed_ms(prev_frame_start, frame_start);
+        prev_frame_start = frame_start;
+        Uint64 phase_start = timer_now();
+        perf_counters_begin(&game->perf);
+
         input_update(&game->input);
         engine_handle_events(game);
         game_process_input(game);
 
-        /* Handle discrete input (toggles) - must be per-frame, not fixed timestep */
-        if (input_key_pressed(&game->input, KEY_DEBUG_TOGGLE)) {
-            game->debug_enabled = !game->debug_enabled;
-            printf("[DEBUG] Debug mode %s\n", game->debug_enabled ? "ENABLED" : "DISABLED");
+        /* Handle discrete input (toggles) - must be per-frame, not fixed timestep.
+         * Debug, overdraw view, stress test and the F-key settings are
+         * bound cvars (CVAR_KEYS). */
+        cvar_poll_bindings(&game->input);
+        if (input_key_pressed(&game->input, KEY_CVAR_DUMP)) {
+            cvar_dump();
+        }
+        if (input_key_pressed(&game->input, KEY_RENDER_DUMP)) {
+            game->debug_dump_render = true;
+        }
+        if (input_key_pressed(&game->input, KEY_BEHAVIOR_SIGNAL)) {
+            behavior_signal(&game->behaviors, GAME_SIGNAL_SCATTER);
+        }
+        if (input_key_pressed(&game->input, KEY_FLOW_CHASE)) {
+            game->flow_chase = !game->flow_chase;
+            LOG_INFO(LOG_CAT_ENGINE, "[FLOW] Chase %s", game->flow_chase ? "ENABLED" : "DISABLED");
+        }
+        if (input_key_pressed(&game->input, KEY_PHYSICS_DEMO)) {
+            debug_physics_demo_toggle(game);
+            flight_recorder_note(&game->flight, "physics demo %s",
+                                 game->physics_demo_active ? "on" : "off");
+        }
+        if (input_key_pressed(&game->input, KEY_MUSIC_TOGGLE)) {
+            if (game->music_voice) {
+                audio_stop(&game->audio, game->music_voice);
+                game->music_voice = 0;
+            } else {
+                /* Opened on first use - the track is optional */
+                if (game->music_stream < 0) {
+                    game->music_stream = audio_open_stream(&game->audio, MUSIC_TRACK_PATH, true);
+                }
+                game->music_voice = audio_play_stream(&game->audio, game->music_stream,
+                                                      AUDIO_MUSIC_VOLUME);
+            }
+        }
+        if (input_key_pressed(&game->input, KEY_STRESS_MORE)) {
+            stress_test_step(game, 1);
         }
-        if (input_key_pressed(&game->input, KEY_STRESS_TEST)) {
-            debug_stress_test_toggle(game);
+        if (input_key_pressed(&game->input, KEY_STRESS_LESS)) {
+            stress_test_step(game, -1);
+        }
+        if (input_key_pressed(&game->input, KEY_STRESS_SCENARIO)) {
+            stress_test_next_scenario(game);
+        }
+
+        /* Stress test spawns up to millions of sprites - wait for headroom.
+         * Despawning or stepping down lowers the load, so it never waits on
+         * a shed category. Toggling again before it runs cancels the request. */
+        if (stress_test_pending(&game->stress) &&
+            (stress_test_pending_reduces_load(&game->stress, game->sprite_count) ||
+             frame_governor_should_run(&game->governor, WORK_ASSET_UPLOAD))) {
+            stress_test_apply_pending(game);
+            flight_recorder_note(&game->flight, "stress test %s, %d sprites",
+                                 game->stress.active ? "spawned" : "off", game->sprite_count);
+        }
+        if (cvar_changes() != cvar_changes_seen) {
+            flight_recorder_note(&game->flight, "%u settings changes",
+                                 cvar_changes() - cvar_changes_seen);
+            cvar_changes_seen = cvar_changes();
         }
 
-        /* Fixed timestep update loop */
+        Uint64 phase_end = timer_now();
+        tel.input_ms = timer_elapsed_ms(phase_start, phase_end);
+        phase_start = phase_end;
+        perf_counters_mark(&game->perf, PERF_REGION_INPUT);
+        alloc_set_phase(ALLOC_PHASE_SIM);
+
+        /* Fixed timestep update loop - the governor limits steps per frame and
+         * leftover time stays in the accumulator to be caught up later */
+        float sim_dropped = 0.0f;
         accumulator += delta_time;
         if (accumulator > MAX_ACCUMULATOR) {
+            sim_dropped = accumulator - MAX_ACCUMULATOR;
             accumulator = MAX_ACCUMULATOR;
         }
-        while (accumulator >= FIXED_TIMESTEP) {
+        int max_steps = frame_governor_sim_steps(&game->governor);
+        if (game->window_hidden && max_steps > BACKGROUND_SIM_STEPS) {
+            max_steps = BACKGROUND_SIM_STEPS;
+        }
+        int steps = 0;
+        while (accumulator >= FIXED_TIMESTEP && steps < max_steps) {
             game_update(game, FIXED_TIMESTEP);
             accumulator -= FIXED_TIMESTEP;
+            steps++;
+        }
+        frame_governor_record_sim(&game->governor, accumulator >= FIXED_TIMESTEP,
+                                  sim_dropped);
+        if (sim_dropped > 0.0f) {
+            flight_recorder_note(&game->flight, "sim dropped %.3fs", sim_dropped);
+        }
+        phase_end = timer_now();
+        tel.sim_ms = timer_elapsed_ms(phase_start, phase_end);
+        tel.sim_steps = steps;
+        phase_start = phase_end;
+        perf_counters_mark(&game->perf, PERF_REGION_SIM);
+        alloc_set_phase(ALLOC_PHASE_EVENTS);
+
+        /* Event phase - consumers see everything published this frame */
+        event_bus_dispatch(&game->events);
+        phase_end = timer_now();
+        tel.events_ms = timer_elapsed_ms(phase_start, phase_end);
+        phase_start = phase_end;
+        perf_counters_mark(&game->perf, PERF_REGION_EVENTS);
+        alloc_set_phase(ALLOC_PHASE_AUDIO);
+
+        /* Top up streamed tracks from disk before the mixer drains them */
+        audio_update(&game->audio);
+        phase_end = timer_now();
+        tel.audio_ms = timer_elapsed_ms(phase_start, phase_end);
+        phase_start = phase_end;
+        perf_counters_mark(&game->perf, PERF_REGION_AUDIO);
+
+        /* Record the frame, then draw and present it only if it changed */
+        bool recorded = false;
+        bool presented = false;
+        Uint64 frame_hash = 0;
+        if (!game->window_hidden &&
+            frame_governor_should_run(&game->governor, WORK_VISUALS)) {
+            alloc_set_phase(ALLOC_PHASE_RENDER);
+            engine_render(game);
+            recorded = true;
+            presented = engine_frame_changed(game, &frame_hash);
         }
 
-        engine_render(game);
+        if (presented) {
+            renderer_execute(&game->renderer, &game->render_cmds);
+            perf_counters_mark(&game->perf, PERF_REGION_EXECUTE);
+            alloc_set_phase(ALLOC_PHASE_PRESENT);
+
+            /* Frame work time, measured before present blocks on vsync */
+            phase_end = timer_now();
+            float work_ms = timer_elapsed_ms(frame_start, phase_end);
+            tel.render_ms = timer_elapsed_ms(phase_start, phase_end);
+            tel.render_cmds = render_cmd_count(&game->render_cmds);
+            tel.work_ms = work_ms;
+            renderer_present(&game->renderer);
+            tel.present_ms = timer_elapsed_ms(phase_end, timer_now());
+            perf_counters_mark(&game->perf, PERF_REGION_PRESENT);
+            game->presented_hash = frame_hash;
+            game->redraw_forced = false;
+            game->frames_presented++;
+
+            const renderer_stats_t *rstats = renderer_get_stats(&game->renderer);
+            tel.draw_calls = rstats->draw_calls;
+            tel.texture_binds = rstats->texture_binds;
+            tel.color_changes = rstats->color_changes;
+            tel.state_changes = rstats->state_changes;
+            tel.vertices = rstats->vertices;
+            tel.pixels = rstats->pixels;
+            frame_governor_end_frame(&game->governor, work_ms);
+
+            if (game->dynres_enabled &&
+                render_scale_update(&game->render_scale, work_ms)) {
+                renderer_set_scale(&game->renderer, render_scale_get(&game->render_scale));
+                flight_recorder_note(&game->flight, "res %d%%",
+                                     (int)(render_scale_get(&game->render_scale) * 100.0f + 0.5f));
+            }
+        } else {
+            if (recorded) {
+                game->frames_skipped++;
+            }
+            tel.work_ms = timer_elapsed_ms(frame_start, timer_now());
+            frame_governor_end_frame(&game->governor, tel.work_ms);
+        }
+
+        /* Not shed by the governor - the slow frames are the interesting
+         * ones, and a non-blocking send costs microseconds */
+        tel.frame = frame_index++;
+        tel.sprites = game->sprite_count;
+        tel.sprites_culled = game->sprites_culled;
+        tel.cvar_changes = cvar_changes();
+        tel.bodies = game->physics_demo_active ? game->physics.body_count : 0;
+        tel.bodies_awake = game->physics_demo_active ? game->physics.stat_awake : 0;
+        tel.texture_bytes = texture_memory_bytes();
+        tel.texture_saved = texture_memory_saved_bytes();
+        tel.allocs = alloc_last_frame()->total_count;
+        tel.alloc_bytes = alloc_last_frame()->total_bytes;
+        tel.presented = presented;
+        tel.cpu_percent = game->cpu_percent;
+        if (game->perf.available) {
+            game->perf_sprite_frames += game->sprite_count;
+            game->perf_frames++;
+        }
+
+        /* Render and present only count on frames that drew */
+        frame_sample_t sample = { {
+            tel.frame_ms, tel.work_ms, tel.input_ms, tel.sim_ms, tel.events_ms, tel.audio_ms,
+            presented ? tel.render_ms : -1.0f, presented ? tel.present_ms : -1.0f
+        } };
+        frame_stats_record(&game->frame_stats, &sample);
+        tel.frame_p95_ms = frame_stats_percentile(&game->frame_stats, FRAME_SERIES_FRAME, 0.95f);
+        tel.frame_p99_ms = frame_stats_percentile(&game->frame_stats, FRAME_SERIES_FRAME, 0.99f);
+        telemetry_publish(&game->telemetry, &tel);
+        flight_recorder_record(&game->flight, &tel, game->governor.level,
+                               game->events.dispatched_last);
+
+        /* Without a present there is no vsync wait - sleep on the event queue
+         * instead: until the next step when idle, longer when hidden, and up
+         * to the frame cap when unfocused. Input wakes the loop early. */
+        Uint32 wait_ms = 0;
+        if (game->window_hidden) {
+            wait_ms = BACKGROUND_WAIT_MS;
+        } else if (recorded && !presented) {
+            float until_step = FIXED_TIMESTEP - accumulator;
+            wait_ms = until_step > 0.0f ? (Uint32)(until_step * 1000.0f) + 1 : 0;
+        } else if (game->window_unfocused) {
+            float spent_ms = timer_elapsed_ms(frame_start, timer_now());
+            float cap_ms = 1000.0f / UNFOCUSED_FPS;
+            wait_ms = spent_ms < cap_ms ? (Uint32)(cap_ms - spent_ms) : 0;
+        }
+        if (wait_ms > 0) {
+            SDL_WaitEventTimeout(NULL, (int)wait_ms);
+        }
     }
 }
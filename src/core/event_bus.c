@@ -0,0 +1,151 @@
+/*
+ * Knight Engine 2D - Gameplay Event Bus Implementation
+ */
+
+#include "core/event_bus.h"
+#include "util/alloc.h"
+#include "util/log.h"
+#include <stdlib.h>
+
+/* Ticket arithmetic wraps; compare through unsigned subtraction */
+static int ticket_diff(int a, int b) {
+    return (int)((unsigned int)a - (unsigned int)b);
+}
+
+static bool ring_init(event_ring_t *ring, int capacity) {
+    int size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    ring->slots = ENGINE_MALLOC(sizeof(event_t) * (size_t)size);
+    ring->sequence = ENGINE_MALLOC(sizeof(SDL_atomic_t) * (size_t)size);
+    ring->capacity = size;
+    ring->mask = size - 1;
+    ring->tail = 0;
+    SDL_AtomicSet(&ring->head, 0);
+    SDL_AtomicSet(&ring->dropped, 0);
+
+    if (!ring->slots || !ring->sequence) {
+        return false;
+    }
+
+    /* Slot i is free for the producer holding ticket i */
+    for (int i = 0; i < size; i++) {
+        SDL_AtomicSet(&ring->sequence[i], i);
+    }
+    return true;
+}
+
+static void ring_cleanup(event_ring_t *ring) {
+    ENGINE_FREE(ring->slots);
+    ENGINE_FREE(ring->sequence);
+    ring->slots = NULL;
+    ring->sequence = NULL;
+    ring->capacity = 0;
+}
+
+bool event_bus_init(event_bus_t *bus, int capacity) {
+    bool ok = true;
+
+    for (int t = 0; t < EVENT_TYPE_COUNT; t++) {
+        ok = ring_init(&bus->rings[t], capacity) && ok;
+        bus->handler_count[t] = 0;
+        bus->dispatched_last[t] = 0;
+    }
+    bus->batch = ENGINE_MALLOC(sizeof(event_t) * (size_t)bus->rings[0].capacity);
+
+    if (!ok || !bus->batch) {
+        LOG_ERROR(LOG_CAT_GAME, "Failed to allocate event bus (%d events per type)", capacity);
+        event_bus_cleanup(bus);
+        return false;
+    }
+    return true;
+}
+
+void event_bus_cleanup(event_bus_t *bus) {
+    for (int t = 0; t < EVENT_TYPE_COUNT; t++) {
+        ring_cleanup(&bus->rings[t]);
+        bus->handler_count[t] = 0;
+    }
+    ENGINE_FREE(bus->batch);
+    bus->batch = NULL;
+}
+
+bool event_bus_subscribe(event_bus_t *bus, event_type_t type,
+                         event_handler_fn handler, void *user) {
+    int n = bus->handler_count[type];
+    if (n >= EVENT_MAX_HANDLERS) {
+        LOG_ERROR(LOG_CAT_GAME, "Too many handlers for event type %d", type);
+        return false;
+    }
+
+    bus->handlers[type][n] = handler;
+    bus->handler_data[type][n] = user;
+    bus->handler_count[type] = n + 1;
+    return true;
+}
+
+bool event_publish(event_bus_t *bus, const event_t *event) {
+    event_ring_t *ring = &bus->rings[event->type];
+    int pos = SDL_AtomicGet(&ring->head);
+
+    for (;;) {
+        SDL_atomic_t *seq = &ring->sequence[pos & ring->mask];
+        int diff = ticket_diff(SDL_AtomicGet(seq), pos);
+
+        if (diff == 0) {
+            /* Slot is free for this lap - try to claim the ticket */
+            if (SDL_AtomicCAS(&ring->head, pos, (int)((unsigned int)pos + 1u))) {
+                break;
+            }
+            pos = SDL_AtomicGet(&ring->head);
+        } else if (diff < 0) {
+            /* Consumer hasn't freed this slot yet - ring is full */
+            SDL_AtomicAdd(&ring->dropped, 1);
+            return false;
+        } else {
+            /* Another producer took the ticket first */
+            pos = SDL_AtomicGet(&ring->head);
+        }
+    }
+
+    ring->slots[pos & ring->mask] = *event;
+    /* Publish: the consumer reads the slot once it sees ticket + 1 */
+    SDL_AtomicSet(&ring->sequence[pos & ring->mask], (int)((unsigned int)pos + 1u));
+    return true;
+}
+
+void event_bus_dispatch(event_bus_t *bus) {
+    for (int t = 0; t < EVENT_TYPE_COUNT; t++) {
+        event_ring_t *ring = &bus->rings[t];
+        int count = 0;
+
+        /* Copy out every completed slot, stopping at the first one still
+         * being written so events keep their publish order */
+        while (count < ring->capacity) {
+            int pos = ring->tail;
+            SDL_atomic_t *seq = &ring->sequence[pos & ring->mask];
+            if (ticket_diff(SDL_AtomicGet(seq), pos) != 1) {
+                break;
+            }
+
+            bus->batch[count++] = ring->slots[pos & ring->mask];
+            /* Hand the slot back to producers for the next lap */
+            SDL_AtomicSet(seq, (int)((unsigned int)pos + (unsigned int)ring->capacity));
+            ring->tail = (int)((unsigned int)pos + 1u);
+        }
+
+        bus->dispatched_last[t] = count;
+        if (count == 0) {
+            continue;
+        }
+        for (int h = 0; h < bus->handler_count[t]; h++) {
+            bus->handlers[t][h](bus->batch, count, bus->handler_data[t][h]);
+        }
+    }
+}
+
+int event_bus_dropped(event_bus_t *bus, event_type_t type) {
+    return SDL_AtomicGet(&bus->rings[type].dropped);
+}
@@ -0,0 +1,114 @@
+/*
+ * Knight Engine 2D - Gameplay Event Bus
+ *
+ * Decouples systems that would otherwise reach into each other's state.
+ * Producers publish small POD events during the simulation step; consumers
+ * receive them later, in bulk, when the engine dispatches the bus once per
+ * frame after the fixed-step loop.
+ *
+ * Every event type has its own bounded ring buffer. Publishing is lock-free
+ * and allocation-free: producers claim a slot with a compare-and-swap on
+ * the ring's head and mark it complete through a per-slot sequence number
+ * (a multi-producer, single-consumer ring, which also covers the SPSC case).
+ * Any thread may publish; dispatch must run on one thread. When a ring is
+ * full the event is dropped and counted rather than blocking the producer.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#define EVENT_MAX_HANDLERS 4  /* Subscribers per event type */
+
+/*
+ * Event types - each gets its own ring buffer
+ */
+typedef enum {
+    EVENT_ENTITY_BOUNCED = 0,  /* Entity reflected off the world bounds */
+    EVENT_STRESS_TEST,         /* Stress test sprites spawned or despawned */
+    EVENT_TYPE_COUNT
+} event_type_t;
+
+/*
+ * Event payload - plain data, copied by value into the ring
+ */
+typedef struct {
+    event_type_t type;
+    int entity;  /* Sprite index the event is about, -1 if none */
+    union {
+        struct {
+            float x, y;          /* Position after the bounce */
+            float vel_x, vel_y;  /* Velocity after the bounce */
+        } bounce;
+        struct {
+            bool active;         /* true = spawned, false = despawned */
+            int sprite_count;    /* Total sprites afterwards */
+        } stress_test;
+    };
+} event_t;
+
+/*
+ * Batch handler - receives every pending event of one type at once
+ */
+typedef void (*event_handler_fn)(const event_t *events, int count, void *user);
+
+/*
+ * Bounded MPSC ring buffer for one event type
+ */
+typedef struct {
+    event_t *slots;
+    SDL_atomic_t *sequence;  /* Per-slot ticket: which lap the slot is ready for */
+    int capacity;            /* Power of two */
+    int mask;
+    SDL_atomic_t head;       /* Next ticket handed to a producer */
+    int tail;                /* Next ticket the consumer reads */
+    SDL_atomic_t dropped;    /* Events rejected because the ring was full */
+} event_ring_t;
+
+/*
+ * Event bus - one ring and a handler list per event type
+ */
+typedef struct {
+    event_ring_t rings[EVENT_TYPE_COUNT];
+    event_handler_fn handlers[EVENT_TYPE_COUNT][EVENT_MAX_HANDLERS];
+    void *handler_data[EVENT_TYPE_COUNT][EVENT_MAX_HANDLERS];
+    int handler_count[EVENT_TYPE_COUNT];
+    int dispatched_last[EVENT_TYPE_COUNT];  /* Events handed out by the last dispatch */
+    event_t *batch;          /* Scratch for draining a ring, capacity events */
+} event_bus_t;
+
+/*
+ * Allocate rings holding capacity events per type (rounded up to a power of 2)
+ * Returns true on success, false on allocation failure.
+ */
+bool event_bus_init(event_bus_t *bus, int capacity);
+
+/*
+ * Free ring storage
+ */
+void event_bus_cleanup(event_bus_t *bus);
+
+/*
+ * Register a batch handler for an event type (not thread-safe - do it at init)
+ * Returns false if the type already has EVENT_MAX_HANDLERS handlers.
+ */
+bool event_bus_subscribe(event_bus_t *bus, event_type_t type,
+                         event_handler_fn handler, void *user);
+
+/*
+ * Publish an event - lock-free, safe from any thread
+ * Returns false (and counts a drop) if the type's ring is full.
+ */
+bool event_publish(event_bus_t *bus, const event_t *event);
+
+/*
+ * Drain every ring in type order, handing each type's events to its
+ * handlers as one batch. Call from a single thread.
+ */
+void event_bus_dispatch(event_bus_t *bus);
+
+/*
+ * Events of a type dropped since init
+ */
+int event_bus_dropped(event_bus_t *bus, event_type_t type);
@@ -0,0 +1,218 @@
+/*
+ * Knight Engine 2D - Hitch Flight Recorder Implementation
+ */
+
+#include "core/flight_recorder.h"
+#include "util/alloc.h"
+#include "util/log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static void write_report(flight_recorder_t *fr) {
+    FILE *f = fopen(fr->report_path, "w");
+    if (!f) {
+        LOG_WARN(LOG_CAT_STATS, "[HITCH] Can't write %s", fr->report_path);
+        return;
+    }
+
+    fprintf(f, "# Knight Engine 2D hitch report\n# %s\n", fr->report_header);
+    fprintf(f, "# %d frames, oldest first; * = hitch; times in ms; "
+               "events per type (bounced/stress test)\n#\n", fr->snapshot_count);
+    fprintf(f, "#  frame    ticks   frame    work   input     sim  events   audio  render "
+               "present steps sprites  culled bodies  cmds draws binds allocs gov   cpu%%  events  notes\n");
+
+    for (int i = 0; i < fr->snapshot_count; i++) {
+        const flight_frame_t *fl = &fr->snapshot[i];
+        const telemetry_frame_t *m = &fl->metrics;
+        char events[32];
+        int len = 0;
+        for (int t = 0; t < EVENT_TYPE_COUNT && len < (int)sizeof(events); t++) {
+            len += snprintf(events + len, sizeof(events) - (size_t)len, "%s%d",
+                            t ? "/" : "", fl->events[t]);
+        }
+        fprintf(f, "%c %6u %8u %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f %7.2f %5d %7d %7d "
+                   "%6d %5d %5u %5u %6u %3d %5.1f %7s  %s\n",
+                fl->hitch ? '*' : ' ', m->frame, fl->ticks, m->frame_ms, m->work_ms,
+                m->input_ms, m->sim_ms, m->events_ms, m->audio_ms, m->render_ms,
+                m->present_ms, m->sim_steps, m->sprites, m->sprites_culled, m->bodies,
+                m->render_cmds, m->draw_calls, m->texture_binds, m->allocs,
+                fl->governor_level, m->cpu_percent, events, fl->note);
+    }
+
+    bool ok = ferror(f) == 0;
+    ok = fclose(f) == 0 && ok;
+    if (ok) {
+        LOG_INFO(LOG_CAT_STATS, "[HITCH] Wrote %s", fr->report_path);
+    } else {
+        LOG_WARN(LOG_CAT_STATS, "[HITCH] Failed writing %s", fr->report_path);
+    }
+}
+
+/*
+ * Writer thread - file I/O stays off the frame
+ */
+static int SDLCALL writer_main(void *data) {
+    flight_recorder_t *fr = data;
+    for (;;) {
+        SDL_SemWait(fr->wake);
+        if (SDL_AtomicGet(&fr->busy)) {
+            write_report(fr);
+            SDL_AtomicSet(&fr->busy, 0);
+        }
+        if (SDL_AtomicGet(&fr->quit)) {
+            return 0;
+        }
+    }
+}
+
+/*
+ * Open a report window at the first hitch
+ */
+static void begin_window(flight_recorder_t *fr, Uint32 frame) {
+    char stamp[32] = "unknown";
+    time_t now = time(NULL);
+    struct tm *local = localtime(&now);
+    if (local) {
+        strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", local);
+    }
+    snprintf(fr->path, sizeof(fr->path), "%s/hitch-%s-f%u.txt",
+             FLIGHT_RECORDER_DIR, stamp, frame);
+
+    fr->triggered = true;
+    fr->after_left = FLIGHT_RECORDER_AFTER_FRAMES;
+    fr->hitch_frame = frame;
+    fr->hitch_worst_ms = 0.0f;
+    fr->hitch_count = 0;
+}
+
+/*
+ * Copy the ring for the writer thread and wake it
+ */
+static void dispatch(flight_recorder_t *fr) {
+    fr->triggered = false;
+
+    if (!fr->thread || SDL_AtomicGet(&fr->busy) || fr->dumps >= FLIGHT_RECORDER_MAX_DUMPS) {
+        fr->dumps_skipped++;
+        LOG_WARN(LOG_CAT_STATS, "[HITCH] Frame %u: up to %.2f ms - no report (%s)",
+                 fr->hitch_frame, fr->hitch_worst_ms,
+                 fr->dumps >= FLIGHT_RECORDER_MAX_DUMPS ? "FLIGHT_RECORDER_MAX_DUMPS reached"
+                                                         : "writer busy");
+        return;
+    }
+
+    int count = fr->recorded < FLIGHT_RECORDER_FRAMES ? (int)fr->recorded
+                                                      : FLIGHT_RECORDER_FRAMES;
+    Uint32 first = fr->recorded - (Uint32)count;
+    for (int i = 0; i < count; i++) {
+        fr->snapshot[i] = fr->frames[(first + (Uint32)i) % FLIGHT_RECORDER_FRAMES];
+    }
+    fr->snapshot_count = count;
+    snprintf(fr->report_header, sizeof(fr->report_header),
+             "First hitch at frame %u; worst %.2f ms (work + present); "
+             "%d frames over %.2f ms in this window",
+             fr->hitch_frame, fr->hitch_worst_ms, fr->hitch_count, fr->hitch_ms);
+    memcpy(fr->report_path, fr->path, sizeof(fr->report_path));
+
+    fr->dumps++;
+    SDL_AtomicSet(&fr->busy, 1);
+    SDL_SemPost(fr->wake);
+}
+
+bool flight_recorder_init(flight_recorder_t *fr, float hitch_ms) {
+    memset(fr, 0, sizeof(*fr));
+    fr->enabled = FLIGHT_RECORDER_ENABLED;
+    fr->hitch_ms = hitch_ms;
+
+    fr->frames = ENGINE_CALLOC(FLIGHT_RECORDER_FRAMES, sizeof(flight_frame_t));
+    fr->snapshot = ENGINE_CALLOC(FLIGHT_RECORDER_FRAMES, sizeof(flight_frame_t));
+    fr->wake = SDL_CreateSemaphore(0);
+    if (fr->frames && fr->snapshot && fr->wake) {
+        fr->thread = SDL_CreateThread(writer_main, "flight_recorder", fr);
+    }
+    if (!fr->thread) {
+        LOG_ERROR(LOG_CAT_STATS, "Failed to start the flight recorder");
+        flight_recorder_cleanup(fr);
+        return false;
+    }
+    return true;
+}
+
+void flight_recorder_cleanup(flight_recorder_t *fr) {
+    if (fr->thread) {
+        /* Let a report in progress finish, then write the pending one */
+        while (SDL_AtomicGet(&fr->busy)) {
+            SDL_Delay(1);
+        }
+        if (fr->triggered) {
+            dispatch(fr);
+        }
+        SDL_AtomicSet(&fr->quit, 1);
+        SDL_SemPost(fr->wake);
+        SDL_WaitThread(fr->thread, NULL);
+        fr->thread = NULL;
+    }
+    if (fr->wake) {
+        SDL_DestroySemaphore(fr->wake);
+        fr->wake = NULL;
+    }
+    ENGINE_FREE(fr->frames);
+    ENGINE_FREE(fr->snapshot);
+    fr->frames = NULL;
+    fr->snapshot = NULL;
+    fr->triggered = false;
+}
+
+void flight_recorder_note(flight_recorder_t *fr, const char *fmt, ...) {
+    size_t len = strlen(fr->note);
+    if (len + 2 >= sizeof(fr->note)) {
+        return;
+    }
+    if (len > 0) {
+        fr->note[len++] = ';';
+        fr->note[len++] = ' ';
+        fr->note[len] = '\0';
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(fr->note + len, sizeof(fr->note) - len, fmt, args);
+    va_end(args);
+}
+
+void flight_recorder_record(flight_recorder_t *fr, const telemetry_frame_t *metrics,
+                            int governor_level, const int *events) {
+    if (!fr->frames) {
+        return;
+    }
+
+    flight_frame_t *f = &fr->frames[fr->recorded % FLIGHT_RECORDER_FRAMES];
+    f->metrics = *metrics;
+    f->ticks = SDL_GetTicks();
+    f->governor_level = governor_level;
+    memcpy(f->events, events, sizeof(f->events));
+    memcpy(f->note, fr->note, sizeof(f->note));
+    fr->note[0] = '\0';
+
+    /* Startup (asset loading, first allocations) isn't a hitch */
+    float busy_ms = metrics->work_ms + metrics->present_ms;
+    f->hitch = fr->enabled && fr->recorded >= FLIGHT_RECORDER_WARMUP_FRAMES &&
+               busy_ms > fr->hitch_ms;
+    fr->recorded++;
+
+    if (f->hitch) {
+        fr->hitches++;
+        if (!fr->triggered) {
+            begin_window(fr, metrics->frame);
+        }
+        fr->hitch_count++;
+        if (busy_ms > fr->hitch_worst_ms) {
+            fr->hitch_worst_ms = busy_ms;
+        }
+    }
+
+    if (fr->triggered && fr->after_left-- == 0) {
+        dispatch(fr);
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Knight Engine 2D - Hitch Flight Recorder
+ *
+ * Keeps the last FLIGHT_RECORDER_FRAMES frames of detail - the phase
+ * timings and counts also sent as telemetry, the governor level, the
+ * events dispatched and short notes about what happened (stress test
+ * spawns, settings changes) - in a ring. The rolling debug output
+ * averages a single long frame away; this keeps it.
+ *
+ * A frame is a hitch when its work plus present time exceeds hitch_ms
+ * (the deliberate idle wait of rendering on demand doesn't count). The
+ * recorder then keeps recording FLIGHT_RECORDER_AFTER_FRAMES more frames
+ * and hands the whole window to a writer thread, which saves it as
+ *
+ *   FLIGHT_RECORDER_DIR/hitch-YYYYMMDD-HHMMSS-f<frame>.txt
+ *
+ * one row per frame, hitch frames marked. Later hitches inside the
+ * after-frames join the same report; a window that closes while the
+ * previous report is still being written is dropped and counted. At most
+ * FLIGHT_RECORDER_MAX_DUMPS reports are written per run. With the
+ * flight_recorder cvar off, frames are still recorded but nothing is
+ * written.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "core/config.h"
+#include "core/event_bus.h"
+#include "util/telemetry.h"
+
+/*
+ * One recorded frame
+ */
+typedef struct {
+    telemetry_frame_t metrics;   /* Timings and counts as published */
+    Uint32 ticks;                /* SDL_GetTicks when recorded */
+    int governor_level;
+    int events[EVENT_TYPE_COUNT];  /* Dispatched this frame, per type */
+    bool hitch;
+    char note[FLIGHT_RECORDER_NOTE_MAX];
+} flight_frame_t;
+
+/*
+ * Recorder state
+ */
+typedef struct {
+    bool enabled;                /* flight_recorder cvar */
+    float hitch_ms;              /* hitch_ms cvar */
+    flight_frame_t *frames;      /* Ring of FLIGHT_RECORDER_FRAMES */
+    Uint32 recorded;             /* Frames recorded so far */
+    char note[FLIGHT_RECORDER_NOTE_MAX];  /* Notes for the frame in progress */
+    /* Pending report */
+    bool triggered;              /* A hitch is waiting for its after-frames */
+    int after_left;
+    Uint32 hitch_frame;          /* First hitch of the window */
+    float hitch_worst_ms;
+    int hitch_count;
+    char path[256];
+    /* Writer thread - owns snapshot and report_* while busy is set */
+    SDL_Thread *thread;
+    SDL_sem *wake;
+    SDL_atomic_t busy;
+    SDL_atomic_t quit;
+    flight_frame_t *snapshot;    /* Window being written, oldest first */
+    int snapshot_count;
+    char report_header[256];
+    char report_path[256];
+    /* Counters */
+    Uint32 hitches;              /* Hitch frames seen */
+    int dumps;                   /* Reports handed to the writer */
+    int dumps_skipped;           /* Windows dropped - writer busy or limit reached */
+} flight_recorder_t;
+
+/*
+ * Allocate the ring and start the writer thread
+ * Returns false on failure (the recorder is then disabled).
+ */
+bool flight_recorder_init(flight_recorder_t *fr, float hitch_ms);
+
+/*
+ * Write a pending report, then stop the writer thread and free the ring
+ */
+void flight_recorder_cleanup(flight_recorder_t *fr);
+
+/*
+ * Attach a short note to the frame in progress (appended, truncated at
+ * FLIGHT_RECORDER_NOTE_MAX)
+ */
+void flight_recorder_note(flight_recorder_t *fr, const char *fmt, ...)
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+/*
+ * Record the finished frame and check it against hitch_ms
+ * events holds EVENT_TYPE_COUNT per-type counts.
+ */
+void flight_recorder_record(flight_recorder_t *fr, const telemetry_frame_t *metrics,
+                            int governor_level, const int *events);
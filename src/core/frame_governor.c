@@ -0,0 +1,83 @@
+/*
+ * Knight Engine 2D - Frame Budget Governor Implementation
+ */
+
+#include "core/frame_governor.h"
+#include "core/config.h"
+
+/* Step limit per shed level: catch up freely at level 0, tighten under load */
+static const int sim_step_limits[WORK_CATEGORY_COUNT] = { 8, 6, 4, 3, 2 };
+
+void frame_governor_init(frame_governor_t *gov, float budget_ms) {
+    gov->budget_ms = budget_ms;
+    gov->last_work_ms = 0.0f;
+    gov->level = 0;
+    gov->over_frames = 0;
+    gov->under_frames = 0;
+    gov->frame_skips = 0;
+    gov->sim_dropped = 0.0f;
+    for (int i = 0; i < WORK_CATEGORY_COUNT; i++) {
+        gov->deferrals[i] = 0;
+    }
+}
+
+bool frame_governor_should_run(frame_governor_t *gov, work_category_t category) {
+    if (category == WORK_SIMULATION) {
+        return true;
+    }
+
+    /* At level N the N lowest-priority categories are shed */
+    bool shed = (int)category >= WORK_CATEGORY_COUNT - gov->level;
+
+    if (category == WORK_VISUALS) {
+        if (shed && gov->frame_skips < GOVERNOR_MAX_FRAME_SKIP) {
+            gov->frame_skips++;
+            gov->deferrals[category]++;
+            return false;
+        }
+        gov->frame_skips = 0;
+        return true;
+    }
+
+    if (shed) {
+        gov->deferrals[category]++;
+        return false;
+    }
+    return true;
+}
+
+int frame_governor_sim_steps(const frame_governor_t *gov) {
+    return sim_step_limits[gov->level];
+}
+
+void frame_governor_record_sim(frame_governor_t *gov, bool deferred, float dropped_s) {
+    if (deferred) {
+        gov->deferrals[WORK_SIMULATION]++;
+    }
+    gov->sim_dropped += dropped_s;
+}
+
+void frame_governor_end_frame(frame_governor_t *gov, float work_ms) {
+    gov->last_work_ms = work_ms;
+
+    if (work_ms > gov->budget_ms) {
+        gov->over_frames++;
+        gov->under_frames = 0;
+        if (gov->over_frames >= GOVERNOR_ESCALATE_FRAMES &&
+            gov->level < WORK_CATEGORY_COUNT - 1) {
+            gov->level++;
+            gov->over_frames = 0;
+        }
+    } else if (work_ms < gov->budget_ms * GOVERNOR_HEADROOM) {
+        gov->under_frames++;
+        gov->over_frames = 0;
+        if (gov->under_frames >= GOVERNOR_RELAX_FRAMES && gov->level > 0) {
+            gov->level--;
+            gov->under_frames = 0;
+        }
+    } else {
+        /* Inside the band - hold the current level */
+        gov->over_frames = 0;
+        gov->under_frames = 0;
+    }
+}
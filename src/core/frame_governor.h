@@ -0,0 +1,87 @@
+/*
+ * Knight Engine 2D - Frame Budget Governor
+ *
+ * Measures each frame's work against the frame budget and sheds low
+ * priority work when frames run long. Work is split into categories,
+ * ordered from most to least important:
+ *
+ *   WORK_SIMULATION   - fixed-step updates; never skipped, only deferred
+ *                       (fewer steps per frame, remaining time carried over)
+ *   WORK_VISUALS      - rendering the frame; skipped (frame skip), but at
+ *                       most GOVERNOR_MAX_FRAME_SKIP frames in a row
+ *   WORK_DEBUG_DRAW   - debug bounds and shapes; skipped
+ *   WORK_TELEMETRY    - debug console output and title bar updates; skipped
+ *   WORK_ASSET_UPLOAD - texture creation; deferred until there is headroom
+ *
+ * The shed level rises after a few consecutive over-budget frames and
+ * falls after a longer run of frames with headroom, so it doesn't flap.
+ * At shed level N the N lowest-priority categories are withheld.
+ *
+ * Only gate work on a category if skipping it can't keep load up: work
+ * that adds load (spawning, uploads, extra drawing) may wait for headroom,
+ * but work that removes it (despawning, freeing, lowering a level) must run
+ * unconditionally. Gated behind a shed category it would be withheld for
+ * exactly as long as the frame is too slow, so the load could never drop.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/*
+ * Work categories - lower value = higher priority
+ */
+typedef enum {
+    WORK_SIMULATION = 0,
+    WORK_VISUALS,
+    WORK_DEBUG_DRAW,
+    WORK_TELEMETRY,
+    WORK_ASSET_UPLOAD,
+    WORK_CATEGORY_COUNT
+} work_category_t;
+
+/*
+ * Governor state
+ */
+typedef struct {
+    float budget_ms;     /* Frame budget (1000 / TARGET_FPS) */
+    float last_work_ms;  /* Work time of the previous frame */
+    int level;           /* 0 = run everything, WORK_CATEGORY_COUNT - 1 = shed all but simulation */
+    int over_frames;     /* Consecutive frames over budget */
+    int under_frames;    /* Consecutive frames with headroom */
+    int frame_skips;     /* Consecutive frames without rendering */
+    float sim_dropped;   /* Simulation seconds discarded at the debt ceiling */
+    unsigned int deferrals[WORK_CATEGORY_COUNT];  /* Times each category was withheld */
+} frame_governor_t;
+
+/*
+ * Initialize the governor with a frame budget in milliseconds
+ */
+void frame_governor_init(frame_governor_t *gov, float budget_ms);
+
+/*
+ * Ask whether a category of work may run this frame
+ * Returns false (and counts a deferral) when the category is being shed.
+ * WORK_SIMULATION always returns true - use frame_governor_sim_steps.
+ * Don't ask before work that reduces load - see the top of this file.
+ */
+bool frame_governor_should_run(frame_governor_t *gov, work_category_t category);
+
+/*
+ * Maximum fixed-step updates allowed this frame
+ * Generous when there is headroom (to catch up on deferred time),
+ * tighter as the shed level rises.
+ */
+int frame_governor_sim_steps(const frame_governor_t *gov);
+
+/*
+ * Record the outcome of this frame's simulation
+ * deferred:  true if steps were left in the accumulator by the step limit
+ * dropped_s: simulation time discarded because the debt ceiling was hit
+ */
+void frame_governor_record_sim(frame_governor_t *gov, bool deferred, float dropped_s);
+
+/*
+ * Finish the frame - feed the measured work time and update the shed level
+ */
+void frame_governor_end_frame(frame_governor_t *gov, float work_ms);
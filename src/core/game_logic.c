@@ -3,11 +3,299 @@
  */
 
 #include "core/game_logic.h"
+#include "audio/audio.h"
 #include "core/config.h"
 #include "core/game_state.h"
+#include "core/sim_lod.h"
+#include "core/transform.h"
 #include "graphics/sprite.h"
 #include "input/input.h"
 #include "input/input_config.h"
+#include "nav/flow_field.h"
+#include "physics/physics.h"
+#include "util/log.h"
+#include "util/timer.h"
+#include <math.h>
+#include <stdlib.h>
+
+/*
+ * Reflect a 1D position bouncing between lo and hi, advanced by elapsed
+ * seconds in closed form. Valid for any elapsed time, so skipped LOD
+ * updates can be caught up in a single call.
+ */
+static void bounce_advance(float *pos, float *vel, float elapsed, float lo, float hi) {
+    float range = hi - lo;
+    float p = *pos < lo ? lo : (*pos > hi ? hi : *pos);
+
+    /* Unfold the reflections: the mirrored copies tile a period of 2 * range,
+     * and landing in the mirrored half means the velocity has flipped */
+    float u = fmodf(p - lo + *vel * elapsed, 2.0f * range);
+    if (u < 0.0f) {
+        u += 2.0f * range;
+    }
+
+    if (u <= range) {
+        *pos = lo + u;
+    } else {
+        *pos = hi - (u - range);
+        *vel = -*vel;
+    }
+}
+
+/*
+ * Advance a stress test sprite by elapsed seconds (motion, bounce, spin)
+ */
+static void stress_sprite_advance(sprite_t *spr, float elapsed) {
+    bounce_advance(&spr->x, &spr->vel_x, elapsed, -WINDOW_WIDTH, WINDOW_WIDTH * 2);
+    bounce_advance(&spr->y, &spr->vel_y, elapsed, -WINDOW_HEIGHT, WINDOW_HEIGHT * 2);
+    spr->angle = fmod(spr->angle + spr->spin * elapsed, 360.0);
+}
+
+/*
+ * Bring a (possibly LOD-skipped) stress sprite up to the given time, so a
+ * velocity change applies from now rather than from its last update
+ */
+static sprite_t *stress_sprite_sync(game_state_t *game, int entity, double now) {
+    sprite_t *spr = &game->sprites[entity];
+    stress_sprite_advance(spr, (float)(now - spr->sim_last));
+    spr->sim_last = now;
+    return spr;
+}
+
+/*
+ * Move a stress sprite to its new LOD tier if it crossed a boundary
+ */
+static void stress_sprite_classify(game_state_t *game, sprite_t *spr) {
+    sim_lod_tier_t tier = sim_lod_classify(&game->camera, spr->x, spr->y,
+                                           spr->width, spr->height);
+    if (tier != spr->sim_lod) {
+        game->sim_lod_counts[spr->sim_lod]--;
+        game->sim_lod_counts[tier]++;
+        spr->sim_lod = (Uint8)tier;
+    }
+}
+
+/*
+ * Steer every moving stress sprite along the flow field toward the player.
+ * Chasers update every step regardless of LOD tier. Sprite centers are
+ * gathered into small structure-of-arrays batches so the field can be
+ * sampled four agents at a time.
+ */
+static void stress_sprites_chase(game_state_t *game, float delta_time, double step_end) {
+    const sprite_t *player = &game->sprites[game->player_index];
+    float xs[FLOW_SAMPLE_BATCH], ys[FLOW_SAMPLE_BATCH];
+    float dir_x[FLOW_SAMPLE_BATCH], dir_y[FLOW_SAMPLE_BATCH];
+
+    /* Rebuilds only when the player has entered a different cell */
+    flow_field_update(&game->flow_field,
+                      player->x + player->width * 0.5f,
+                      player->y + player->height * 0.5f);
+
+    Uint64 start = timer_now();
+    int end = game->stress.moving_end;
+    for (int base = game->stress.base_index; base < end; base += FLOW_SAMPLE_BATCH) {
+        int count = end - base;
+        if (count > FLOW_SAMPLE_BATCH) {
+            count = FLOW_SAMPLE_BATCH;
+        }
+
+        for (int k = 0; k < count; k++) {
+            const sprite_t *spr = &game->sprites[base + k];
+            xs[k] = spr->x + spr->width * 0.5f;
+            ys[k] = spr->y + spr->height * 0.5f;
+        }
+
+        flow_field_sample(&game->flow_field, xs, ys, count, dir_x, dir_y);
+
+        for (int k = 0; k < count; k++) {
+            sprite_t *spr = &game->sprites[base + k];
+            spr->vel_x = dir_x[k] * FLOW_AGENT_SPEED;
+            spr->vel_y = dir_y[k] * FLOW_AGENT_SPEED;
+            spr->x += spr->vel_x * delta_time;
+            spr->y += spr->vel_y * delta_time;
+            spr->angle = fmod(spr->angle + spr->spin * delta_time, 360.0);
+            spr->sim_last = step_end;
+            stress_sprite_classify(game, spr);
+        }
+    }
+    game->flow_sample_ms = timer_elapsed_ms(start, timer_now());
+}
+
+/*
+ * Advance stress sprites [first, end) whose LOD tier is due this step
+ * (every one with sim_lod off), each catching up on all the time since
+ * its last update
+ */
+static void stress_sprites_advance(game_state_t *game, int first, int end, double step_end) {
+    bool lod = game->sim_lod_enabled;
+    for (int i = first; i < end; i++) {
+        sprite_t *spr = &game->sprites[i];
+        if (lod && !sim_lod_due((sim_lod_tier_t)spr->sim_lod, i, game->sim_step)) {
+            continue;
+        }
+
+        float old_vel_x = spr->vel_x;
+        float old_vel_y = spr->vel_y;
+        stress_sprite_advance(spr, (float)(step_end - spr->sim_last));
+        spr->sim_last = step_end;
+
+        if (spr->vel_x != old_vel_x || spr->vel_y != old_vel_y) {
+            event_t ev;
+            ev.type = EVENT_ENTITY_BOUNCED;
+            ev.entity = i;
+            ev.bounce.x = spr->x;
+            ev.bounce.y = spr->y;
+            ev.bounce.vel_x = spr->vel_x;
+            ev.bounce.vel_y = spr->vel_y;
+            event_publish(&game->events, &ev);
+        }
+
+        stress_sprite_classify(game, spr);
+    }
+}
+
+/* ============================================================================
+ * BEHAVIORS
+ * ============================================================================ */
+
+static behavior_status_t behavior_wander(behavior_state_t *co, int entity,
+                                         void *user, double now) {
+    game_state_t *game = user;
+
+    BEHAVIOR_BEGIN(co);
+    for (;;) {
+        BEHAVIOR_WAIT(co, now, 1.0 + (rand() % 2000) / 1000.0);
+
+        sprite_t *spr = stress_sprite_sync(game, entity, now);
+        spr->vel_x = (float)(rand() % 100 - 50);
+        spr->vel_y = (float)(rand() % 100 - 50);
+    }
+    BEHAVIOR_END(co);
+}
+
+static behavior_status_t behavior_scatter(behavior_state_t *co, int entity,
+                                          void *user, double now) {
+    game_state_t *game = user;
+
+    BEHAVIOR_BEGIN(co);
+    for (;;) {
+        BEHAVIOR_WAIT_SIGNAL(co, GAME_SIGNAL_SCATTER);
+
+        /* Dash directly away from the player, remembering the old velocity */
+        {
+            sprite_t *spr = stress_sprite_sync(game, entity, now);
+            const sprite_t *player = &game->sprites[game->player_index];
+            float dx = spr->x - player->x;
+            float dy = spr->y - player->y;
+            float len = sqrtf(dx * dx + dy * dy);
+            if (len < 1.0f) {
+                dx = 1.0f;
+                len = 1.0f;
+            }
+            co->locals[0] = spr->vel_x;
+            co->locals[1] = spr->vel_y;
+            spr->vel_x = dx / len * SPRITE_SPEED;
+            spr->vel_y = dy / len * SPRITE_SPEED;
+        }
+
+        BEHAVIOR_WAIT(co, now, 1.5);
+
+        {
+            sprite_t *spr = stress_sprite_sync(game, entity, now);
+            spr->vel_x = co->locals[0];
+            spr->vel_y = co->locals[1];
+        }
+    }
+    BEHAVIOR_END(co);
+}
+
+void game_register_behaviors(behavior_scheduler_t *sched) {
+    behavior_register(sched, GAME_BEHAVIOR_WANDER, behavior_wander);
+    behavior_register(sched, GAME_BEHAVIOR_SCATTER, behavior_scatter);
+}
+
+/* ============================================================================
+ * EVENT CONSUMERS
+ * ============================================================================ */
+
+static void on_entity_bounced(const event_t *events, int count, void *user) {
+    game_state_t *game = user;
+    (void)events;
+    game->debug_bounce_count += count;
+}
+
+/*
+ * Blip for bounces on screen, panned by screen position. Only the first
+ * few per frame sound so a stress test doesn't saturate the mixer.
+ */
+static void on_entity_bounced_sound(const event_t *events, int count, void *user) {
+    game_state_t *game = user;
+    int played = 0;
+
+    for (int i = 0; i < count && played < AUDIO_BOUNCE_MAX_PER_FRAME; i++) {
+        int screen_x, screen_y;
+        world_to_screen(&game->camera, events[i].bounce.x, events[i].bounce.y,
+                        &screen_x, &screen_y);
+        if (screen_x < 0 || screen_x > WINDOW_WIDTH ||
+            screen_y < 0 || screen_y > WINDOW_HEIGHT) {
+            continue;
+        }
+
+        float pan = (float)screen_x / WINDOW_WIDTH * 2.0f - 1.0f;
+        audio_play(&game->audio, game->sound_bounce, AUDIO_BOUNCE_VOLUME, pan, false);
+        played++;
+    }
+}
+
+static void on_stress_test(const event_t *events, int count, void *user) {
+    (void)user;
+    for (int i = 0; i < count; i++) {
+        LOG_INFO(LOG_CAT_GAME, "[STRESS_TEST] %s - %d sprites now active",
+                 events[i].stress_test.active ? "Enabled" : "Disabled",
+                 events[i].stress_test.sprite_count);
+    }
+}
+
+void game_subscribe_events(game_state_t *game) {
+    event_bus_subscribe(&game->events, EVENT_ENTITY_BOUNCED, on_entity_bounced, game);
+    event_bus_subscribe(&game->events, EVENT_ENTITY_BOUNCED, on_entity_bounced_sound, game);
+    event_bus_subscribe(&game->events, EVENT_STRESS_TEST, on_stress_test, game);
+}
+
+/* ============================================================================
+ * INPUT AND UPDATE
+ * ============================================================================ */
+
+/*
+ * Turn the weapon pivot toward the player's movement direction and move the
+ * hierarchy root to the player. Nothing is marked dirty while the player
+ * stands still, so the transform update is skipped entirely.
+ */
+static void update_attachments(game_state_t *game, float delta_time) {
+    const sprite_t *player = &game->sprites[game->player_index];
+
+    if (player->vel_x != 0.0f || player->vel_y != 0.0f) {
+        float target = atan2f(player->vel_y, player->vel_x) * (180.0f / 3.14159265f);
+        float diff = fmodf(target - game->weapon_facing + 540.0f, 360.0f) - 180.0f;
+        float max_turn = WEAPON_TURN_RATE * delta_time;
+        if (diff > max_turn) {
+            diff = max_turn;
+        } else if (diff < -max_turn) {
+            diff = -max_turn;
+        }
+        game->weapon_facing = fmodf(game->weapon_facing + diff + 360.0f, 360.0f);
+    }
+
+    transform_set_local(&game->transforms, game->player_node,
+                        player->x + player->width * 0.5f,
+                        player->y + player->height * 0.5f, 0.0f);
+    transform_set_local(&game->transforms, game->weapon_pivot_node,
+                        0.0f, 0.0f, game->weapon_facing);
+
+    if (transform_update(&game->transforms) > 0) {
+        transform_apply_sprites(&game->transforms, game->sprites);
+    }
+}
 
 void game_process_input(game_state_t *game) {
     const input_state_t *input = &game->input;
@@ -58,19 +346,31 @@ void game_update(game_state_t *game, float delta_time) {
     player->x += player->vel_x * delta_time;
     player->y += player->vel_y * delta_time;
 
-    /* Update stress test sprites */
-    if (game->stress_test_active) {
-        for (int i = game->stress_test_base_index; i < game->sprite_count; i++) {
-            sprite_t *spr = &game->sprites[i];
-            spr->x += spr->vel_x * delta_time;
-            spr->y += spr->vel_y * delta_time;
-            spr->angle += 90.0 * delta_time;
-            /* Bounce off world bounds */
-            if (spr->x < -WINDOW_WIDTH || spr->x > WINDOW_WIDTH * 2) spr->vel_x = -spr->vel_x;
-            if (spr->y < -WINDOW_HEIGHT || spr->y > WINDOW_HEIGHT * 2) spr->vel_y = -spr->vel_y;
+    /* Update animated stress test sprites - movers chase the player or
+     * bounce around, the rest spin in place; static ones are never touched */
+    double step_end = game->sim_time + delta_time;
+    if (game->stress.active) {
+        int first = game->stress.base_index;
+        if (game->flow_chase) {
+            stress_sprites_chase(game, delta_time, step_end);
+            first = game->stress.moving_end;
         }
+        stress_sprites_advance(game, first, game->stress.animated_end, step_end);
+    }
+
+    /* Rigid bodies advance on the same fixed step */
+    if (game->physics_demo_active) {
+        Uint64 physics_start = timer_now();
+        physics_world_step(&game->physics, delta_time);
+        game->physics_step_ms = timer_elapsed_ms(physics_start, timer_now());
     }
 
+    /* Resume only the behaviors whose wait has finished */
+    behavior_scheduler_run(&game->behaviors, game, step_end);
+
+    game->sim_time = step_end;
+    game->sim_step++;
+
     /* Clamp player position to camera's visible area (world coordinates) */
     float cam_left = game->camera.x;
     float cam_right = game->camera.x + WINDOW_WIDTH - player->width;
@@ -89,4 +389,7 @@ void game_update(game_state_t *game, float delta_time) {
     if (player->y > cam_bottom) {
         player->y = cam_bottom;
     }
+
+    /* Attached objects follow the clamped position */
+    update_attachments(game, delta_time);
 }
@@ -6,9 +6,36 @@
 
 #pragma once
 
+#include "core/behavior.h"
+
 /* Forward declaration */
 typedef struct game_state_t game_state_t;
 
+/*
+ * Scripted behaviors available to entities (ids in the behavior table)
+ */
+enum {
+    GAME_BEHAVIOR_WANDER = 0,  /* Pick a new random heading every 1-3 seconds */
+    GAME_BEHAVIOR_SCATTER      /* Sleep until GAME_SIGNAL_SCATTER, then flee the player */
+};
+
+/*
+ * Signals behaviors can wait on
+ */
+enum {
+    GAME_SIGNAL_SCATTER = 0
+};
+
+/*
+ * Register the game's behaviors with a scheduler
+ */
+void game_register_behaviors(behavior_scheduler_t *sched);
+
+/*
+ * Subscribe the game's event consumers to the event bus
+ */
+void game_subscribe_events(game_state_t *game);
+
 /*
  * Process continuous input (held keys)
  * Updates player velocity based on movement keys.
@@ -18,6 +45,6 @@ void game_process_input(game_state_t *game);
 /*
  * Update game logic
  * Handles debug toggle, stress test, camera movement, sprite updates,
- * and player position clamping.
+ * scripted behaviors, and player position clamping.
  */
 void game_update(game_state_t *game, float delta_time);
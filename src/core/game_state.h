@@ -8,12 +8,27 @@
 
 #include <SDL2/SDL.h>
 #include <stdbool.h>
+#include "audio/audio.h"
+#include "core/behavior.h"
 #include "core/config.h"
+#include "core/event_bus.h"
+#include "core/flight_recorder.h"
+#include "core/frame_governor.h"
+#include "core/sim_lod.h"
+#include "core/stress_test.h"
+#include "core/transform.h"
 #include "graphics/camera.h"
+#include "graphics/render_cmd.h"
+#include "graphics/render_scale.h"
 #include "graphics/renderer.h"
 #include "graphics/sprite.h"
 #include "graphics/texture.h"
 #include "input/input.h"
+#include "nav/flow_field.h"
+#include "physics/physics.h"
+#include "util/frame_stats.h"
+#include "util/perf_counters.h"
+#include "util/telemetry.h"
 #include "util/timer.h"
 
 /*
@@ -24,19 +39,70 @@ typedef struct game_state_t {
     texture_manager_t textures;
     input_state_t input;
     camera_t camera;
-    sprite_t sprites[SPRITE_MAX_COUNT];
+    sprite_t *sprites;  /* SPRITE_MAX_COUNT slots, grown by the stress test */
     int sprite_count;
+    int sprite_capacity;
     int player_index;  /* Index of player sprite in the array */
-    int render_order[SPRITE_MAX_COUNT];  /* Indices sorted by z_index for rendering */
+    int weapon_index;  /* Sprite following the weapon node */
+    transform_hierarchy_t transforms;  /* Parent/child attachments */
+    int player_node;        /* Root at the player's center */
+    int weapon_pivot_node;  /* Child of the player, rotated to face movement */
+    int weapon_node;        /* Child of the pivot, offset by WEAPON_REACH */
+    float weapon_facing;    /* Pivot angle in degrees */
+    render_cmd_buffer_t render_cmds;  /* Per-frame draw commands, sorted by key */
+    render_scale_t render_scale;      /* Dynamic resolution controller */
     SDL_Texture *background;
     bool running;
+    frame_governor_t governor;  /* Frame budget and work shedding */
+    /* Simulation clock */
+    double sim_time;            /* Seconds of simulated time */
+    unsigned int sim_step;      /* Fixed steps taken */
+    int sim_lod_counts[SIM_LOD_TIER_COUNT];  /* Stress sprites per LOD tier */
+    behavior_scheduler_t behaviors;          /* Coroutine behaviors, one slot per sprite */
+    event_bus_t events;                      /* Gameplay events, dispatched once per frame */
+    flow_field_t flow_field;                 /* Steering toward the player */
+    bool flow_chase;                         /* Stress sprites follow the flow field */
+    float flow_sample_ms;                    /* Last step's agent sampling time */
+    physics_world_t physics;                 /* Rigid bodies for the physics demo */
+    bool physics_demo_active;
+    float physics_step_ms;                   /* Last physics step's time */
+    /* Audio */
+    audio_t audio;
+    int sound_bounce;                  /* Bounce blip, -1 if audio is disabled */
+    int music_stream;                  /* Streamed music track, -1 until opened */
+    audio_voice_handle_t music_voice;  /* 0 when music is stopped */
+    telemetry_t telemetry;             /* Per-frame metrics to a local socket */
+    flight_recorder_t flight;          /* Recent frames, written out around hitches */
+    perf_counters_t perf;              /* Hardware counters per frame phase */
+    double perf_sprite_frames;         /* Sprites summed over frames since the last report */
+    Uint32 perf_frames;
+    /* Rendering on demand and background throttling */
+    Uint64 presented_hash;     /* Command hash of the last presented frame */
+    bool redraw_forced;        /* Window exposed or resized - present the next frame */
+    bool window_hidden;        /* Minimized or hidden - nothing is rendered */
+    bool window_unfocused;
+    int frames_presented;      /* Since the last debug print */
+    int frames_skipped;        /* Unchanged frames not drawn, since the last debug print */
+    float cpu_percent;         /* Process CPU time over wall time, last debug interval */
+    /* Runtime settings - cvars registered by engine_init, defaults from config.h */
+    bool render_on_demand;     /* r_on_demand: skip frames identical to the last one */
+    bool dynres_enabled;       /* r_dynres: scale resolution to fit the frame budget */
+    bool cull_sprites;         /* r_cull: don't record sprites outside the view */
+    bool sim_lod_enabled;      /* sim_lod: update far stress sprites less often */
+    bool fps_display;          /* fps_display: FPS in the window title */
+    bool fps_log;              /* fps_log: log FPS vs target */
+    int log_level;             /* log_level: LOG_LEVEL_DEBUG..LOG_LEVEL_ERROR */
+    bool log_async;            /* log_async: lines written by the log thread */
+    bool perf_enabled;         /* perf_counters: hardware counters per phase */
+    int sprites_culled;        /* Sprites left out of the last recorded frame */
     /* Debug state */
     bool debug_enabled;
+    bool debug_dump_render;    /* Print the next frame's command list */
     Uint32 debug_last_output;  /* Last time debug info was printed */
-    fps_counter_t fps;         /* FPS tracking */
-    float debug_fps;           /* Current FPS for debug display */
+    frame_stats_t frame_stats; /* Rolling frame and phase times (FPS, percentiles) */
+    Uint32 fps_last_update;    /* Last window title / FPS log refresh */
     float debug_delta_time;    /* Current delta time for debug display */
+    int debug_bounce_count;    /* Bounce events seen by the debug consumer */
     /* STRESS_TEST */
-    bool stress_test_active;
-    int stress_test_base_index;  /* First index of stress test sprites */
+    stress_test_t stress;
 } game_state_t;
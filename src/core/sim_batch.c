@@ -0,0 +1,248 @@
+/*
+ * Knight Engine 2D - Batch Simulation Implementation
+ */
+
+#include "core/sim_batch.h"
+#include "util/alloc.h"
+#include "util/log.h"
+#include "util/timer.h"
+#include <string.h>
+
+/* Play area of every world - the window at camera (0, 0) */
+#define SIM_PLAYER_MAX_X ((float)(WINDOW_WIDTH - SPRITE_WIDTH))
+#define SIM_PLAYER_MAX_Y ((float)(WINDOW_HEIGHT - SPRITE_HEIGHT))
+#define SIM_SPRITE_MAX_X ((float)(WINDOW_WIDTH - SIM_BATCH_SPRITE_SIZE))
+#define SIM_SPRITE_MAX_Y ((float)(WINDOW_HEIGHT - SIM_BATCH_SPRITE_SIZE))
+
+/* xorshift32 - one independent sequence per world */
+static Uint32 rng_next(Uint32 *state) {
+    Uint32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static float rng_range(Uint32 *state, float lo, float hi) {
+    return lo + (hi - lo) * (float)(rng_next(state) >> 8) / (float)(1u << 24);
+}
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/*
+ * Reflect a position that left [0, hi] back inside and flip its velocity
+ */
+static void bounce(float *pos, float *vel, float hi) {
+    if (*pos < 0.0f) {
+        *pos = -*pos;
+        *vel = -*vel;
+    } else if (*pos > hi) {
+        *pos = 2.0f * hi - *pos;
+        *vel = -*vel;
+    }
+}
+
+/*
+ * Run steps fixed steps on a contiguous range of worlds
+ * Each world's player and sprites stay in registers/cache for all steps.
+ */
+static void step_worlds(sim_batch_t *batch, int first, int count, float dt, int steps) {
+    int per_world = batch->sprites_per_world;
+    const float size = (float)SIM_BATCH_SPRITE_SIZE;
+
+    for (int w = first; w < first + count; w++) {
+        Uint8 action = batch->actions[w];
+        float move_x = (float)(((action & SIM_ACTION_RIGHT) != 0) - ((action & SIM_ACTION_LEFT) != 0));
+        float move_y = (float)(((action & SIM_ACTION_DOWN) != 0) - ((action & SIM_ACTION_UP) != 0));
+        float px = batch->player_x[w];
+        float py = batch->player_y[w];
+        float *x = batch->sprite_x + (size_t)w * per_world;
+        float *y = batch->sprite_y + (size_t)w * per_world;
+        float *vx = batch->sprite_vel_x + (size_t)w * per_world;
+        float *vy = batch->sprite_vel_y + (size_t)w * per_world;
+        Uint32 hits = 0;
+
+        for (int s = 0; s < steps; s++) {
+            px = clampf(px + move_x * SPRITE_SPEED * dt, 0.0f, SIM_PLAYER_MAX_X);
+            py = clampf(py + move_y * SPRITE_SPEED * dt, 0.0f, SIM_PLAYER_MAX_Y);
+
+            int touched = 0;
+            for (int k = 0; k < per_world; k++) {
+                x[k] += vx[k] * dt;
+                y[k] += vy[k] * dt;
+                bounce(&x[k], &vx[k], SIM_SPRITE_MAX_X);
+                bounce(&y[k], &vy[k], SIM_SPRITE_MAX_Y);
+                touched |= x[k] < px + SPRITE_WIDTH && x[k] + size > px &&
+                           y[k] < py + SPRITE_HEIGHT && y[k] + size > py;
+            }
+            hits += (Uint32)touched;
+        }
+
+        batch->player_x[w] = px;
+        batch->player_y[w] = py;
+        batch->hits[w] += hits;
+        batch->steps[w] += (Uint32)steps;
+    }
+}
+
+static int SDLCALL worker_main(void *data) {
+    sim_batch_worker_t *worker = data;
+    sim_batch_t *batch = worker->batch;
+
+    for (;;) {
+        SDL_SemWait(worker->start);
+        if (batch->quit) {
+            break;
+        }
+        step_worlds(batch, worker->first_world, worker->world_count,
+                    batch->run_dt, batch->run_steps);
+        SDL_SemPost(batch->done);
+    }
+    return 0;
+}
+
+bool sim_batch_init(sim_batch_t *batch, int world_count, int sprites_per_world,
+                    int thread_count, Uint32 seed) {
+    memset(batch, 0, sizeof(*batch));
+    batch->world_count = world_count;
+    batch->sprites_per_world = sprites_per_world;
+
+    size_t sprites = (size_t)world_count * (size_t)sprites_per_world;
+    batch->sprite_x = ENGINE_MALLOC(sizeof(float) * sprites);
+    batch->sprite_y = ENGINE_MALLOC(sizeof(float) * sprites);
+    batch->sprite_vel_x = ENGINE_MALLOC(sizeof(float) * sprites);
+    batch->sprite_vel_y = ENGINE_MALLOC(sizeof(float) * sprites);
+    batch->player_x = ENGINE_MALLOC(sizeof(float) * (size_t)world_count);
+    batch->player_y = ENGINE_MALLOC(sizeof(float) * (size_t)world_count);
+    batch->actions = ENGINE_CALLOC((size_t)world_count, sizeof(Uint8));
+    batch->hits = ENGINE_CALLOC((size_t)world_count, sizeof(Uint32));
+    batch->steps = ENGINE_CALLOC((size_t)world_count, sizeof(Uint32));
+    batch->done = SDL_CreateSemaphore(0);
+
+    if (!batch->sprite_x || !batch->sprite_y || !batch->sprite_vel_x ||
+        !batch->sprite_vel_y || !batch->player_x || !batch->player_y ||
+        !batch->actions || !batch->hits || !batch->steps || !batch->done) {
+        LOG_ERROR(LOG_CAT_GAME, "Failed to allocate batch simulation (%d worlds)", world_count);
+        sim_batch_cleanup(batch);
+        return false;
+    }
+
+    for (int w = 0; w < world_count; w++) {
+        Uint32 rng = (seed ^ ((Uint32)w * 0x9E3779B9u)) | 1u;
+        batch->player_x[w] = PLAYER_START_X;
+        batch->player_y[w] = PLAYER_START_Y;
+        for (int k = 0; k < sprites_per_world; k++) {
+            size_t i = (size_t)w * sprites_per_world + k;
+            batch->sprite_x[i] = rng_range(&rng, 0.0f, SIM_SPRITE_MAX_X);
+            batch->sprite_y[i] = rng_range(&rng, 0.0f, SIM_SPRITE_MAX_Y);
+            batch->sprite_vel_x[i] = rng_range(&rng, -SIM_BATCH_SPRITE_SPEED, SIM_BATCH_SPRITE_SPEED);
+            batch->sprite_vel_y[i] = rng_range(&rng, -SIM_BATCH_SPRITE_SPEED, SIM_BATCH_SPRITE_SPEED);
+        }
+    }
+
+    /* Contiguous world ranges, the first (remainder) ones one world larger */
+    if (thread_count <= 0) {
+        thread_count = SDL_GetCPUCount();
+    }
+    if (thread_count > SIM_BATCH_MAX_THREADS) {
+        thread_count = SIM_BATCH_MAX_THREADS;
+    }
+    if (thread_count > world_count) {
+        thread_count = world_count;
+    }
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+
+    int first = 0;
+    for (int t = 0; t < thread_count; t++) {
+        sim_batch_worker_t *worker = &batch->workers[t];
+        worker->batch = batch;
+        worker->first_world = first;
+        worker->world_count = world_count / thread_count + (t < world_count % thread_count);
+        first += worker->world_count;
+    }
+
+    /* Worker 0 is the caller; the rest get a thread each */
+    batch->thread_count = 1;
+    for (int t = 1; t < thread_count; t++) {
+        sim_batch_worker_t *worker = &batch->workers[t];
+        worker->start = SDL_CreateSemaphore(0);
+        worker->thread = worker->start ? SDL_CreateThread(worker_main, "sim_batch", worker) : NULL;
+        if (!worker->thread) {
+            LOG_ERROR(LOG_CAT_GAME, "Failed to start batch simulation thread: %s", SDL_GetError());
+            sim_batch_cleanup(batch);
+            return false;
+        }
+        batch->thread_count++;
+    }
+    return true;
+}
+
+void sim_batch_cleanup(sim_batch_t *batch) {
+    batch->quit = true;
+    for (int t = 1; t < batch->thread_count; t++) {
+        SDL_SemPost(batch->workers[t].start);
+        SDL_WaitThread(batch->workers[t].thread, NULL);
+    }
+    for (int t = 0; t < SIM_BATCH_MAX_THREADS; t++) {
+        if (batch->workers[t].start) {
+            SDL_DestroySemaphore(batch->workers[t].start);
+        }
+        batch->workers[t].start = NULL;
+        batch->workers[t].thread = NULL;
+    }
+    batch->thread_count = 0;
+
+    if (batch->done) {
+        SDL_DestroySemaphore(batch->done);
+        batch->done = NULL;
+    }
+    ENGINE_FREE(batch->sprite_x);
+    ENGINE_FREE(batch->sprite_y);
+    ENGINE_FREE(batch->sprite_vel_x);
+    ENGINE_FREE(batch->sprite_vel_y);
+    ENGINE_FREE(batch->player_x);
+    ENGINE_FREE(batch->player_y);
+    ENGINE_FREE(batch->actions);
+    ENGINE_FREE(batch->hits);
+    ENGINE_FREE(batch->steps);
+    batch->sprite_x = batch->sprite_y = NULL;
+    batch->sprite_vel_x = batch->sprite_vel_y = NULL;
+    batch->player_x = batch->player_y = NULL;
+    batch->actions = NULL;
+    batch->hits = NULL;
+    batch->steps = NULL;
+    batch->world_count = 0;
+}
+
+void sim_batch_step(sim_batch_t *batch, float dt, int steps) {
+    Uint64 start = timer_now();
+
+    /* Written before the posts, which order them for the workers */
+    batch->run_dt = dt;
+    batch->run_steps = steps;
+    for (int t = 1; t < batch->thread_count; t++) {
+        SDL_SemPost(batch->workers[t].start);
+    }
+
+    step_worlds(batch, batch->workers[0].first_world, batch->workers[0].world_count,
+                dt, steps);
+
+    for (int t = 1; t < batch->thread_count; t++) {
+        SDL_SemWait(batch->done);
+    }
+
+    batch->world_steps += (Uint64)batch->world_count * (Uint64)steps;
+    batch->last_run_ms = timer_elapsed_ms(start, timer_now());
+}
+
+double sim_batch_rate(const sim_batch_t *batch) {
+    if (batch->last_run_ms <= 0.0f) {
+        return 0.0;
+    }
+    return (double)batch->world_count * batch->run_steps * 1000.0 / batch->last_run_ms;
+}
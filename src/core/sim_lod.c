@@ -0,0 +1,46 @@
+/*
+ * Knight Engine 2D - Simulation Level of Detail Implementation
+ */
+
+#include "core/sim_lod.h"
+#include "core/config.h"
+#include "graphics/camera.h"
+
+sim_lod_tier_t sim_lod_classify(const camera_t *camera,
+                                float x, float y, int width, int height) {
+    /* Distance from the view rectangle along each axis (0 when overlapping) */
+    float dx = 0.0f;
+    float dy = 0.0f;
+
+    if (x + width < camera->x) {
+        dx = camera->x - (x + width);
+    } else if (x > camera->x + WINDOW_WIDTH) {
+        dx = x - (camera->x + WINDOW_WIDTH);
+    }
+    if (y + height < camera->y) {
+        dy = camera->y - (y + height);
+    } else if (y > camera->y + WINDOW_HEIGHT) {
+        dy = y - (camera->y + WINDOW_HEIGHT);
+    }
+
+    float dist = dx > dy ? dx : dy;
+    if (dist <= SIM_LOD_NEAR_MARGIN) {
+        return SIM_LOD_NEAR;
+    }
+    if (dist <= SIM_LOD_MID_MARGIN) {
+        return SIM_LOD_MID;
+    }
+    return SIM_LOD_FAR;
+}
+
+int sim_lod_interval(sim_lod_tier_t tier) {
+    static const int intervals[SIM_LOD_TIER_COUNT] = {
+        1, SIM_LOD_MID_INTERVAL, SIM_LOD_FAR_INTERVAL
+    };
+    return intervals[tier];
+}
+
+bool sim_lod_due(sim_lod_tier_t tier, int entity, unsigned int step) {
+    int interval = sim_lod_interval(tier);
+    return interval == 1 || (step + (unsigned int)entity) % (unsigned int)interval == 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * Knight Engine 2D - Simulation Level of Detail
+ *
+ * Entities far from the view don't need a full update every fixed step.
+ * Each entity is placed in a tier by its distance outside the camera view:
+ *
+ *   SIM_LOD_NEAR - on screen or just off it; updated every step
+ *   SIM_LOD_MID  - updated every SIM_LOD_MID_INTERVAL steps
+ *   SIM_LOD_FAR  - updated every SIM_LOD_FAR_INTERVAL steps
+ *
+ * A skipped entity is not touched at all. When its turn comes it is
+ * advanced by all the time elapsed since its last update, so the motion
+ * model must be analytic (valid for any elapsed time). Turns are
+ * staggered by entity index so each step updates the same share of every
+ * tier and the per-step cost stays flat. With the sim_lod cvar off every
+ * entity is updated every step; tiers are still tracked.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/* Forward declaration */
+typedef struct camera_t camera_t;
+
+/*
+ * LOD tiers, from most to least detailed
+ */
+typedef enum {
+    SIM_LOD_NEAR = 0,
+    SIM_LOD_MID,
+    SIM_LOD_FAR,
+    SIM_LOD_TIER_COUNT
+} sim_lod_tier_t;
+
+/*
+ * Classify a world-space rectangle by its distance outside the camera view
+ */
+sim_lod_tier_t sim_lod_classify(const camera_t *camera,
+                                float x, float y, int width, int height);
+
+/*
+ * Steps between updates for a tier
+ */
+int sim_lod_interval(sim_lod_tier_t tier);
+
+/*
+ * Check whether an entity is due for an update on this step
+ * Staggered by entity index so updates spread evenly across steps.
+ */
+bool sim_lod_due(sim_lod_tier_t tier, int entity, unsigned int step);
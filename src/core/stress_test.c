@@ -0,0 +1,311 @@
+/*
+ * Knight Engine 2D - Stress Test Scenarios Implementation
+ */
+
+#include "core/stress_test.h"
+#include "core/game_logic.h"
+#include "core/game_state.h"
+#include "core/sim_lod.h"
+#include "graphics/render_cmd.h"
+#include "graphics/renderer.h"
+#include "graphics/sprite.h"
+#include "graphics/texture.h"
+#include "util/alloc.h"
+#include "util/cvar.h"
+#include "util/log.h"
+#include <string.h>
+
+/*
+ * Scenario presets, cycled with KEY_STRESS_SCENARIO
+ */
+static const stress_params_t SCENARIOS[] = {
+    /* The original test - every sprite moving and spinning, random colors */
+    { "swarm",    STRESS_TEST_SPRITE_COUNT, 1.0f, 1.0f, 30, 49, 20, 0, 0,  32 },
+    /* Batching best case - one depth, one color, nothing moves */
+    { "static",   20000,                    0.0f, 0.0f, 40, 40, 1,  0, 1,  16 },
+    /* Mostly scenery, with some movers and spinners across many depths */
+    { "mixed",    20000,                    0.2f, 0.2f, 30, 49, 20, 0, 16, 16 },
+    /* Texture binds - a handful of shared textures over a few depths */
+    { "textured", 5000,                     0.5f, 0.1f, 30, 49, 4,  8, 0,  32 },
+};
+
+#define SCENARIO_COUNT ((int)(sizeof(SCENARIOS) / sizeof(SCENARIOS[0])))
+
+/* xorshift32 - layouts depend only on STRESS_TEST_SEED */
+static Uint32 rng_next(Uint32 *state) {
+    Uint32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static int rng_below(Uint32 *state, int n) {
+    return (int)(rng_next(state) % (Uint32)n);
+}
+
+/* Fixed color of palette entry k, packed 0xBBGGRR */
+static Uint32 palette_color(int k) {
+    Uint32 h = ((Uint32)k + 1u) * 0x9E3779B9u;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    return h;
+}
+
+static bool reserve_sprites(game_state_t *game, int capacity) {
+    if (capacity <= game->sprite_capacity) {
+        return true;
+    }
+    sprite_t *sprites = ENGINE_REALLOC(game->sprites, sizeof(sprite_t) * (size_t)capacity);
+    if (!sprites) {
+        return false;
+    }
+    game->sprites = sprites;
+    game->sprite_capacity = capacity;
+    return true;
+}
+
+static void publish_state(game_state_t *game) {
+    /* Reported by whoever consumes the event */
+    event_t ev;
+    ev.type = EVENT_STRESS_TEST;
+    ev.entity = -1;
+    ev.stress_test.active = game->stress.active;
+    ev.stress_test.sprite_count = game->sprite_count;
+    event_publish(&game->events, &ev);
+}
+
+/*
+ * Append the scenario's sprites: movers, then spinners, then static ones
+ */
+static void spawn(game_state_t *game) {
+    stress_test_t *st = &game->stress;
+    const stress_params_t *p = &st->params;
+    int base = game->sprite_count;
+
+    int moving = (int)(p->count * p->moving + 0.5f);
+    int spinning_movers = (int)(moving * p->rotating + 0.5f);
+    int spinning_still = (int)((p->count - moving) * p->rotating + 0.5f);
+
+    if (!reserve_sprites(game, base + p->count) ||
+        !render_cmd_buffer_reserve(&game->render_cmds, RENDER_CMD_MAX_COUNT + p->count) ||
+        !behavior_scheduler_reserve(&game->behaviors, base + moving)) {
+        LOG_ERROR(LOG_CAT_GAME, "[STRESS_TEST] Not enough memory for %d sprites", p->count);
+        return;
+    }
+
+    Uint32 rng = STRESS_TEST_SEED;
+
+    /* Shared textures - any that fail to create leave fewer to pick from,
+     * and none at all falls back to solid sprites */
+    int textures = p->textures < STRESS_TEST_MAX_TEXTURES ? p->textures
+                                                          : STRESS_TEST_MAX_TEXTURES;
+    st->texture_count = 0;
+    for (int t = 0; t < textures; t++) {
+        Uint32 c = palette_color(t);
+        SDL_Texture *tex = texture_create_colored(renderer_get_sdl(&game->renderer),
+                                                  p->size, p->size,
+                                                  (Uint8)c, (Uint8)(c >> 8), (Uint8)(c >> 16));
+        if (tex) {
+            st->textures[st->texture_count++] = tex;
+        }
+    }
+
+    for (int i = 0; i < p->count; i++) {
+        sprite_t *spr = &game->sprites[base + i];
+        bool moves = i < moving;
+        bool spins = moves ? i < spinning_movers : i < moving + spinning_still;
+
+        spr->solid = false;
+        spr->texture = NULL;
+        if (st->texture_count > 0) {
+            spr->texture = st->textures[rng_below(&rng, st->texture_count)];
+        } else {
+            Uint32 c = p->colors > 0 ? palette_color(rng_below(&rng, p->colors))
+                                     : rng_next(&rng);
+            sprite_set_solid(spr, (Uint8)c, (Uint8)(c >> 8), (Uint8)(c >> 16));
+        }
+
+        /* Scatter across a larger world area */
+        spr->x = (float)rng_below(&rng, WINDOW_WIDTH * 2) - WINDOW_WIDTH / 2;
+        spr->y = (float)rng_below(&rng, WINDOW_HEIGHT * 2) - WINDOW_HEIGHT / 2;
+        spr->vel_x = moves ? (float)(rng_below(&rng, 100) - 50) : 0.0f;
+        spr->vel_y = moves ? (float)(rng_below(&rng, 100) - 50) : 0.0f;
+        spr->width = p->size;
+        spr->height = p->size;
+        spr->z_index = p->z_min;
+        if (p->z_layers > 1) {
+            spr->z_index += rng_below(&rng, p->z_layers) * (p->z_max - p->z_min) /
+                            (p->z_layers - 1);
+        }
+        spr->angle = spins ? (double)rng_below(&rng, 360) : 0.0;
+        spr->spin = spins ? STRESS_TEST_SPIN_SPEED : 0.0f;
+        spr->flip = SDL_FLIP_NONE;
+        spr->show_debug_bounds = false;
+        spr->sim_last = game->sim_time;
+
+        /* Static sprites are never updated, so they stay out of the LOD tiers */
+        spr->sim_lod = SIM_LOD_NEAR;
+        if (moves || spins) {
+            spr->sim_lod = (Uint8)sim_lod_classify(&game->camera, spr->x, spr->y,
+                                                   spr->width, spr->height);
+            game->sim_lod_counts[spr->sim_lod]++;
+        }
+
+        /* Alternate scripted behaviors on movers: wanderers and scatterers */
+        if (moves) {
+            behavior_start(&game->behaviors, base + i,
+                           (i % 2) ? GAME_BEHAVIOR_SCATTER : GAME_BEHAVIOR_WANDER);
+        }
+    }
+
+    game->sprite_count = base + p->count;
+    st->base_index = base;
+    st->moving_end = base + moving;
+    st->animated_end = base + moving + spinning_still;
+    st->active = true;
+
+    LOG_INFO(LOG_CAT_GAME,
+             "[STRESS_TEST] Scenario %s: %d moving (%d spinning), %d spinning in place, "
+             "%d static | %d textures | %d KB of sprites",
+             p->name, moving, spinning_movers, spinning_still,
+             p->count - moving - spinning_still, st->texture_count,
+             (int)(sizeof(sprite_t) * (size_t)p->count / 1024));
+}
+
+void stress_test_init(stress_test_t *st) {
+    memset(st, 0, sizeof(*st));
+    st->params = SCENARIOS[0];
+}
+
+void stress_test_clear(game_state_t *game) {
+    stress_test_t *st = &game->stress;
+    if (!st->active) {
+        return;
+    }
+
+    for (int i = st->base_index; i < st->moving_end; i++) {
+        behavior_stop(&game->behaviors, i);
+    }
+    for (int t = 0; t < st->texture_count; t++) {
+        texture_destroy(st->textures[t]);
+    }
+    st->texture_count = 0;
+
+    game->sprite_count = st->base_index;
+    st->moving_end = st->base_index;
+    st->animated_end = st->base_index;
+    st->active = false;
+    for (int i = 0; i < SIM_LOD_TIER_COUNT; i++) {
+        game->sim_lod_counts[i] = 0;
+    }
+}
+
+bool stress_test_pending(const stress_test_t *st) {
+    return st->enabled != st->active || (st->respawn_pending && st->active);
+}
+
+bool stress_test_pending_reduces_load(const stress_test_t *st, int sprite_count) {
+    if (!st->active) {
+        return false;
+    }
+    return !st->enabled ||
+           (st->respawn_pending && st->params.count < sprite_count - st->base_index);
+}
+
+void stress_test_apply_pending(game_state_t *game) {
+    stress_test_t *st = &game->stress;
+    if (!stress_test_pending(st)) {
+        st->respawn_pending = false;
+        return;
+    }
+
+    if (st->active) {
+        stress_test_clear(game);
+    }
+    if (st->enabled) {
+        spawn(game);
+        st->enabled = st->active;
+    }
+    st->respawn_pending = false;
+    publish_state(game);
+}
+
+void stress_test_step(game_state_t *game, int direction) {
+    stress_test_t *st = &game->stress;
+    int count = st->params.count;
+
+    if (direction > 0) {
+        int next = (int)(count * (double)STRESS_TEST_STEP_SCALE);
+        count = next > count ? next : count + 1;
+    } else if (direction < 0) {
+        count = (int)(count / (double)STRESS_TEST_STEP_SCALE);
+    }
+    if (count < 1) {
+        count = 1;
+    }
+    if (count > STRESS_TEST_MAX_COUNT) {
+        count = STRESS_TEST_MAX_COUNT;
+    }
+    if (count == st->params.count) {
+        return;
+    }
+
+    st->params.count = count;
+    st->respawn_pending = st->active;
+    LOG_INFO(LOG_CAT_GAME, "[STRESS_TEST] Scenario %s: %d sprites%s",
+             st->params.name, count, st->active ? "" : " when started");
+}
+
+/* Load the preset st->scenario names */
+static void load_scenario(stress_test_t *st) {
+    st->params = SCENARIOS[st->scenario];
+    st->respawn_pending = st->active;
+
+    const stress_params_t *p = &st->params;
+    LOG_INFO(LOG_CAT_GAME,
+             "[STRESS_TEST] Scenario %s: %d sprites, %.0f%% moving, %.0f%% rotating, "
+             "z %d-%d over %d depths, %d textures, %d colors (0 = random), %dpx",
+             p->name, p->count, p->moving * 100.0f, p->rotating * 100.0f,
+             p->z_min, p->z_max, p->z_layers, p->textures, p->colors, p->size);
+}
+
+void stress_test_next_scenario(game_state_t *game) {
+    stress_test_t *st = &game->stress;
+    st->scenario = (st->scenario + 1) % SCENARIO_COUNT;
+    load_scenario(st);
+}
+
+static void scenario_changed(void *user) {
+    load_scenario(&((game_state_t *)user)->stress);
+}
+
+static void params_changed(void *user) {
+    stress_test_t *st = &((game_state_t *)user)->stress;
+    st->respawn_pending = st->active;
+}
+
+void stress_test_register_cvars(game_state_t *game) {
+    stress_test_t *st = &game->stress;
+    stress_params_t *p = &st->params;
+
+    cvar_register_bool("stress", &st->enabled, "Stress test sprites spawned", NULL, NULL);
+    cvar_register_int("stress_scenario", &st->scenario, 0, SCENARIO_COUNT - 1,
+                      "Preset: 0 swarm, 1 static, 2 mixed, 3 textured", scenario_changed, game);
+    cvar_register_int("stress_count", &p->count, 1, STRESS_TEST_MAX_COUNT,
+                      "Sprites spawned", params_changed, game);
+    cvar_register_float("stress_moving", &p->moving, 0.0f, 1.0f,
+                        "Fraction that move", params_changed, game);
+    cvar_register_float("stress_rotating", &p->rotating, 0.0f, 1.0f,
+                        "Fraction that spin", params_changed, game);
+    cvar_register_int("stress_z_layers", &p->z_layers, 1, 1000,
+                      "Distinct depths", params_changed, game);
+    cvar_register_int("stress_textures", &p->textures, 0, STRESS_TEST_MAX_TEXTURES,
+                      "Shared textures, 0 = solid quads", params_changed, game);
+    cvar_register_int("stress_colors", &p->colors, 0, 1 << 24,
+                      "Solid colors, 0 = random per sprite", params_changed, game);
+    cvar_register_int("stress_size", &p->size, 1, 512,
+                      "Sprite size in pixels", params_changed, game);
+}
@@ -0,0 +1,110 @@
+/*
+ * Knight Engine 2D - Stress Test Scenarios
+ *
+ * Spawns a parameterized load of sprites over the scene, for finding the
+ * sprite count at which frame time breaks the budget. A scenario sets how
+ * many sprites there are, which fractions move and spin, how they spread
+ * over depth, and how many distinct textures or colors they use. The
+ * count is then stepped up and down at runtime (KEY_STRESS_MORE/LESS),
+ * and every parameter is a cvar (stress_count, stress_moving, ...), so a
+ * scenario can be set up from the command line or a config file.
+ *
+ * Stress sprites follow the scene sprites in the sprite array, ordered by
+ * motion: movers first, then sprites spinning in place, then static ones.
+ * The update only walks [base_index, animated_end), so a static sprite
+ * costs nothing but its draw. The sprite array, the render command buffer
+ * and the behavior scheduler grow to fit; they are not shrunk again.
+ *
+ * Layouts come from a fixed seed, so a scenario at a given count is the
+ * same on every run.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "core/config.h"
+
+/* Forward declaration */
+typedef struct game_state_t game_state_t;
+
+/*
+ * What to spawn
+ */
+typedef struct {
+    const char *name;
+    int count;          /* Sprites spawned */
+    float moving;       /* Fraction that move, bounce and run behaviors */
+    float rotating;     /* Fraction that spin (drawn through the rotated path) -
+                         * applied to movers and non-movers alike; sprites
+                         * that neither move nor spin are static */
+    int z_min, z_max;   /* Depth range */
+    int z_layers;       /* Distinct depths, spread evenly over the range */
+    int textures;       /* Distinct textures shared by the sprites, 0 = solid quads */
+    int colors;         /* Distinct colors of solid sprites, 0 = random per sprite */
+    int size;           /* Width and height in pixels */
+} stress_params_t;
+
+/*
+ * Stress test state
+ */
+typedef struct {
+    stress_params_t params;  /* Scenario in use; count is stepped at runtime */
+    int scenario;            /* Preset params came from */
+    bool active;
+    bool enabled;            /* Wanted state (stress cvar) - spawns once there is upload headroom */
+    bool respawn_pending;    /* Params changed while active, waiting likewise unless fewer sprites */
+    int base_index;          /* First stress sprite */
+    int moving_end;          /* [base_index, moving_end) move */
+    int animated_end;        /* [moving_end, animated_end) spin in place; the rest are static */
+    SDL_Texture *textures[STRESS_TEST_MAX_TEXTURES];  /* Shared by the sprites */
+    int texture_count;
+} stress_test_t;
+
+/*
+ * Start inactive with the first scenario preset
+ */
+void stress_test_init(stress_test_t *st);
+
+/*
+ * Register the stress and stress_* cvars; stress_scenario is registered
+ * first, so parameters given with it apply on top of the preset
+ */
+void stress_test_register_cvars(game_state_t *game);
+
+/*
+ * Whether a spawn, despawn or respawn is waiting
+ */
+bool stress_test_pending(const stress_test_t *st);
+
+/*
+ * Whether the waiting change lowers the load - a despawn, or a respawn with
+ * fewer sprites than the sprite_count - base_index running now. Apply
+ * those straight away: waiting for headroom could wait forever.
+ */
+bool stress_test_pending_reduces_load(const stress_test_t *st, int sprite_count);
+
+/*
+ * Spawn, despawn or respawn the scenario to match enabled and params, then
+ * publish EVENT_STRESS_TEST - the caller waits for headroom, since spawning
+ * a large scenario takes a while, unless stress_test_pending_reduces_load.
+ * A spawn that fails clears enabled.
+ */
+void stress_test_apply_pending(game_state_t *game);
+
+/*
+ * Scale the sprite count by STRESS_TEST_STEP_SCALE (direction > 0) or
+ * by its inverse (direction < 0); a running test respawns at the new count
+ */
+void stress_test_step(game_state_t *game, int direction);
+
+/*
+ * Switch to the next scenario preset; a running test respawns with it
+ */
+void stress_test_next_scenario(game_state_t *game);
+
+/*
+ * Remove the stress sprites and their textures without publishing an
+ * event (shutdown)
+ */
+void stress_test_clear(game_state_t *game);
@@ -0,0 +1,449 @@
+/*
+ * Knight Engine 2D - Transform Hierarchy Implementation
+ */
+
+#include "core/transform.h"
+#include "util/alloc.h"
+#include "util/log.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*
+ * Scratch layout (ints): sort order | old-to-new slot | depth buckets | field copy
+ */
+#define SCRATCH_ORDER(h)   ((h)->scratch)
+#define SCRATCH_REMAP(h)   ((h)->scratch + (h)->capacity)
+#define SCRATCH_BUCKETS(h) ((h)->scratch + (h)->capacity * 2)
+#define SCRATCH_TEMP(h)    ((void *)((h)->scratch + (h)->capacity * 3 + 1))
+
+static bool node_valid(const transform_hierarchy_t *hier, int node) {
+    return node >= 0 && node < hier->capacity && hier->slot_of[node] >= 0;
+}
+
+static void mark_dirty(transform_hierarchy_t *hier, int slot) {
+    hier->dirty[slot] = 1;
+    if (slot < hier->dirty_first) {
+        hier->dirty_first = slot;
+    }
+}
+
+static void find_dirty_first(transform_hierarchy_t *hier) {
+    hier->dirty_first = hier->count;
+    for (int s = 0; s < hier->count; s++) {
+        if (hier->dirty[s]) {
+            hier->dirty_first = s;
+            return;
+        }
+    }
+}
+
+/* Copy every per-slot field from src to dst (dst <= src during compaction) */
+static void move_slot(transform_hierarchy_t *hier, int dst, int src) {
+    hier->parent[dst] = hier->parent[src];
+    hier->node[dst] = hier->node[src];
+    hier->depth[dst] = hier->depth[src];
+    hier->local_x[dst] = hier->local_x[src];
+    hier->local_y[dst] = hier->local_y[src];
+    hier->local_angle[dst] = hier->local_angle[src];
+    hier->local_cos[dst] = hier->local_cos[src];
+    hier->local_sin[dst] = hier->local_sin[src];
+    hier->world_x[dst] = hier->world_x[src];
+    hier->world_y[dst] = hier->world_y[src];
+    hier->world_angle[dst] = hier->world_angle[src];
+    hier->world_cos[dst] = hier->world_cos[src];
+    hier->world_sin[dst] = hier->world_sin[src];
+    hier->sprite[dst] = hier->sprite[src];
+    hier->dirty[dst] = hier->dirty[src];
+}
+
+/* Reorder one field so new slot i holds old slot order[i] */
+static void permute_field(void *field, size_t size, const int *order, int count, void *temp) {
+    Uint8 *src = field;
+    Uint8 *dst = temp;
+    for (int i = 0; i < count; i++) {
+        memcpy(dst + (size_t)i * size, src + (size_t)order[i] * size, size);
+    }
+    memcpy(field, temp, (size_t)count * size);
+}
+
+/*
+ * Stable counting sort of the slots by depth
+ * Restores the parents-before-children order after restructuring. World
+ * transforms move with their slots, so nothing needs recomputing.
+ */
+static void sort_by_depth(transform_hierarchy_t *hier) {
+    int count = hier->count;
+    int *order = SCRATCH_ORDER(hier);
+    int *remap = SCRATCH_REMAP(hier);
+    int *buckets = SCRATCH_BUCKETS(hier);
+    void *temp = SCRATCH_TEMP(hier);
+
+    int max_depth = 0;
+    for (int s = 0; s < count; s++) {
+        if (hier->depth[s] > max_depth) {
+            max_depth = hier->depth[s];
+        }
+    }
+    memset(buckets, 0, sizeof(int) * (size_t)(max_depth + 1));
+    for (int s = 0; s < count; s++) {
+        buckets[hier->depth[s]]++;
+    }
+    int offset = 0;
+    for (int d = 0; d <= max_depth; d++) {
+        int n = buckets[d];
+        buckets[d] = offset;
+        offset += n;
+    }
+    for (int s = 0; s < count; s++) {
+        int dst = buckets[hier->depth[s]]++;
+        order[dst] = s;
+        remap[s] = dst;
+    }
+
+    permute_field(hier->parent, sizeof(int), order, count, temp);
+    permute_field(hier->node, sizeof(int), order, count, temp);
+    permute_field(hier->depth, sizeof(Uint16), order, count, temp);
+    permute_field(hier->local_x, sizeof(float), order, count, temp);
+    permute_field(hier->local_y, sizeof(float), order, count, temp);
+    permute_field(hier->local_angle, sizeof(float), order, count, temp);
+    permute_field(hier->local_cos, sizeof(float), order, count, temp);
+    permute_field(hier->local_sin, sizeof(float), order, count, temp);
+    permute_field(hier->world_x, sizeof(float), order, count, temp);
+    permute_field(hier->world_y, sizeof(float), order, count, temp);
+    permute_field(hier->world_angle, sizeof(float), order, count, temp);
+    permute_field(hier->world_cos, sizeof(float), order, count, temp);
+    permute_field(hier->world_sin, sizeof(float), order, count, temp);
+    permute_field(hier->sprite, sizeof(int), order, count, temp);
+    permute_field(hier->dirty, sizeof(Uint8), order, count, temp);
+
+    for (int s = 0; s < count; s++) {
+        if (hier->parent[s] >= 0) {
+            hier->parent[s] = remap[hier->parent[s]];
+        }
+        hier->slot_of[hier->node[s]] = s;
+    }
+
+    find_dirty_first(hier);
+    hier->order_dirty = false;
+    hier->updated_last = 0;  /* Changed list holds old slots */
+}
+
+/*
+ * Flag the slots of a node's subtree in the remap scratch (1 = inside)
+ * Relies on parents preceding children, so the subtree is found in one
+ * forward scan. Returns the node's slot.
+ */
+static int mark_subtree(transform_hierarchy_t *hier, int node) {
+    int *inside = SCRATCH_REMAP(hier);
+    int root = hier->slot_of[node];
+
+    memset(inside, 0, sizeof(int) * (size_t)hier->count);
+    inside[root] = 1;
+    for (int s = root + 1; s < hier->count; s++) {
+        int p = hier->parent[s];
+        inside[s] = p >= 0 && inside[p];
+    }
+    return root;
+}
+
+/* ============================================================================
+ * LIFETIME
+ * ============================================================================ */
+
+bool transform_init(transform_hierarchy_t *hier, int capacity) {
+    memset(hier, 0, sizeof(*hier));
+    hier->capacity = capacity;
+
+    size_t n = (size_t)capacity;
+    hier->parent = ENGINE_MALLOC(sizeof(int) * n);
+    hier->node = ENGINE_MALLOC(sizeof(int) * n);
+    hier->depth = ENGINE_MALLOC(sizeof(Uint16) * n);
+    hier->local_x = ENGINE_MALLOC(sizeof(float) * n);
+    hier->local_y = ENGINE_MALLOC(sizeof(float) * n);
+    hier->local_angle = ENGINE_MALLOC(sizeof(float) * n);
+    hier->local_cos = ENGINE_MALLOC(sizeof(float) * n);
+    hier->local_sin = ENGINE_MALLOC(sizeof(float) * n);
+    hier->world_x = ENGINE_MALLOC(sizeof(float) * n);
+    hier->world_y = ENGINE_MALLOC(sizeof(float) * n);
+    hier->world_angle = ENGINE_MALLOC(sizeof(float) * n);
+    hier->world_cos = ENGINE_MALLOC(sizeof(float) * n);
+    hier->world_sin = ENGINE_MALLOC(sizeof(float) * n);
+    hier->sprite = ENGINE_MALLOC(sizeof(int) * n);
+    hier->dirty = ENGINE_CALLOC(n, sizeof(Uint8));
+    hier->slot_of = ENGINE_MALLOC(sizeof(int) * n);
+    hier->free_ids = ENGINE_MALLOC(sizeof(int) * n);
+    hier->changed = ENGINE_MALLOC(sizeof(int) * n);
+    hier->scratch = ENGINE_MALLOC(sizeof(int) * (n * 4 + 1));
+
+    if (!hier->parent || !hier->node || !hier->depth || !hier->local_x ||
+        !hier->local_y || !hier->local_angle || !hier->local_cos || !hier->local_sin ||
+        !hier->world_x || !hier->world_y || !hier->world_angle || !hier->world_cos ||
+        !hier->world_sin || !hier->sprite || !hier->dirty || !hier->slot_of ||
+        !hier->free_ids || !hier->changed || !hier->scratch) {
+        LOG_ERROR(LOG_CAT_GAME, "Failed to allocate transform hierarchy for %d nodes", capacity);
+        transform_cleanup(hier);
+        return false;
+    }
+
+    /* Hand out low ids first */
+    for (int i = 0; i < capacity; i++) {
+        hier->slot_of[i] = -1;
+        hier->free_ids[i] = capacity - 1 - i;
+    }
+    hier->free_count = capacity;
+    return true;
+}
+
+void transform_cleanup(transform_hierarchy_t *hier) {
+    ENGINE_FREE(hier->parent);
+    ENGINE_FREE(hier->node);
+    ENGINE_FREE(hier->depth);
+    ENGINE_FREE(hier->local_x);
+    ENGINE_FREE(hier->local_y);
+    ENGINE_FREE(hier->local_angle);
+    ENGINE_FREE(hier->local_cos);
+    ENGINE_FREE(hier->local_sin);
+    ENGINE_FREE(hier->world_x);
+    ENGINE_FREE(hier->world_y);
+    ENGINE_FREE(hier->world_angle);
+    ENGINE_FREE(hier->world_cos);
+    ENGINE_FREE(hier->world_sin);
+    ENGINE_FREE(hier->sprite);
+    ENGINE_FREE(hier->dirty);
+    ENGINE_FREE(hier->slot_of);
+    ENGINE_FREE(hier->free_ids);
+    ENGINE_FREE(hier->changed);
+    ENGINE_FREE(hier->scratch);
+    memset(hier, 0, sizeof(*hier));
+}
+
+/* ============================================================================
+ * STRUCTURE
+ * ============================================================================ */
+
+int transform_add(transform_hierarchy_t *hier, int parent,
+                  float x, float y, float angle) {
+    if (hier->free_count == 0 ||
+        (parent != TRANSFORM_NONE && !node_valid(hier, parent))) {
+        return TRANSFORM_NONE;
+    }
+
+    int node = hier->free_ids[--hier->free_count];
+    int slot = hier->count++;
+    hier->slot_of[node] = slot;
+    hier->node[slot] = node;
+
+    /* Appending keeps parents before children; only the depth order can break */
+    if (parent == TRANSFORM_NONE) {
+        hier->parent[slot] = -1;
+        hier->depth[slot] = 0;
+    } else {
+        int parent_slot = hier->slot_of[parent];
+        hier->parent[slot] = parent_slot;
+        hier->depth[slot] = (Uint16)(hier->depth[parent_slot] + 1);
+    }
+    if (slot > 0 && hier->depth[slot] < hier->depth[slot - 1]) {
+        hier->order_dirty = true;
+    }
+
+    double rad = angle * M_PI / 180.0;
+    hier->local_x[slot] = x;
+    hier->local_y[slot] = y;
+    hier->local_angle[slot] = angle;
+    hier->local_cos[slot] = (float)cos(rad);
+    hier->local_sin[slot] = (float)sin(rad);
+    hier->sprite[slot] = -1;
+    mark_dirty(hier, slot);
+    return node;
+}
+
+void transform_remove(transform_hierarchy_t *hier, int node) {
+    if (!node_valid(hier, node)) {
+        return;
+    }
+    if (hier->order_dirty) {
+        sort_by_depth(hier);
+    }
+
+    const int *inside = SCRATCH_REMAP(hier);
+    int *new_slot = SCRATCH_ORDER(hier);
+    int root = mark_subtree(hier, node);
+
+    /* Compact the survivors in place, keeping their order */
+    int write = root;
+    for (int s = root; s < hier->count; s++) {
+        if (inside[s]) {
+            int id = hier->node[s];
+            hier->slot_of[id] = -1;
+            hier->free_ids[hier->free_count++] = id;
+            continue;
+        }
+        new_slot[s] = write;
+        if (write != s) {
+            move_slot(hier, write, s);
+        }
+        int p = hier->parent[write];
+        if (p >= root) {
+            hier->parent[write] = new_slot[p];
+        }
+        hier->slot_of[hier->node[write]] = write;
+        write++;
+    }
+    hier->count = write;
+    hier->updated_last = 0;
+    find_dirty_first(hier);
+}
+
+bool transform_set_parent(transform_hierarchy_t *hier, int node, int parent) {
+    if (!node_valid(hier, node) ||
+        (parent != TRANSFORM_NONE && !node_valid(hier, parent))) {
+        return false;
+    }
+    if (hier->order_dirty) {
+        sort_by_depth(hier);
+    }
+
+    const int *inside = SCRATCH_REMAP(hier);
+    int root = mark_subtree(hier, node);
+    int parent_slot = parent == TRANSFORM_NONE ? -1 : hier->slot_of[parent];
+    if (parent_slot >= 0 && inside[parent_slot]) {
+        return false;  /* Would create a cycle */
+    }
+
+    int new_depth = parent_slot >= 0 ? hier->depth[parent_slot] + 1 : 0;
+    int shift = new_depth - hier->depth[root];
+    for (int s = root; s < hier->count; s++) {
+        if (inside[s]) {
+            hier->depth[s] = (Uint16)(hier->depth[s] + shift);
+        }
+    }
+    hier->parent[root] = parent_slot;
+    hier->order_dirty = true;
+    mark_dirty(hier, root);
+    return true;
+}
+
+/* ============================================================================
+ * TRANSFORMS
+ * ============================================================================ */
+
+void transform_set_local(transform_hierarchy_t *hier, int node,
+                         float x, float y, float angle) {
+    if (!node_valid(hier, node)) {
+        return;
+    }
+
+    int slot = hier->slot_of[node];
+    if (hier->local_x[slot] == x && hier->local_y[slot] == y &&
+        hier->local_angle[slot] == angle) {
+        return;
+    }
+
+    if (hier->local_angle[slot] != angle) {
+        double rad = angle * M_PI / 180.0;
+        hier->local_angle[slot] = angle;
+        hier->local_cos[slot] = (float)cos(rad);
+        hier->local_sin[slot] = (float)sin(rad);
+    }
+    hier->local_x[slot] = x;
+    hier->local_y[slot] = y;
+    mark_dirty(hier, slot);
+}
+
+void transform_bind_sprite(transform_hierarchy_t *hier, int node, int sprite_index) {
+    if (!node_valid(hier, node)) {
+        return;
+    }
+
+    /* Dirty so the sprite picks up the current transform on the next update */
+    int slot = hier->slot_of[node];
+    hier->sprite[slot] = sprite_index;
+    mark_dirty(hier, slot);
+}
+
+int transform_update(transform_hierarchy_t *hier) {
+    if (hier->order_dirty) {
+        sort_by_depth(hier);
+    }
+
+    int changed = 0;
+    const int *parent = hier->parent;
+    Uint8 *dirty = hier->dirty;
+
+    /* Parents come first, so a parent recomputed this pass is already
+     * flagged when its children are reached */
+    for (int s = hier->dirty_first; s < hier->count; s++) {
+        int p = parent[s];
+        if (!dirty[s]) {
+            if (p < 0 || !dirty[p]) {
+                continue;
+            }
+            dirty[s] = 1;
+        }
+
+        if (p < 0) {
+            hier->world_x[s] = hier->local_x[s];
+            hier->world_y[s] = hier->local_y[s];
+            hier->world_angle[s] = hier->local_angle[s];
+            hier->world_cos[s] = hier->local_cos[s];
+            hier->world_sin[s] = hier->local_sin[s];
+        } else {
+            float pc = hier->world_cos[p];
+            float ps = hier->world_sin[p];
+            float lx = hier->local_x[s];
+            float ly = hier->local_y[s];
+            float lc = hier->local_cos[s];
+            float ls = hier->local_sin[s];
+            hier->world_x[s] = hier->world_x[p] + lx * pc - ly * ps;
+            hier->world_y[s] = hier->world_y[p] + lx * ps + ly * pc;
+            hier->world_angle[s] = hier->world_angle[p] + hier->local_angle[s];
+            hier->world_cos[s] = pc * lc - ps * ls;
+            hier->world_sin[s] = ps * lc + pc * ls;
+        }
+        hier->changed[changed++] = s;
+    }
+
+    for (int i = 0; i < changed; i++) {
+        dirty[hier->changed[i]] = 0;
+    }
+    hier->dirty_first = hier->count;
+    hier->updated_last = changed;
+    return changed;
+}
+
+void transform_apply_sprites(const transform_hierarchy_t *hier, sprite_t *sprites) {
+    for (int i = 0; i < hier->updated_last; i++) {
+        int s = hier->changed[i];
+        int index = hier->sprite[s];
+        if (index < 0) {
+            continue;
+        }
+        sprite_t *spr = &sprites[index];
+        spr->x = hier->world_x[s] - spr->width * 0.5f;
+        spr->y = hier->world_y[s] - spr->height * 0.5f;
+        spr->angle = hier->world_angle[s];
+    }
+}
+
+void transform_get_world(const transform_hierarchy_t *hier, int node,
+                         float *x, float *y, float *angle) {
+    if (!node_valid(hier, node)) {
+        return;
+    }
+
+    int slot = hier->slot_of[node];
+    if (x) {
+        *x = hier->world_x[slot];
+    }
+    if (y) {
+        *y = hier->world_y[slot];
+    }
+    if (angle) {
+        *angle = hier->world_angle[slot];
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Knight Engine 2D - Transform Hierarchy
+ *
+ * Parent/child transforms (position plus rotation) so attached objects
+ * follow whatever they hang off without the game moving each one by hand.
+ *
+ * Nodes live in flat per-field arrays sorted by depth: roots first, then
+ * their children, then grandchildren, so every parent sits in a lower
+ * slot than its children. Setting a local transform only marks the node
+ * dirty; transform_update() walks the slots once from the lowest dirty
+ * one, recomputing a node when it or its parent changed this pass. A
+ * hierarchy where nothing moved costs nothing per frame.
+ *
+ * Callers hold stable node ids; slots are reshuffled when the hierarchy
+ * is restructured (reparenting or adding above the deepest level) and the
+ * depth sort is redone lazily on the next update.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "graphics/sprite.h"
+
+/* Parent id of root nodes / result of a failed add */
+#define TRANSFORM_NONE (-1)
+
+/*
+ * Transform hierarchy - structure of arrays indexed by slot
+ * Angles are in degrees, clockwise, like sprite_t.angle.
+ */
+typedef struct {
+    /* Per slot, depth-sorted */
+    int *parent;                /* Slot of the parent, -1 for roots */
+    int *node;                  /* Node id stored in the slot */
+    Uint16 *depth;              /* 0 for roots */
+    float *local_x, *local_y;   /* Offset from the parent, in the parent's frame */
+    float *local_angle;
+    float *local_cos, *local_sin;
+    float *world_x, *world_y;
+    float *world_angle;
+    float *world_cos, *world_sin;
+    int *sprite;                /* Sprite that follows the node, -1 = none */
+    Uint8 *dirty;               /* Local changed, or recomputed during this update */
+    /* Per node id */
+    int *slot_of;               /* -1 = unused id */
+    int *free_ids;
+    int free_count;
+    /* Update bookkeeping */
+    int *changed;               /* Slots recomputed by the last update */
+    int *scratch;               /* Depth sort / removal workspace */
+    int count;
+    int capacity;
+    int dirty_first;            /* Lowest dirty slot, count when clean */
+    bool order_dirty;           /* Depth order broken, re-sort on update */
+    /* Statistics */
+    int updated_last;           /* World transforms recomputed by the last update */
+} transform_hierarchy_t;
+
+/*
+ * Allocate room for capacity nodes
+ * Returns true on success, false on allocation failure.
+ */
+bool transform_init(transform_hierarchy_t *hier, int capacity);
+
+/*
+ * Free all storage
+ */
+void transform_cleanup(transform_hierarchy_t *hier);
+
+/*
+ * Add a node under parent (TRANSFORM_NONE for a root)
+ * The local transform is relative to the parent. The world transform is
+ * valid after the next transform_update().
+ * Returns the node id, or TRANSFORM_NONE if full or the parent is invalid.
+ */
+int transform_add(transform_hierarchy_t *hier, int parent,
+                  float x, float y, float angle);
+
+/*
+ * Remove a node together with everything attached below it
+ */
+void transform_remove(transform_hierarchy_t *hier, int node);
+
+/*
+ * Move a node (and its subtree) under a new parent, keeping its local transform
+ * Returns false if the parent is invalid or is inside the node's subtree.
+ */
+bool transform_set_parent(transform_hierarchy_t *hier, int node, int parent);
+
+/*
+ * Set a node's local transform
+ * Marks the node dirty only if a value actually changed.
+ */
+void transform_set_local(transform_hierarchy_t *hier, int node,
+                         float x, float y, float angle);
+
+/*
+ * Make a sprite follow a node (sprite_index -1 to detach)
+ * The node's world position becomes the sprite's center.
+ */
+void transform_bind_sprite(transform_hierarchy_t *hier, int node, int sprite_index);
+
+/*
+ * Recompute world transforms of dirty nodes and their descendants
+ * Returns the number of nodes recomputed (0 when nothing moved).
+ */
+int transform_update(transform_hierarchy_t *hier);
+
+/*
+ * Copy the world transforms recomputed by the last update into bound sprites
+ */
+void transform_apply_sprites(const transform_hierarchy_t *hier, sprite_t *sprites);
+
+/*
+ * World transform of a node as of the last transform_update()
+ * Any output pointer may be NULL.
+ */
+void transform_get_world(const transform_hierarchy_t *hier, int node,
+                         float *x, float *y, float *angle);
@@ -0,0 +1,397 @@
+/*
+ * Knight Engine 2D - Render Command Buffer Implementation
+ */
+
+#include "graphics/render_cmd.h"
+#include "util/alloc.h"
+#include "util/log.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RENDER_KEY_LAYER_SHIFT    56
+#define RENDER_KEY_DEPTH_SHIFT    40
+#define RENDER_KEY_MATERIAL_SHIFT RENDER_KEY_SEQUENCE_BITS
+
+bool render_cmd_buffer_init(render_cmd_buffer_t *buf, int capacity) {
+    if (capacity > (int)RENDER_KEY_SEQUENCE_MASK + 1) {
+        capacity = (int)RENDER_KEY_SEQUENCE_MASK + 1;
+    }
+
+    buf->cmds = ENGINE_MALLOC(sizeof(render_cmd_t) * (size_t)capacity);
+    buf->keys = ENGINE_MALLOC(sizeof(Uint64) * (size_t)capacity);
+    buf->scratch = ENGINE_MALLOC(sizeof(Uint64) * (size_t)capacity);
+    buf->capacity = capacity;
+    SDL_AtomicSet(&buf->count, 0);
+    SDL_AtomicSet(&buf->dropped, 0);
+    buf->sorted = false;
+
+    if (!buf->cmds || !buf->keys || !buf->scratch) {
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to allocate render command buffer (%d commands)",
+                  capacity);
+        render_cmd_buffer_cleanup(buf);
+        return false;
+    }
+
+    return true;
+}
+
+bool render_cmd_buffer_reserve(render_cmd_buffer_t *buf, int capacity) {
+    if (capacity > (int)RENDER_KEY_SEQUENCE_MASK + 1) {
+        capacity = (int)RENDER_KEY_SEQUENCE_MASK + 1;
+    }
+    if (capacity <= buf->capacity) {
+        return true;
+    }
+
+    /* Each array is swapped in as soon as it grows - a larger array is
+     * still valid if a later one fails */
+    render_cmd_t *cmds = ENGINE_REALLOC(buf->cmds, sizeof(render_cmd_t) * (size_t)capacity);
+    if (cmds) {
+        buf->cmds = cmds;
+    }
+    Uint64 *keys = ENGINE_REALLOC(buf->keys, sizeof(Uint64) * (size_t)capacity);
+    if (keys) {
+        buf->keys = keys;
+    }
+    Uint64 *scratch = ENGINE_REALLOC(buf->scratch, sizeof(Uint64) * (size_t)capacity);
+    if (scratch) {
+        buf->scratch = scratch;
+    }
+
+    if (!cmds || !keys || !scratch) {
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to grow render command buffer to %d commands",
+                  capacity);
+        return false;
+    }
+    buf->capacity = capacity;
+    return true;
+}
+
+void render_cmd_buffer_cleanup(render_cmd_buffer_t *buf) {
+    ENGINE_FREE(buf->cmds);
+    ENGINE_FREE(buf->keys);
+    ENGINE_FREE(buf->scratch);
+    buf->cmds = NULL;
+    buf->keys = NULL;
+    buf->scratch = NULL;
+    buf->capacity = 0;
+    SDL_AtomicSet(&buf->count, 0);
+}
+
+void render_cmd_reset(render_cmd_buffer_t *buf) {
+    SDL_AtomicSet(&buf->count, 0);
+    SDL_AtomicSet(&buf->dropped, 0);
+    buf->sorted = false;
+}
+
+Uint64 render_key(render_layer_t layer, int depth, Uint16 material) {
+    /* Bias signed depth into unsigned 16-bit range, clamping outliers */
+    int biased = depth + 32768;
+    if (biased < 0) {
+        biased = 0;
+    } else if (biased > 0xFFFF) {
+        biased = 0xFFFF;
+    }
+
+    return ((Uint64)layer << RENDER_KEY_LAYER_SHIFT) |
+           ((Uint64)biased << RENDER_KEY_DEPTH_SHIFT) |
+           ((Uint64)material << RENDER_KEY_MATERIAL_SHIFT);
+}
+
+Uint16 render_material_from_texture(const SDL_Texture *texture) {
+    if (!texture) {
+        return 0;
+    }
+
+    /* Fold the pointer down to 16 bits; collisions only cost a texture switch */
+    Uint64 p = (Uint64)(uintptr_t)texture >> 4;
+    Uint16 material = (Uint16)(p ^ (p >> 16) ^ (p >> 32));
+    return material ? material : 1;
+}
+
+bool render_cmd_push(render_cmd_buffer_t *buf, Uint64 key, const render_cmd_t *cmd) {
+    int slot = SDL_AtomicAdd(&buf->count, 1);
+    if (slot >= buf->capacity) {
+        SDL_AtomicAdd(&buf->dropped, 1);
+        return false;
+    }
+
+    buf->cmds[slot] = *cmd;
+    buf->keys[slot] = (key & ~RENDER_KEY_SEQUENCE_MASK) | (Uint64)slot;
+    return true;
+}
+
+bool render_cmd_clear(render_cmd_buffer_t *buf, Uint8 r, Uint8 g, Uint8 b) {
+    render_cmd_t cmd;
+    cmd.type = RENDER_CMD_CLEAR;
+    cmd.r = r;
+    cmd.g = g;
+    cmd.b = b;
+    cmd.a = 255;
+    return render_cmd_push(buf, render_key(RENDER_LAYER_CLEAR, 0, 0), &cmd);
+}
+
+bool render_cmd_quad(render_cmd_buffer_t *buf, Uint64 key, SDL_Texture *texture,
+                     const SDL_Rect *src, const SDL_Rect *dst,
+                     double angle, const SDL_Point *center, SDL_RendererFlip flip,
+                     Uint8 r, Uint8 g, Uint8 b) {
+    if (!texture) {
+        return false;
+    }
+
+    render_cmd_t cmd;
+    cmd.type = RENDER_CMD_QUAD;
+    cmd.r = r;
+    cmd.g = g;
+    cmd.b = b;
+    cmd.a = 255;
+    cmd.quad.texture = texture;
+    cmd.quad.has_src = src != NULL;
+    cmd.quad.has_dst = dst != NULL;
+    cmd.quad.has_center = center != NULL;
+    if (src) {
+        cmd.quad.src = *src;
+    }
+    if (dst) {
+        cmd.quad.dst = *dst;
+    }
+    if (center) {
+        cmd.quad.center = *center;
+    }
+    cmd.quad.angle = angle;
+    cmd.quad.flip = flip;
+    return render_cmd_push(buf, key, &cmd);
+}
+
+bool render_cmd_solid_quad(render_cmd_buffer_t *buf, Uint64 key, const SDL_Rect *dst,
+                           double angle, const SDL_Point *center,
+                           Uint8 r, Uint8 g, Uint8 b) {
+    render_cmd_t cmd;
+    cmd.type = RENDER_CMD_SOLID_QUAD;
+    cmd.r = r;
+    cmd.g = g;
+    cmd.b = b;
+    cmd.a = 255;
+    cmd.quad.texture = NULL;
+    cmd.quad.dst = *dst;
+    cmd.quad.has_src = false;
+    cmd.quad.has_dst = true;
+    cmd.quad.has_center = center != NULL;
+    if (center) {
+        cmd.quad.center = *center;
+    }
+    cmd.quad.angle = angle;
+    cmd.quad.flip = SDL_FLIP_NONE;
+    return render_cmd_push(buf, key, &cmd);
+}
+
+bool render_cmd_rect(render_cmd_buffer_t *buf, Uint64 key, const SDL_Rect *rect,
+                     bool filled, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    render_cmd_t cmd;
+    cmd.type = filled ? RENDER_CMD_FILL_RECT : RENDER_CMD_RECT;
+    cmd.r = r;
+    cmd.g = g;
+    cmd.b = b;
+    cmd.a = a;
+    cmd.rect = *rect;
+    return render_cmd_push(buf, key, &cmd);
+}
+
+bool render_cmd_line(render_cmd_buffer_t *buf, Uint64 key,
+                     int x1, int y1, int x2, int y2,
+                     Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    render_cmd_t cmd;
+    cmd.type = RENDER_CMD_LINE;
+    cmd.r = r;
+    cmd.g = g;
+    cmd.b = b;
+    cmd.a = a;
+    cmd.line.x1 = x1;
+    cmd.line.y1 = y1;
+    cmd.line.x2 = x2;
+    cmd.line.y2 = y2;
+    return render_cmd_push(buf, key, &cmd);
+}
+
+void render_cmd_sort(render_cmd_buffer_t *buf) {
+    int count = render_cmd_count(buf);
+    if (count <= 1) {
+        buf->sorted = true;
+        return;
+    }
+
+    /* Build all eight byte histograms in a single pass over the keys */
+    int histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+    for (int i = 0; i < count; i++) {
+        Uint64 key = buf->keys[i];
+        for (int pass = 0; pass < 8; pass++) {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    Uint64 *src = buf->keys;
+    Uint64 *dst = buf->scratch;
+
+    for (int pass = 0; pass < 8; pass++) {
+        int *hist = histograms[pass];
+        int shift = pass * 8;
+
+        /* Every key has the same byte here - this pass would be a no-op */
+        if (hist[(src[0] >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        /* Exclusive prefix sum gives each bucket's starting offset */
+        int offset = 0;
+        for (int i = 0; i < 256; i++) {
+            int n = hist[i];
+            hist[i] = offset;
+            offset += n;
+        }
+
+        for (int i = 0; i < count; i++) {
+            Uint64 key = src[i];
+            dst[hist[(key >> shift) & 0xFF]++] = key;
+        }
+
+        Uint64 *temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    /* Odd number of executed passes leaves the result in scratch */
+    if (src != buf->keys) {
+        memcpy(buf->keys, src, sizeof(Uint64) * (size_t)count);
+    }
+
+    buf->sorted = true;
+}
+
+int render_cmd_count(const render_cmd_buffer_t *buf) {
+    int count = SDL_AtomicGet((SDL_atomic_t *)&buf->count);
+    return count < buf->capacity ? count : buf->capacity;
+}
+
+const render_cmd_t *render_cmd_get(const render_cmd_buffer_t *buf, int i) {
+    return &buf->cmds[buf->keys[i] & RENDER_KEY_SEQUENCE_MASK];
+}
+
+/* FNV-1a, one 64-bit word at a time */
+static Uint64 hash_word(Uint64 hash, Uint64 word) {
+    return (hash ^ word) * 1099511628211ULL;
+}
+
+Uint64 render_cmd_hash(const render_cmd_buffer_t *buf) {
+    int count = render_cmd_count(buf);
+    Uint64 hash = hash_word(1469598103934665603ULL, (Uint64)count);
+
+    for (int i = 0; i < count; i++) {
+        const render_cmd_t *cmd = render_cmd_get(buf, i);
+        Uint64 color = ((Uint64)cmd->r << 24) | ((Uint64)cmd->g << 16) |
+                       ((Uint64)cmd->b << 8) | cmd->a;
+
+        /* Sequence bits only reflect recording order, which sorting already applied */
+        hash = hash_word(hash, buf->keys[i] & ~RENDER_KEY_SEQUENCE_MASK);
+        hash = hash_word(hash, ((Uint64)cmd->type << 32) | color);
+
+        switch (cmd->type) {
+            case RENDER_CMD_QUAD:
+            case RENDER_CMD_SOLID_QUAD: {
+                Uint64 angle_bits;
+                memcpy(&angle_bits, &cmd->quad.angle, sizeof(angle_bits));
+                hash = hash_word(hash, (Uint64)(uintptr_t)cmd->quad.texture);
+                hash = hash_word(hash, angle_bits);
+                hash = hash_word(hash, ((Uint64)cmd->quad.has_src << 2) |
+                                       ((Uint64)cmd->quad.has_dst << 1) |
+                                       (Uint64)cmd->quad.has_center |
+                                       ((Uint64)cmd->quad.flip << 8));
+                if (cmd->quad.has_src) {
+                    hash = hash_word(hash, ((Uint64)(Uint32)cmd->quad.src.x << 32) |
+                                           (Uint32)cmd->quad.src.y);
+                    hash = hash_word(hash, ((Uint64)(Uint32)cmd->quad.src.w << 32) |
+                                           (Uint32)cmd->quad.src.h);
+                }
+                if (cmd->quad.has_dst) {
+                    hash = hash_word(hash, ((Uint64)(Uint32)cmd->quad.dst.x << 32) |
+                                           (Uint32)cmd->quad.dst.y);
+                    hash = hash_word(hash, ((Uint64)(Uint32)cmd->quad.dst.w << 32) |
+                                           (Uint32)cmd->quad.dst.h);
+                }
+                if (cmd->quad.has_center) {
+                    hash = hash_word(hash, ((Uint64)(Uint32)cmd->quad.center.x << 32) |
+                                           (Uint32)cmd->quad.center.y);
+                }
+                break;
+            }
+            case RENDER_CMD_RECT:
+            case RENDER_CMD_FILL_RECT:
+                hash = hash_word(hash, ((Uint64)(Uint32)cmd->rect.x << 32) |
+                                       (Uint32)cmd->rect.y);
+                hash = hash_word(hash, ((Uint64)(Uint32)cmd->rect.w << 32) |
+                                       (Uint32)cmd->rect.h);
+                break;
+            case RENDER_CMD_LINE:
+                hash = hash_word(hash, ((Uint64)(Uint32)cmd->line.x1 << 32) |
+                                       (Uint32)cmd->line.y1);
+                hash = hash_word(hash, ((Uint64)(Uint32)cmd->line.x2 << 32) |
+                                       (Uint32)cmd->line.y2);
+                break;
+            case RENDER_CMD_CLEAR:
+                break;
+        }
+    }
+    return hash;
+}
+
+void render_cmd_dump(const render_cmd_buffer_t *buf) {
+    static const char *type_names[] = {
+        "CLEAR", "QUAD", "SOLID", "RECT", "FILL_RECT", "LINE"
+    };
+
+    int count = render_cmd_count(buf);
+    LOG_INFO(LOG_CAT_RENDER, "[RENDER] %d commands (%d dropped)%s", count,
+             SDL_AtomicGet((SDL_atomic_t *)&buf->dropped),
+             buf->sorted ? "" : " - unsorted");
+
+    for (int i = 0; i < count; i++) {
+        Uint64 key = buf->keys[i];
+        const render_cmd_t *cmd = render_cmd_get(buf, i);
+        char detail[96] = "";
+
+        switch (cmd->type) {
+            case RENDER_CMD_QUAD:
+                if (cmd->quad.has_dst) {
+                    snprintf(detail, sizeof(detail), " tex=%p dst=(%d,%d %dx%d) angle=%.1f",
+                             (void *)cmd->quad.texture,
+                             cmd->quad.dst.x, cmd->quad.dst.y,
+                             cmd->quad.dst.w, cmd->quad.dst.h, cmd->quad.angle);
+                } else {
+                    snprintf(detail, sizeof(detail), " tex=%p dst=full",
+                             (void *)cmd->quad.texture);
+                }
+                break;
+            case RENDER_CMD_SOLID_QUAD:
+                snprintf(detail, sizeof(detail), " dst=(%d,%d %dx%d) angle=%.1f",
+                         cmd->quad.dst.x, cmd->quad.dst.y,
+                         cmd->quad.dst.w, cmd->quad.dst.h, cmd->quad.angle);
+                break;
+            case RENDER_CMD_RECT:
+            case RENDER_CMD_FILL_RECT:
+                snprintf(detail, sizeof(detail), " rect=(%d,%d %dx%d)",
+                         cmd->rect.x, cmd->rect.y, cmd->rect.w, cmd->rect.h);
+                break;
+            case RENDER_CMD_LINE:
+                snprintf(detail, sizeof(detail), " (%d,%d)-(%d,%d)",
+                         cmd->line.x1, cmd->line.y1, cmd->line.x2, cmd->line.y2);
+                break;
+            case RENDER_CMD_CLEAR:
+                break;
+        }
+        LOG_INFO(LOG_CAT_RENDER, "  %4d key=%016llx %-9s rgba=(%3d,%3d,%3d,%3d)%s",
+                 i, (unsigned long long)key, type_names[cmd->type],
+                 cmd->r, cmd->g, cmd->b, cmd->a, detail);
+    }
+}
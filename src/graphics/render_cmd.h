@@ -0,0 +1,196 @@
+/*
+ * Knight Engine 2D - Render Command Buffer
+ *
+ * Records draw work as commands instead of calling SDL immediately.
+ * Each command carries a 64-bit sort key; the buffer is radix-sorted once
+ * per frame and then executed in key order by the renderer backend.
+ *
+ * Sort key layout (most significant bits first):
+ *   [63:56] layer     - clear, background, world, debug
+ *   [55:40] depth     - z_index biased to unsigned (lower draws first)
+ *   [39:24] material  - texture identity, groups equal-depth draws by texture
+ *   [23:0]  sequence  - slot index in the buffer, keeps the sort stable
+ *
+ * Recording is thread-safe: slots are reserved with an atomic counter, so
+ * several threads may push into the same buffer concurrently. Reset, sort
+ * and execute must happen on one thread once recording has finished.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+/* Sequence bits at the bottom of every key (also the max buffer capacity) */
+#define RENDER_KEY_SEQUENCE_BITS 24
+#define RENDER_KEY_SEQUENCE_MASK ((Uint64)((1u << RENDER_KEY_SEQUENCE_BITS) - 1))
+
+/*
+ * Render layers - coarse draw order, stored in the top byte of the key
+ */
+typedef enum {
+    RENDER_LAYER_CLEAR = 0,       /* Screen clear, always first */
+    RENDER_LAYER_BACKGROUND = 1,  /* Full-screen background images */
+    RENDER_LAYER_WORLD = 2,       /* Sprites, ordered by z_index */
+    RENDER_LAYER_DEBUG = 3        /* Debug shapes, drawn over the world */
+} render_layer_t;
+
+/*
+ * Command types understood by the backend
+ */
+typedef enum {
+    RENDER_CMD_CLEAR,      /* Fill the whole target with a color */
+    RENDER_CMD_QUAD,       /* Textured quad with optional rotation/flip/tint */
+    RENDER_CMD_SOLID_QUAD, /* Untextured colored quad with optional rotation */
+    RENDER_CMD_RECT,       /* Rectangle outline */
+    RENDER_CMD_FILL_RECT,  /* Filled rectangle */
+    RENDER_CMD_LINE        /* Single line segment */
+} render_cmd_type_t;
+
+/*
+ * A single recorded command. Coordinates are already in screen space.
+ */
+typedef struct {
+    render_cmd_type_t type;
+    Uint8 r, g, b, a;  /* Draw color, or color modulation for quads */
+    union {
+        struct {
+            SDL_Texture *texture;  /* NULL for solid quads */
+            SDL_Rect src;
+            SDL_Rect dst;
+            SDL_Point center;
+            bool has_src;     /* false = entire texture */
+            bool has_dst;     /* false = entire render target */
+            bool has_center;  /* false = rotate around the dst center */
+            double angle;     /* Degrees clockwise */
+            SDL_RendererFlip flip;
+        } quad;
+        SDL_Rect rect;
+        struct {
+            int x1, y1, x2, y2;
+        } line;
+    };
+} render_cmd_t;
+
+/*
+ * Command buffer - allocated at init, grown only between frames
+ */
+typedef struct render_cmd_buffer_t {
+    render_cmd_t *cmds;  /* Commands in recording order (indexed by sequence) */
+    Uint64 *keys;        /* Sort keys; sorted in place by render_cmd_sort */
+    Uint64 *scratch;     /* Ping-pong buffer for the radix sort */
+    int capacity;
+    SDL_atomic_t count;    /* Slots reserved this frame */
+    SDL_atomic_t dropped;  /* Pushes rejected because the buffer was full */
+    bool sorted;
+} render_cmd_buffer_t;
+
+/*
+ * Allocate a command buffer holding up to capacity commands
+ * Capacity is clamped to the sequence range of the sort key.
+ * Returns true on success, false on allocation failure.
+ */
+bool render_cmd_buffer_init(render_cmd_buffer_t *buf, int capacity);
+
+/*
+ * Grow the buffer to hold at least capacity commands (never shrinks)
+ * Only between frames, never while recording. Returns false on
+ * allocation failure, leaving the old capacity usable.
+ */
+bool render_cmd_buffer_reserve(render_cmd_buffer_t *buf, int capacity);
+
+/*
+ * Free the command buffer storage
+ */
+void render_cmd_buffer_cleanup(render_cmd_buffer_t *buf);
+
+/*
+ * Discard all recorded commands - call once at the start of each frame
+ */
+void render_cmd_reset(render_cmd_buffer_t *buf);
+
+/*
+ * Build a sort key (without sequence) from layer, depth and material
+ * depth is a signed z value; material is any 16-bit grouping id.
+ */
+Uint64 render_key(render_layer_t layer, int depth, Uint16 material);
+
+/*
+ * Derive a 16-bit material id from a texture pointer (0 = untextured)
+ */
+Uint16 render_material_from_texture(const SDL_Texture *texture);
+
+/*
+ * Record a command with the given key (sequence bits are filled in)
+ * Safe to call from multiple threads. Returns false if the buffer is full.
+ */
+bool render_cmd_push(render_cmd_buffer_t *buf, Uint64 key, const render_cmd_t *cmd);
+
+/*
+ * Record a full-target clear
+ */
+bool render_cmd_clear(render_cmd_buffer_t *buf, Uint8 r, Uint8 g, Uint8 b);
+
+/*
+ * Record a textured quad
+ * src/dst may be NULL for the whole texture / whole target, and center
+ * may be NULL to rotate around the middle of dst.
+ * r, g, b is color modulation (255 = no change).
+ */
+bool render_cmd_quad(render_cmd_buffer_t *buf, Uint64 key, SDL_Texture *texture,
+                     const SDL_Rect *src, const SDL_Rect *dst,
+                     double angle, const SDL_Point *center, SDL_RendererFlip flip,
+                     Uint8 r, Uint8 g, Uint8 b);
+
+/*
+ * Record an opaque untextured quad filled with one color
+ * center may be NULL to rotate around the middle of dst. Consecutive
+ * solid quads are drawn by the backend as one batch, so give them
+ * material 0 in the key to keep them together.
+ */
+bool render_cmd_solid_quad(render_cmd_buffer_t *buf, Uint64 key, const SDL_Rect *dst,
+                           double angle, const SDL_Point *center,
+                           Uint8 r, Uint8 g, Uint8 b);
+
+/*
+ * Record a rectangle, outlined or filled
+ */
+bool render_cmd_rect(render_cmd_buffer_t *buf, Uint64 key, const SDL_Rect *rect,
+                     bool filled, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+/*
+ * Record a line segment
+ */
+bool render_cmd_line(render_cmd_buffer_t *buf, Uint64 key,
+                     int x1, int y1, int x2, int y2,
+                     Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+/*
+ * Sort recorded commands by key (LSD radix sort, 8 bits per pass)
+ * Passes where every key shares the same byte are skipped.
+ */
+void render_cmd_sort(render_cmd_buffer_t *buf);
+
+/*
+ * Number of commands recorded this frame (excluding dropped pushes)
+ */
+int render_cmd_count(const render_cmd_buffer_t *buf);
+
+/*
+ * Get the i-th command in sorted order (valid after render_cmd_sort)
+ */
+const render_cmd_t *render_cmd_get(const render_cmd_buffer_t *buf, int i);
+
+/*
+ * Fingerprint of the sorted command list (valid after render_cmd_sort)
+ * Equal hashes mean the frame draws the same thing, so it need not be
+ * drawn again. Hashes fields, not raw bytes - commands have padding.
+ */
+Uint64 render_cmd_hash(const render_cmd_buffer_t *buf);
+
+/*
+ * Log the sorted command list for inspection, one LOG_INFO line per
+ * command - more lines than a log ring holds, so callers pause
+ * asynchronous logging around it (log_set_async)
+ */
+void render_cmd_dump(const render_cmd_buffer_t *buf);
@@ -0,0 +1,64 @@
+/*
+ * Knight Engine 2D - Dynamic Resolution Controller Implementation
+ */
+
+#include "graphics/render_scale.h"
+#include "core/config.h"
+#include <math.h>
+
+void render_scale_init(render_scale_t *rs, float min_scale, float max_scale,
+                       float target_ms) {
+    rs->scale = max_scale;
+    rs->min_scale = min_scale;
+    rs->max_scale = max_scale;
+    rs->target_ms = target_ms;
+    rs->smoothed_ms = target_ms;
+    rs->cooldown = DYNRES_COOLDOWN_FRAMES;
+}
+
+bool render_scale_update(render_scale_t *rs, float frame_ms) {
+    rs->smoothed_ms += (frame_ms - rs->smoothed_ms) * DYNRES_SMOOTHING;
+
+    if (rs->cooldown > 0) {
+        rs->cooldown--;
+        return false;
+    }
+
+    float new_scale = rs->scale;
+    float quantum = 1.0f / DYNRES_QUANTUM;
+
+    if (rs->smoothed_ms > rs->target_ms) {
+        /* Fill cost scales with area, so shrink by the square root of the overrun */
+        float factor = sqrtf(rs->target_ms / rs->smoothed_ms);
+        if (factor < 1.0f - DYNRES_MAX_STEP) {
+            factor = 1.0f - DYNRES_MAX_STEP;
+        }
+        /* Quantize so tiny corrections don't resize the target every frame */
+        new_scale = floorf(rs->scale * factor * DYNRES_QUANTUM) / DYNRES_QUANTUM;
+        if (new_scale > rs->scale - quantum) {
+            new_scale = rs->scale - quantum;
+        }
+    } else if (rs->smoothed_ms < rs->target_ms * DYNRES_HEADROOM) {
+        /* Grow one step at a time - overshooting would just bounce us back down */
+        new_scale = rs->scale + quantum;
+    }
+
+    if (new_scale < rs->min_scale) {
+        new_scale = rs->min_scale;
+    }
+    if (new_scale > rs->max_scale) {
+        new_scale = rs->max_scale;
+    }
+
+    if (new_scale == rs->scale) {
+        return false;
+    }
+
+    rs->scale = new_scale;
+    rs->cooldown = DYNRES_COOLDOWN_FRAMES;
+    return true;
+}
+
+float render_scale_get(const render_scale_t *rs) {
+    return rs->scale;
+}
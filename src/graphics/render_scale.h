@@ -0,0 +1,44 @@
+/*
+ * Knight Engine 2D - Dynamic Resolution Controller
+ *
+ * Picks the resolution scale of the offscreen scene target from recent
+ * frame times. When frames run over the target the scale drops quickly;
+ * when there is steady headroom it creeps back up.
+ *
+ * Oscillation is avoided with an exponential moving average of the frame
+ * time, a dead band between the "too slow" and "fast enough" thresholds,
+ * and a cooldown after every change so the average can settle.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/*
+ * Controller state
+ */
+typedef struct {
+    float scale;        /* Current scale (fraction of window width/height) */
+    float min_scale;
+    float max_scale;
+    float target_ms;    /* Frame time the controller aims for */
+    float smoothed_ms;  /* Exponential moving average of measured frame time */
+    int cooldown;       /* Frames left before the next adjustment */
+} render_scale_t;
+
+/*
+ * Initialize the controller at max_scale
+ */
+void render_scale_init(render_scale_t *rs, float min_scale, float max_scale,
+                       float target_ms);
+
+/*
+ * Feed one frame's measured time (milliseconds)
+ * Returns true if the scale changed this frame.
+ */
+bool render_scale_update(render_scale_t *rs, float frame_ms);
+
+/*
+ * Get the current scale
+ */
+float render_scale_get(const render_scale_t *rs);
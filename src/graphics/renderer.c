@@ -3,25 +3,453 @@
  */
 
 #include "graphics/renderer.h"
+#include "core/config.h"
+#include "util/alloc.h"
+#include "util/log.h"
 #include <SDL2/SDL_image.h>
-#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
-bool renderer_init(renderer_t *rend, const char *title, int width, int height) {
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* ============================================================================
+ * COUNTING WRAPPERS
+ *
+ * Every SDL render call made by the renderer goes through these, so the
+ * statistics cover the whole frame. Redundant draw color changes are
+ * skipped as well as counted.
+ * ============================================================================ */
+
+/* Pixels covered at the current scene scale */
+static Uint64 scaled_area(const renderer_t *rend, int w, int h) {
+    float scale = rend->scene_target ? rend->scale : 1.0f;
+    return (Uint64)((float)abs(w) * (float)abs(h) * scale * scale);
+}
+
+static void rs_set_draw_color(renderer_t *rend, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    Uint32 color = ((Uint32)r << 24) | ((Uint32)g << 16) | ((Uint32)b << 8) | a;
+    if (rend->draw_color_known && rend->draw_color == color) {
+        return;
+    }
+    SDL_SetRenderDrawColor(rend->renderer, r, g, b, a);
+    rend->draw_color = color;
+    rend->draw_color_known = true;
+    rend->frame.color_changes++;
+}
+
+static void rs_set_color_mod(renderer_t *rend, SDL_Texture *texture, Uint8 r, Uint8 g, Uint8 b) {
+    SDL_SetTextureColorMod(texture, r, g, b);
+    rend->frame.color_changes++;
+}
+
+static void rs_set_target(renderer_t *rend, SDL_Texture *target) {
+    SDL_SetRenderTarget(rend->renderer, target);
+    rend->frame.state_changes++;
+}
+
+static void rs_set_draw_blend(renderer_t *rend, SDL_BlendMode mode) {
+    SDL_SetRenderDrawBlendMode(rend->renderer, mode);
+    rend->frame.state_changes++;
+}
+
+static void rs_set_scale(renderer_t *rend, float scale) {
+    SDL_RenderSetScale(rend->renderer, scale, scale);
+    rend->frame.state_changes++;
+}
+
+/*
+ * Keep drawing inside the scaled scene region - the part present upscales
+ * Viewport and clip are in logical units, so the full logical size maps to
+ * width * scale by height * scale pixels of the scene target.
+ */
+static void rs_set_scene_region(renderer_t *rend) {
+    SDL_Rect region = { 0, 0, rend->width, rend->height };
+    SDL_RenderSetViewport(rend->renderer, &region);
+    SDL_RenderSetClipRect(rend->renderer, &region);
+    rend->frame.state_changes += 2;
+}
+
+static void rs_count_copy(renderer_t *rend, SDL_Texture *texture, const SDL_Rect *dst) {
+    renderer_stats_t *stats = &rend->frame;
+    stats->draw_calls++;
+    stats->vertices += 4;
+    if (texture != rend->bound_texture) {
+        stats->texture_binds++;
+        rend->bound_texture = texture;
+    }
+    stats->pixels += dst ? scaled_area(rend, dst->w, dst->h)
+                         : scaled_area(rend, rend->width, rend->height);
+}
+
+static void rs_copy(renderer_t *rend, SDL_Texture *texture,
+                    const SDL_Rect *src, const SDL_Rect *dst) {
+    SDL_RenderCopy(rend->renderer, texture, src, dst);
+    rs_count_copy(rend, texture, dst);
+}
+
+static void rs_copy_ex(renderer_t *rend, SDL_Texture *texture,
+                       const SDL_Rect *src, const SDL_Rect *dst, double angle,
+                       const SDL_Point *center, SDL_RendererFlip flip) {
+    SDL_RenderCopyEx(rend->renderer, texture, src, dst, angle, center, flip);
+    rs_count_copy(rend, texture, dst);
+}
+
+static void rs_fill_rect(renderer_t *rend, const SDL_Rect *rect) {
+    SDL_RenderFillRect(rend->renderer, rect);
+    rend->frame.draw_calls++;
+    rend->frame.vertices += 4;
+    rend->frame.pixels += scaled_area(rend, rect->w, rect->h);
+}
+
+static void rs_draw_rect(renderer_t *rend, const SDL_Rect *rect) {
+    SDL_RenderDrawRect(rend->renderer, rect);
+    rend->frame.draw_calls++;
+    rend->frame.vertices += 5;
+    rend->frame.pixels += scaled_area(rend, 2 * (rect->w + rect->h), 1);
+}
+
+static void rs_draw_line(renderer_t *rend, int x1, int y1, int x2, int y2) {
+    SDL_RenderDrawLine(rend->renderer, x1, y1, x2, y2);
+    int dx = abs(x2 - x1);
+    int dy = abs(y2 - y1);
+    rend->frame.draw_calls++;
+    rend->frame.vertices += 2;
+    rend->frame.pixels += scaled_area(rend, (dx > dy ? dx : dy) + 1, 1);
+}
+
+static void rs_clear(renderer_t *rend) {
+    if (rend->scene_target) {
+        /* SDL_RenderClear ignores the clip and would wipe the whole target */
+        SDL_Rect region = { 0, 0, rend->width, rend->height };
+        SDL_RenderFillRect(rend->renderer, &region);
+    } else {
+        SDL_RenderClear(rend->renderer);
+    }
+    rend->frame.draw_calls++;
+    rend->frame.pixels += scaled_area(rend, rend->width, rend->height);
+}
+
+/* ============================================================================
+ * SOLID QUAD BATCH
+ * ============================================================================ */
+
+#if RENDERER_HAVE_GEOMETRY
+
+static bool solid_batch_init(renderer_t *rend) {
+    rend->solid_verts = ENGINE_MALLOC(sizeof(SDL_Vertex) * 4 * RENDER_SOLID_BATCH_QUADS);
+    rend->solid_indices = ENGINE_MALLOC(sizeof(int) * 6 * RENDER_SOLID_BATCH_QUADS);
+    if (!rend->solid_verts || !rend->solid_indices) {
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to allocate solid quad batch");
+        return false;
+    }
+
+    /* Quad corners are stored clockwise: two triangles 0-1-2 and 0-2-3 */
+    for (int q = 0; q < RENDER_SOLID_BATCH_QUADS; q++) {
+        int *idx = &rend->solid_indices[q * 6];
+        int base = q * 4;
+        idx[0] = base;
+        idx[1] = base + 1;
+        idx[2] = base + 2;
+        idx[3] = base;
+        idx[4] = base + 2;
+        idx[5] = base + 3;
+    }
+    return true;
+}
+
+static void solid_batch_cleanup(renderer_t *rend) {
+    ENGINE_FREE(rend->solid_verts);
+    ENGINE_FREE(rend->solid_indices);
+    rend->solid_verts = NULL;
+    rend->solid_indices = NULL;
+}
+
+static void solid_flush(renderer_t *rend) {
+    if (rend->solid_count == 0) {
+        return;
+    }
+    SDL_RenderGeometry(rend->renderer, NULL, rend->solid_verts, rend->solid_count * 4,
+                       rend->solid_indices, rend->solid_count * 6);
+    rend->frame.draw_calls++;
+    rend->frame.vertices += (Uint32)rend->solid_count * 4;
+    rend->solid_count = 0;
+}
+
+static void solid_push(renderer_t *rend, const render_cmd_t *cmd) {
+    int batch_quads = rend->batch_solids ? rend->batch_quads : 1;
+    if (rend->solid_count >= batch_quads) {
+        solid_flush(rend);
+    }
+
+    const SDL_Rect *dst = &cmd->quad.dst;
+    float cx = cmd->quad.has_center ? (float)cmd->quad.center.x : dst->w * 0.5f;
+    float cy = cmd->quad.has_center ? (float)cmd->quad.center.y : dst->h * 0.5f;
+    float px = dst->x + cx;
+    float py = dst->y + cy;
+
+    /* Corners relative to the pivot, clockwise from top-left */
+    float corners[4][2] = {
+        { -cx, -cy },
+        { dst->w - cx, -cy },
+        { dst->w - cx, dst->h - cy },
+        { -cx, dst->h - cy }
+    };
+
+    /* Clockwise in screen space (y down), like SDL_RenderCopyEx */
+    float c = 1.0f;
+    float s = 0.0f;
+    if (cmd->quad.angle != 0.0) {
+        float rad = (float)(cmd->quad.angle * M_PI / 180.0);
+        c = cosf(rad);
+        s = sinf(rad);
+    }
+
+    SDL_Vertex *v = &rend->solid_verts[rend->solid_count * 4];
+    SDL_Color color = { cmd->r, cmd->g, cmd->b, 255 };
+    for (int i = 0; i < 4; i++) {
+        v[i].position.x = px + corners[i][0] * c - corners[i][1] * s;
+        v[i].position.y = py + corners[i][0] * s + corners[i][1] * c;
+        v[i].color = color;
+        v[i].tex_coord.x = 0.0f;
+        v[i].tex_coord.y = 0.0f;
+    }
+    rend->solid_count++;
+    rend->frame.pixels += scaled_area(rend, dst->w, dst->h);
+}
+
+#else
+
+static bool solid_batch_init(renderer_t *rend) {
+    (void)rend;
+    return true;
+}
+
+static void solid_batch_cleanup(renderer_t *rend) {
+    (void)rend;
+}
+
+static void solid_flush(renderer_t *rend) {
+    (void)rend;
+}
+
+/* No geometry API - one filled rectangle per quad, rotation ignored */
+static void solid_push(renderer_t *rend, const render_cmd_t *cmd) {
+    rs_set_draw_color(rend, cmd->r, cmd->g, cmd->b, 255);
+    rs_fill_rect(rend, &cmd->quad.dst);
+}
+
+#endif
+
+/* ============================================================================
+ * ROTATION CACHE
+ * ============================================================================ */
+
+static renderer_rotation_t *rotation_find(renderer_t *rend, SDL_Texture *texture) {
+    for (int i = 0; i < rend->rotation_count; i++) {
+        if (rend->rotations[i].source == texture) {
+            return &rend->rotations[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Draw every frame of a rotation entry into its page
+ * Runs outside the frame, so the calls bypass the counting wrappers.
+ */
+static void rotation_render_frames(renderer_t *rend, const renderer_rotation_t *rot) {
+    SDL_Renderer *sdl = rend->renderer;
+    SDL_Texture *previous = SDL_GetRenderTarget(sdl);
+    SDL_BlendMode source_blend;
+    SDL_GetTextureBlendMode(rot->source, &source_blend);
+
+    SDL_SetRenderTarget(sdl, rot->page);
+    SDL_SetRenderDrawColor(sdl, 0, 0, 0, 0);
+    SDL_RenderClear(sdl);
+
+    /* Blend onto the transparent page so the rotated corners stay clear */
+    SDL_SetTextureBlendMode(rot->source, SDL_BLENDMODE_BLEND);
+    for (int k = 0; k < rot->frames; k++) {
+        SDL_Rect dst = {
+            (k % rot->columns) * rot->cell + (rot->cell - rot->width) / 2,
+            (k / rot->columns) * rot->cell + (rot->cell - rot->height) / 2,
+            rot->width,
+            rot->height
+        };
+        SDL_RenderCopyEx(sdl, rot->source, NULL, &dst, k * 360.0 / rot->frames,
+                         NULL, SDL_FLIP_NONE);
+    }
+    SDL_SetTextureBlendMode(rot->source, source_blend);
+
+    SDL_SetRenderTarget(sdl, previous);
+    rend->draw_color_known = false;
+}
+
+/*
+ * Draw a rotated quad from its texture's pre-rotated frames
+ * Returns false when the quad doesn't qualify and must be drawn normally.
+ */
+static bool rotation_copy(renderer_t *rend, const render_cmd_t *cmd) {
+    if (rend->rotation_count == 0 || cmd->quad.flip != SDL_FLIP_NONE ||
+        cmd->quad.has_src || !cmd->quad.has_dst) {
+        return false;
+    }
+    renderer_rotation_t *rot = rotation_find(rend, cmd->quad.texture);
+    const SDL_Rect *dst = &cmd->quad.dst;
+    /* Frames only scale uniformly - a stretched quad would skew them */
+    if (!rot || dst->w <= 0 || dst->h <= 0 ||
+        (Sint64)dst->w * rot->height != (Sint64)dst->h * rot->width) {
+        return false;
+    }
+
+    double angle = fmod(cmd->quad.angle, 360.0);
+    if (angle < 0.0) {
+        angle += 360.0;
+    }
+    int frame = (int)(angle * rot->frames / 360.0 + 0.5) % rot->frames;
+    SDL_Rect src = {
+        (frame % rot->columns) * rot->cell,
+        (frame / rot->columns) * rot->cell,
+        rot->cell,
+        rot->cell
+    };
+
+    /* The quad's center turns about the pivot by the exact angle */
+    float cx = cmd->quad.has_center ? (float)cmd->quad.center.x : dst->w * 0.5f;
+    float cy = cmd->quad.has_center ? (float)cmd->quad.center.y : dst->h * 0.5f;
+    float mx = dst->w * 0.5f - cx;
+    float my = dst->h * 0.5f - cy;
+    float rad = (float)(cmd->quad.angle * M_PI / 180.0);
+    float c = cosf(rad);
+    float s = sinf(rad);
+    float center_x = dst->x + cx + mx * c - my * s;
+    float center_y = dst->y + cy + mx * s + my * c;
+
+    float size = rot->cell * (float)dst->w / (float)rot->width;
+    SDL_Rect out = {
+        (int)floorf(center_x - size * 0.5f + 0.5f),
+        (int)floorf(center_y - size * 0.5f + 0.5f),
+        (int)(size + 0.5f),
+        (int)(size + 0.5f)
+    };
+
+    bool tinted = cmd->r != 255 || cmd->g != 255 || cmd->b != 255;
+    if (tinted) {
+        rs_set_color_mod(rend, rot->page, cmd->r, cmd->g, cmd->b);
+    }
+    rs_copy(rend, rot->page, &src, &out);
+    if (tinted) {
+        rs_set_color_mod(rend, rot->page, 255, 255, 255);
+    }
+    rend->frame.rotations_cached++;
+    return true;
+}
+
+bool renderer_cache_rotations(renderer_t *rend, SDL_Texture *texture, int frames) {
+    if (frames <= 0) {
+        frames = RENDER_ROT_CACHE_FRAMES;
+    }
+    if (!texture || rotation_find(rend, texture)) {
+        return texture != NULL;
+    }
+    if (!SDL_RenderTargetSupported(rend->renderer)) {
+        LOG_ERROR(LOG_CAT_RENDER, "Rotation cache needs render targets");
+        return false;
+    }
+    if (rend->rotation_count >= RENDER_ROT_CACHE_MAX_TEXTURES) {
+        LOG_ERROR(LOG_CAT_RENDER,
+                  "Rotation cache full (%d textures)", RENDER_ROT_CACHE_MAX_TEXTURES);
+        return false;
+    }
+
+    renderer_rotation_t rot = { 0 };
+    rot.source = texture;
+    rot.frames = frames;
+    if (SDL_QueryTexture(texture, NULL, NULL, &rot.width, &rot.height) != 0) {
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to query texture for rotation cache: %s", SDL_GetError());
+        return false;
+    }
+
+    /* Square cells as wide as the diagonal fit the texture at any angle */
+    rot.cell = (int)ceil(sqrt((double)rot.width * rot.width + (double)rot.height * rot.height));
+    rot.columns = (int)ceil(sqrt((double)frames));
+    int rows = (frames + rot.columns - 1) / rot.columns;
+    int page_w = rot.columns * rot.cell;
+    int page_h = rows * rot.cell;
+    rot.bytes = (size_t)page_w * (size_t)page_h * 4;
+
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(rend->renderer, &info) == 0 &&
+        ((info.max_texture_width && page_w > info.max_texture_width) ||
+         (info.max_texture_height && page_h > info.max_texture_height))) {
+        LOG_ERROR(LOG_CAT_RENDER, "Rotation cache page %dx%d exceeds the renderer's texture size",
+                  page_w, page_h);
+        return false;
+    }
+    if (rend->rotation_bytes + rot.bytes > RENDER_ROT_CACHE_MAX_BYTES) {
+        LOG_ERROR(LOG_CAT_RENDER, "Rotation cache over budget: %lu KB needed, %lu of %lu KB used",
+                  (unsigned long)(rot.bytes / 1024), (unsigned long)(rend->rotation_bytes / 1024),
+                  (unsigned long)(RENDER_ROT_CACHE_MAX_BYTES / 1024));
+        return false;
+    }
+
+    rot.page = SDL_CreateTexture(rend->renderer, SDL_PIXELFORMAT_ARGB8888,
+                                 SDL_TEXTUREACCESS_TARGET, page_w, page_h);
+    if (!rot.page) {
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to create rotation cache page: %s", SDL_GetError());
+        return false;
+    }
+    SDL_SetTextureBlendMode(rot.page, SDL_BLENDMODE_BLEND);
+    rotation_render_frames(rend, &rot);
+
+    rend->rotations[rend->rotation_count++] = rot;
+    rend->rotation_bytes += rot.bytes;
+    return true;
+}
+
+void renderer_uncache_rotations(renderer_t *rend, SDL_Texture *texture) {
+    renderer_rotation_t *rot = rotation_find(rend, texture);
+    if (!rot) {
+        return;
+    }
+    SDL_DestroyTexture(rot->page);
+    rend->rotation_bytes -= rot->bytes;
+    *rot = rend->rotations[--rend->rotation_count];
+}
+
+size_t renderer_rotation_cache_bytes(const renderer_t *rend) {
+    return rend->rotation_bytes;
+}
+
+/* ============================================================================
+ * LIFETIME
+ * ============================================================================ */
+
+static void renderer_reset_fields(renderer_t *rend, int width, int height) {
+    memset(rend, 0, sizeof(*rend));
     rend->width = width;
     rend->height = height;
-    rend->window = NULL;
-    rend->renderer = NULL;
+    rend->scale = 1.0f;
+    rend->batch_solids = true;
+    rend->batch_quads = RENDER_SOLID_BATCH_QUADS;
+}
+
+bool renderer_init(renderer_t *rend, const char *title, int width, int height) {
+    renderer_reset_fields(rend, width, height);
 
     /* Initialize SDL video subsystem */
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError());
+        LOG_ERROR(LOG_CAT_RENDER, "SDL_Init failed: %s", SDL_GetError());
         return false;
     }
 
     /* Initialize SDL_image for PNG loading */
     int img_flags = IMG_INIT_PNG;
     if ((IMG_Init(img_flags) & img_flags) != img_flags) {
-        fprintf(stderr, "SDL_image init warning: %s\n", IMG_GetError());
+        LOG_WARN(LOG_CAT_RENDER, "SDL_image init warning: %s", IMG_GetError());
         /* Continue anyway - can fall back to programmatic sprites */
     }
 
@@ -36,7 +464,7 @@ bool renderer_init(renderer_t *rend, const char *title, int width, int height) {
     );
 
     if (!rend->window) {
-        fprintf(stderr, "Window creation failed: %s\n", SDL_GetError());
+        LOG_ERROR(LOG_CAT_RENDER, "Window creation failed: %s", SDL_GetError());
         return false;
     }
 
@@ -48,14 +476,65 @@ bool renderer_init(renderer_t *rend, const char *title, int width, int height) {
     );
 
     if (!rend->renderer) {
-        fprintf(stderr, "Renderer creation failed: %s\n", SDL_GetError());
+        LOG_ERROR(LOG_CAT_RENDER, "Renderer creation failed: %s", SDL_GetError());
         return false;
     }
 
+    SDL_RendererInfo info;
+    rend->vsync = SDL_GetRendererInfo(rend->renderer, &info) == 0 &&
+                  (info.flags & SDL_RENDERER_PRESENTVSYNC);
+
+    if (!solid_batch_init(rend)) {
+        return false;
+    }
+
+    /* Offscreen target for dynamic resolution - optional */
+    if (SDL_RenderTargetSupported(rend->renderer)) {
+        rend->scene_target = SDL_CreateTexture(rend->renderer,
+                                               SDL_PIXELFORMAT_RGBA8888,
+                                               SDL_TEXTUREACCESS_TARGET,
+                                               width, height);
+    }
+    if (rend->scene_target) {
+#if SDL_VERSION_ATLEAST(2, 0, 12)
+        SDL_SetTextureScaleMode(rend->scene_target, SDL_ScaleModeLinear);
+#endif
+    } else {
+        LOG_INFO(LOG_CAT_RENDER, "Render targets unavailable - dynamic resolution disabled");
+    }
+
     return true;
 }
 
+bool renderer_init_headless(renderer_t *rend, int width, int height) {
+    renderer_reset_fields(rend, width, height);
+
+    rend->surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32,
+                                                   SDL_PIXELFORMAT_RGBA8888);
+    if (!rend->surface) {
+        LOG_ERROR(LOG_CAT_RENDER, "Headless surface creation failed: %s", SDL_GetError());
+        return false;
+    }
+
+    rend->renderer = SDL_CreateSoftwareRenderer(rend->surface);
+    if (!rend->renderer) {
+        LOG_ERROR(LOG_CAT_RENDER, "Software renderer creation failed: %s", SDL_GetError());
+        SDL_FreeSurface(rend->surface);
+        rend->surface = NULL;
+        return false;
+    }
+    return solid_batch_init(rend);
+}
+
 void renderer_cleanup(renderer_t *rend) {
+    solid_batch_cleanup(rend);
+    while (rend->rotation_count > 0) {
+        renderer_uncache_rotations(rend, rend->rotations[0].source);
+    }
+    if (rend->scene_target) {
+        SDL_DestroyTexture(rend->scene_target);
+        rend->scene_target = NULL;
+    }
     if (rend->renderer) {
         SDL_DestroyRenderer(rend->renderer);
         rend->renderer = NULL;
@@ -64,24 +543,242 @@ void renderer_cleanup(renderer_t *rend) {
         SDL_DestroyWindow(rend->window);
         rend->window = NULL;
     }
+    if (rend->surface) {
+        SDL_FreeSurface(rend->surface);
+        rend->surface = NULL;
+    }
 
     IMG_Quit();
     SDL_Quit();
 }
 
+/* ============================================================================
+ * FRAME
+ * ============================================================================ */
+
 void renderer_clear(renderer_t *rend, Uint8 r, Uint8 g, Uint8 b) {
-    SDL_SetRenderDrawColor(rend->renderer, r, g, b, 255);
-    SDL_RenderClear(rend->renderer);
+    rs_set_draw_color(rend, r, g, b, 255);
+    rs_clear(rend);
+}
+
+/*
+ * True when a command overwrites the whole target with no blending,
+ * making a clear right before it redundant
+ */
+static bool covers_target_opaquely(const renderer_t *rend, const render_cmd_t *cmd) {
+    SDL_BlendMode mode;
+    if (cmd->type != RENDER_CMD_QUAD) {
+        return false;
+    }
+    const SDL_Rect *dst = &cmd->quad.dst;
+    bool full = !cmd->quad.has_dst ||
+                (dst->x <= 0 && dst->y <= 0 &&
+                 dst->x + dst->w >= rend->width && dst->y + dst->h >= rend->height);
+    return full && cmd->quad.angle == 0.0 &&
+           SDL_GetTextureBlendMode(cmd->quad.texture, &mode) == 0 &&
+           mode == SDL_BLENDMODE_NONE;
+}
+
+/*
+ * Overdraw heatmap: every fill adds OVERDRAW_HEAT to a black target, so
+ * brightness counts how many times each pixel was written. Textured quads
+ * count their whole rectangle, transparent texels included, since those
+ * are shaded too. Debug outlines and lines are left out.
+ */
+static const SDL_Color OVERDRAW_HEAT = { 32, 16, 4, 255 };
+
+static void renderer_execute_overdraw(renderer_t *rend, const render_cmd_buffer_t *cmds,
+                                      int count) {
+    rs_set_draw_color(rend, 0, 0, 0, 255);
+    rs_clear(rend);
+    rs_set_draw_blend(rend, SDL_BLENDMODE_ADD);
+
+    SDL_Rect full = { 0, 0, rend->width, rend->height };
+    for (int i = 0; i < count; i++) {
+        const render_cmd_t *cmd = render_cmd_get(cmds, i);
+        render_cmd_t heat = *cmd;
+        heat.r = OVERDRAW_HEAT.r;
+        heat.g = OVERDRAW_HEAT.g;
+        heat.b = OVERDRAW_HEAT.b;
+
+        switch (cmd->type) {
+            case RENDER_CMD_QUAD:
+            case RENDER_CMD_SOLID_QUAD:
+                if (!heat.quad.has_dst) {
+                    heat.quad.dst = full;
+                }
+                solid_push(rend, &heat);
+                break;
+
+            case RENDER_CMD_CLEAR:
+            case RENDER_CMD_FILL_RECT:
+                solid_flush(rend);
+                rs_set_draw_color(rend, heat.r, heat.g, heat.b, 255);
+                rs_fill_rect(rend, cmd->type == RENDER_CMD_CLEAR ? &full : &cmd->rect);
+                break;
+
+            case RENDER_CMD_RECT:
+            case RENDER_CMD_LINE:
+                break;
+        }
+    }
+    solid_flush(rend);
+    rs_set_draw_blend(rend, SDL_BLENDMODE_NONE);
+}
+
+void renderer_execute(renderer_t *rend, const render_cmd_buffer_t *cmds) {
+    int count = render_cmd_count(cmds);
+
+    /* Scale must be set after the target - switching targets resets it */
+    if (rend->scene_target) {
+        rs_set_target(rend, rend->scene_target);
+        rs_set_scale(rend, rend->scale);
+        rs_set_scene_region(rend);
+    }
+
+    if (rend->overdraw_view) {
+        renderer_execute_overdraw(rend, cmds, count);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const render_cmd_t *cmd = render_cmd_get(cmds, i);
+
+        /* A run of solid quads ends here - draw it before anything else */
+        if (cmd->type != RENDER_CMD_SOLID_QUAD) {
+            solid_flush(rend);
+        }
+
+        switch (cmd->type) {
+            case RENDER_CMD_CLEAR:
+                /* An opaque full-target layer comes next and hides the clear */
+                if (i + 1 < count && covers_target_opaquely(rend, render_cmd_get(cmds, i + 1))) {
+                    rend->frame.clears_skipped++;
+                    break;
+                }
+                renderer_clear(rend, cmd->r, cmd->g, cmd->b);
+                break;
+
+            case RENDER_CMD_QUAD: {
+                const SDL_Rect *src = cmd->quad.has_src ? &cmd->quad.src : NULL;
+                const SDL_Rect *dst = cmd->quad.has_dst ? &cmd->quad.dst : NULL;
+                const SDL_Point *center = cmd->quad.has_center ? &cmd->quad.center : NULL;
+                bool tinted = cmd->r != 255 || cmd->g != 255 || cmd->b != 255;
+
+                if (cmd->quad.angle != 0.0 && rotation_copy(rend, cmd)) {
+                    break;
+                }
+                if (tinted) {
+                    rs_set_color_mod(rend, cmd->quad.texture, cmd->r, cmd->g, cmd->b);
+                }
+                if (cmd->quad.angle != 0.0 || cmd->quad.flip != SDL_FLIP_NONE) {
+                    rs_copy_ex(rend, cmd->quad.texture, src, dst,
+                               cmd->quad.angle, center, cmd->quad.flip);
+                } else {
+                    rs_copy(rend, cmd->quad.texture, src, dst);
+                }
+                if (tinted) {
+                    rs_set_color_mod(rend, cmd->quad.texture, 255, 255, 255);
+                }
+                break;
+            }
+
+            case RENDER_CMD_SOLID_QUAD:
+                solid_push(rend, cmd);
+                break;
+
+            case RENDER_CMD_RECT:
+                rs_set_draw_color(rend, cmd->r, cmd->g, cmd->b, cmd->a);
+                rs_draw_rect(rend, &cmd->rect);
+                break;
+
+            case RENDER_CMD_FILL_RECT:
+                rs_set_draw_color(rend, cmd->r, cmd->g, cmd->b, cmd->a);
+                rs_fill_rect(rend, &cmd->rect);
+                break;
+
+            case RENDER_CMD_LINE:
+                rs_set_draw_color(rend, cmd->r, cmd->g, cmd->b, cmd->a);
+                rs_draw_line(rend, cmd->line.x1, cmd->line.y1,
+                             cmd->line.x2, cmd->line.y2);
+                break;
+        }
+    }
+    solid_flush(rend);
 }
 
 void renderer_present(renderer_t *rend) {
+    if (rend->scene_target) {
+        /* Back to the window (restores its own scale), then upscale the scene */
+        rs_set_target(rend, NULL);
+        SDL_Rect src = {
+            0,
+            0,
+            (int)(rend->width * rend->scale + 0.5f),
+            (int)(rend->height * rend->scale + 0.5f)
+        };
+        SDL_RenderCopy(rend->renderer, rend->scene_target, &src, NULL);
+
+        /* A draw call, but its pixels stay out of the scene's overdraw */
+        rend->frame.draw_calls++;
+        rend->frame.vertices += 4;
+        rend->frame.texture_binds++;
+        rend->bound_texture = rend->scene_target;
+    }
     SDL_RenderPresent(rend->renderer);
+
+    rend->last = rend->frame;
+    memset(&rend->frame, 0, sizeof(rend->frame));
+}
+
+void renderer_set_scale(renderer_t *rend, float scale) {
+    if (!rend->scene_target) {
+        return;
+    }
+    if (scale <= 0.0f) {
+        scale = 0.01f;
+    }
+    if (scale > 1.0f) {
+        scale = 1.0f;
+    }
+    rend->scale = scale;
+}
+
+float renderer_get_scale(const renderer_t *rend) {
+    return rend->scene_target ? rend->scale : 1.0f;
+}
+
+bool renderer_set_vsync(renderer_t *rend, bool vsync) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (rend->window && SDL_RenderSetVSync(rend->renderer, vsync ? 1 : 0) == 0) {
+        rend->vsync = vsync;
+        return true;
+    }
+    LOG_WARN(LOG_CAT_RENDER, "Vsync can't be changed: %s",
+             rend->window ? SDL_GetError() : "headless renderer");
+#else
+    (void)rend;
+    (void)vsync;
+    LOG_WARN(LOG_CAT_RENDER, "Vsync can't be changed before SDL 2.0.18");
+#endif
+    return false;
 }
 
 void renderer_set_title(renderer_t *rend, const char *title) {
-    SDL_SetWindowTitle(rend->window, title);
+    if (rend->window) {
+        SDL_SetWindowTitle(rend->window, title);
+    }
 }
 
 SDL_Renderer *renderer_get_sdl(renderer_t *rend) {
     return rend->renderer;
 }
+
+const renderer_stats_t *renderer_get_stats(const renderer_t *rend) {
+    return &rend->last;
+}
+
+float renderer_overdraw(const renderer_t *rend) {
+    Uint64 area = scaled_area(rend, rend->width, rend->height);
+    return area > 0 ? (float)rend->last.pixels / (float)area : 0.0f;
+}
@@ -8,24 +8,101 @@
 
 #include <SDL2/SDL.h>
 #include <stdbool.h>
+#include "core/config.h"
+#include "graphics/render_cmd.h"
+
+/* Solid quads are batched through SDL_RenderGeometry, added in SDL 2.0.18;
+ * older versions draw them one filled rectangle at a time, unrotated */
+#define RENDERER_HAVE_GEOMETRY SDL_VERSION_ATLEAST(2, 0, 18)
+
+/*
+ * Per-frame renderer statistics
+ * Every SDL render call goes through counting wrappers in renderer.c.
+ * Vertex counts follow SDL's batching (4 per quad or filled rect, 5 per
+ * outline, 2 per line); pixels are the scene's destination area at the
+ * current resolution scale, so pixels / scene area approximates overdraw.
+ */
+typedef struct {
+    Uint32 draw_calls;     /* Copies, fills, outlines, lines and clears */
+    Uint32 texture_binds;  /* Copies whose texture differs from the previous copy */
+    Uint32 color_changes;  /* Draw color and texture color mod changes */
+    Uint32 state_changes;  /* Blend mode, render target and scale changes */
+    Uint32 vertices;
+    Uint64 pixels;         /* Approximate pixels covered */
+    Uint32 clears_skipped; /* Clears hidden by an opaque full-target layer */
+    Uint32 rotations_cached; /* Rotated copies drawn from a pre-rotated frame */
+} renderer_stats_t;
+
+/*
+ * A texture pre-rendered at evenly spaced angles
+ * Frame k holds the texture rotated by k * 360 / frames degrees about the
+ * center of a cell x cell square (the texture's diagonal), laid out in a
+ * grid of columns frames per row on one atlas page.
+ */
+typedef struct {
+    SDL_Texture *source;
+    SDL_Texture *page;
+    int width;                  /* Source size */
+    int height;
+    int frames;
+    int columns;
+    int cell;
+    size_t bytes;               /* Page memory */
+} renderer_rotation_t;
 
 /*
  * Renderer context - wraps SDL window and renderer
+ *
+ * When render targets are supported, the scene is drawn into scene_target
+ * at scale * (width x height) and upscaled to the window at present time.
  */
 typedef struct {
-    SDL_Window *window;
+    SDL_Window *window;         /* NULL for a headless renderer */
     SDL_Renderer *renderer;
+    SDL_Surface *surface;       /* Headless output, NULL with a window */
+    SDL_Texture *scene_target;  /* Offscreen scene, NULL if unsupported */
+    float scale;                /* Fraction of width/height actually rendered */
     int width;
     int height;
+    /* Statistics - counted during the frame, published at present */
+    renderer_stats_t frame;
+    renderer_stats_t last;
+    SDL_Texture *bound_texture;  /* Texture of the previous copy */
+    Uint32 draw_color;           /* Current RGBA draw color */
+    bool draw_color_known;       /* draw_color matches the SDL renderer */
+    /* Solid quad batch - flushed as one draw call when another command
+     * type comes up, the batch is full, or the buffer ends */
+#if RENDERER_HAVE_GEOMETRY
+    SDL_Vertex *solid_verts;     /* 4 per quad */
+    int *solid_indices;          /* 6 per quad, built once */
+#endif
+    int solid_count;             /* Quads waiting in the batch */
+    bool batch_solids;           /* Off draws every solid quad on its own */
+    int batch_quads;             /* Batch size, 1..RENDER_SOLID_BATCH_QUADS */
+    bool vsync;                  /* Present waits for vertical blank */
+    /* Rotation cache - opted-in textures drawn rotated copy a pre-rotated
+     * frame instead of resampling the texture */
+    renderer_rotation_t rotations[RENDER_ROT_CACHE_MAX_TEXTURES];
+    int rotation_count;
+    size_t rotation_bytes;
+    bool overdraw_view;          /* Draw the overdraw heatmap instead of the scene */
 } renderer_t;
 
 /*
  * Initialize the rendering system
- * Creates window and hardware-accelerated renderer with VSYNC.
+ * Creates window and hardware-accelerated renderer with VSYNC, plus the
+ * offscreen scene target used for dynamic resolution.
  * Returns true on success, false on failure.
  */
 bool renderer_init(renderer_t *rend, const char *title, int width, int height);
 
+/*
+ * Initialize a windowless software renderer drawing into a width x height
+ * surface (benchmarks, tools). No scene target, so scale stays 1.
+ * Returns true on success, false on failure.
+ */
+bool renderer_init_headless(renderer_t *rend, int width, int height);
+
 /*
  * Clean up the rendering system
  * Destroys renderer and window.
@@ -39,9 +116,60 @@ void renderer_clear(renderer_t *rend, Uint8 r, Uint8 g, Uint8 b);
 
 /*
  * Present the rendered frame (swap buffers)
+ * Upscales the scaled region of the scene target to the window first.
  */
 void renderer_present(renderer_t *rend);
 
+/*
+ * Execute a sorted command buffer against the SDL renderer
+ * Commands run in key order; call render_cmd_sort first.
+ * Draws into the scene target at the current scale when it exists.
+ * Runs of solid quads become one geometry draw call each, and a clear
+ * followed by an opaque full-target quad is skipped. With overdraw_view
+ * set, draws a heatmap of how often each pixel is written instead.
+ */
+void renderer_execute(renderer_t *rend, const render_cmd_buffer_t *cmds);
+
+/*
+ * Pre-render a texture at frames evenly spaced angles (0 uses
+ * RENDER_ROT_CACHE_FRAMES). Rotated, unflipped quads of the whole texture
+ * drawn at its aspect ratio then copy the nearest frame - a plain copy
+ * instead of a rotated resample, which pays off on the software renderer.
+ * Angles snap to 360 / frames degrees; positions stay exact. The texture
+ * must stay alive until uncached or the renderer is cleaned up.
+ * Returns false without render targets, or when the page would exceed
+ * the renderer's texture size or RENDER_ROT_CACHE_MAX_BYTES in total.
+ */
+bool renderer_cache_rotations(renderer_t *rend, SDL_Texture *texture, int frames);
+
+/*
+ * Drop a texture's pre-rotated frames (no-op if it has none)
+ */
+void renderer_uncache_rotations(renderer_t *rend, SDL_Texture *texture);
+
+/*
+ * Memory held by pre-rotated frames in bytes
+ */
+size_t renderer_rotation_cache_bytes(const renderer_t *rend);
+
+/*
+ * Set the resolution scale for subsequent frames (clamped to 0..1]
+ * Has no effect when the renderer has no scene target.
+ */
+void renderer_set_scale(renderer_t *rend, float scale);
+
+/*
+ * Get the resolution scale in effect (1.0 without a scene target)
+ */
+float renderer_get_scale(const renderer_t *rend);
+
+/*
+ * Turn vsync on or off without recreating the renderer
+ * Needs SDL 2.0.18; older versions keep the setting chosen at init.
+ * Returns false if it could not be changed.
+ */
+bool renderer_set_vsync(renderer_t *rend, bool vsync);
+
 /*
  * Update the window title (e.g., to show FPS)
  */
@@ -49,5 +177,16 @@ void renderer_set_title(renderer_t *rend, const char *title);
 
 /*
  * Get the SDL_Renderer pointer for direct operations
+ * Calls made on it directly are not counted in the statistics.
  */
 SDL_Renderer *renderer_get_sdl(renderer_t *rend);
+
+/*
+ * Statistics of the last presented frame
+ */
+const renderer_stats_t *renderer_get_stats(const renderer_t *rend);
+
+/*
+ * Average times each scene pixel was drawn in the last frame
+ */
+float renderer_overdraw(const renderer_t *rend);
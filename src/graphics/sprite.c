@@ -4,40 +4,30 @@
 
 #include "graphics/sprite.h"
 #include "graphics/camera.h"
-
-/* Quicksort partition for sprite indices by z_index */
-static int partition(const sprite_t *sprites, int *indices, int low, int high) {
-    int pivot_z = sprites[indices[high]].z_index;
-    int i = low - 1;
-
-    for (int j = low; j < high; j++) {
-        if (sprites[indices[j]].z_index <= pivot_z) {
-            i++;
-            int temp = indices[i];
-            indices[i] = indices[j];
-            indices[j] = temp;
-        }
-    }
-
-    int temp = indices[i + 1];
-    indices[i + 1] = indices[high];
-    indices[high] = temp;
-
-    return i + 1;
+#include "graphics/render_cmd.h"
+
+void sprite_set_solid(sprite_t *sprite, Uint8 r, Uint8 g, Uint8 b) {
+    sprite->solid = true;
+    sprite->color.r = r;
+    sprite->color.g = g;
+    sprite->color.b = b;
+    sprite->color.a = 255;
 }
 
-/* Recursive quicksort for sprite indices */
-static void quicksort(const sprite_t *sprites, int *indices, int low, int high) {
-    if (low < high) {
-        int pivot = partition(sprites, indices, low, high);
-        quicksort(sprites, indices, low, pivot - 1);
-        quicksort(sprites, indices, pivot + 1, high);
-    }
+/* Untextured sprites share material 0, so equal-depth ones batch together */
+static void sprite_render_solid(render_cmd_buffer_t *cmds, const sprite_t *sprite,
+                                const SDL_Rect *dest_rect, double angle,
+                                const SDL_Point *center, Uint8 r, Uint8 g, Uint8 b) {
+    Uint64 key = render_key(RENDER_LAYER_WORLD, sprite->z_index, 0);
+    render_cmd_solid_quad(cmds, key, dest_rect, angle, center,
+                          (Uint8)(sprite->color.r * r / 255),
+                          (Uint8)(sprite->color.g * g / 255),
+                          (Uint8)(sprite->color.b * b / 255));
 }
 
-void sprite_render(SDL_Renderer *renderer, const sprite_t *sprite,
+void sprite_render(render_cmd_buffer_t *cmds, const sprite_t *sprite,
                    const camera_t *camera, const SDL_Rect *src_rect) {
-    if (!sprite->texture) {
+    if (!sprite->texture && !sprite->solid) {
         return;
     }
 
@@ -51,14 +41,22 @@ void sprite_render(SDL_Renderer *renderer, const sprite_t *sprite,
         sprite->height
     };
 
-    SDL_RenderCopy(renderer, sprite->texture, src_rect, &dest_rect);
+    if (sprite->solid) {
+        sprite_render_solid(cmds, sprite, &dest_rect, 0.0, NULL, 255, 255, 255);
+        return;
+    }
+
+    Uint64 key = render_key(RENDER_LAYER_WORLD, sprite->z_index,
+                            render_material_from_texture(sprite->texture));
+    render_cmd_quad(cmds, key, sprite->texture, src_rect, &dest_rect,
+                    0.0, NULL, SDL_FLIP_NONE, 255, 255, 255);
 }
 
-void sprite_render_ex(SDL_Renderer *renderer, const sprite_t *sprite,
+void sprite_render_ex(render_cmd_buffer_t *cmds, const sprite_t *sprite,
                       const camera_t *camera, const SDL_Rect *src_rect,
                       double angle, const SDL_Point *center,
                       SDL_RendererFlip flip, Uint8 r, Uint8 g, Uint8 b) {
-    if (!sprite->texture) {
+    if (!sprite->texture && !sprite->solid) {
         return;
     }
 
@@ -72,26 +70,14 @@ void sprite_render_ex(SDL_Renderer *renderer, const sprite_t *sprite,
         sprite->height
     };
 
-    /* Apply color modulation */
-    SDL_SetTextureColorMod(sprite->texture, r, g, b);
-
-    SDL_RenderCopyEx(renderer, sprite->texture, src_rect, &dest_rect,
-                     angle, center, flip);
-
-    /* Reset color modulation to default */
-    SDL_SetTextureColorMod(sprite->texture, 255, 255, 255);
-}
-
-void sprite_sort_by_z(const sprite_t *sprites, int *render_order, int count) {
-    if (count <= 0) {
+    if (sprite->solid) {
+        sprite_render_solid(cmds, sprite, &dest_rect, angle, center, r, g, b);
         return;
     }
 
-    /* Initialize indices */
-    for (int i = 0; i < count; i++) {
-        render_order[i] = i;
-    }
-
-    /* Sort indices by z_index */
-    quicksort(sprites, render_order, 0, count - 1);
+    /* Color modulation is applied (and reset) by the backend */
+    Uint64 key = render_key(RENDER_LAYER_WORLD, sprite->z_index,
+                            render_material_from_texture(sprite->texture));
+    render_cmd_quad(cmds, key, sprite->texture, src_rect, &dest_rect,
+                    angle, center, flip, r, g, b);
 }
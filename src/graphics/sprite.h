@@ -2,7 +2,8 @@
  * Knight Engine 2D - Sprite System
  *
  * Represents any renderable game object with position, velocity,
- * dimensions, and texture.
+ * dimensions, and texture. Solid sprites skip the texture and draw as
+ * colored geometry, batched with other untextured quads.
  */
 
 #pragma once
@@ -10,8 +11,9 @@
 #include <SDL2/SDL.h>
 #include <stdbool.h>
 
-/* Forward declaration */
+/* Forward declarations */
 typedef struct camera_t camera_t;
+typedef struct render_cmd_buffer_t render_cmd_buffer_t;
 
 /*
  * Sprite structure - represents any renderable game object
@@ -29,25 +31,38 @@ typedef struct {
     double angle;         /* Rotation in degrees (clockwise) */
     SDL_RendererFlip flip; /* SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL */
     SDL_Texture *texture;
+    bool solid;           /* Draw as a plain colored quad - no texture needed */
+    SDL_Color color;      /* Fill color of a solid sprite (alpha ignored) */
+    /* Simulation level of detail (see core/sim_lod.h) */
+    Uint8 sim_lod;        /* Current sim_lod_tier_t */
+    double sim_last;      /* Simulation time of the last update */
+    float spin;           /* Degrees per second (stress test sprites) */
     /* Debug visualization */
     bool show_debug_bounds;  /* Draw bounding box when debug mode is on */
     Uint8 debug_r, debug_g, debug_b;  /* Debug border color */
 } sprite_t;
 
 /*
- * Render a sprite to the screen
- * Call this for each sprite during the render phase.
+ * Make a sprite solid-colored
+ * Any texture is left in place but no longer drawn; the caller still owns it.
+ */
+void sprite_set_solid(sprite_t *sprite, Uint8 r, Uint8 g, Uint8 b);
+
+/*
+ * Record a sprite into the render command buffer
+ * Call this for each sprite during the render phase. The sprite's z_index
+ * becomes the depth of its sort key, so call order does not matter.
  *
  * camera:   Camera for world-to-screen coordinate conversion.
  * src_rect: Optional source rectangle for sprite sheets.
  *           Pass NULL to render the entire texture.
  *           When non-NULL, specifies which portion of the texture to render.
  */
-void sprite_render(SDL_Renderer *renderer, const sprite_t *sprite,
+void sprite_render(render_cmd_buffer_t *cmds, const sprite_t *sprite,
                    const camera_t *camera, const SDL_Rect *src_rect);
 
 /*
- * Render a sprite with extended options (rotation, flip, color modulation)
+ * Record a sprite with extended options (rotation, flip, color modulation)
  *
  * camera:   Camera for world-to-screen coordinate conversion.
  * src_rect:  Optional source rectangle for sprite sheets (NULL = full texture)
@@ -55,19 +70,10 @@ void sprite_render(SDL_Renderer *renderer, const sprite_t *sprite,
  * center:    Point to rotate around (NULL = center of sprite)
  * flip:      SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL, or combined
  * r, g, b:   Color modulation (255 = no change, lower = tint toward that color)
+ *
+ * Solid sprites ignore src_rect and flip, and the modulation scales their color.
  */
-void sprite_render_ex(SDL_Renderer *renderer, const sprite_t *sprite,
+void sprite_render_ex(render_cmd_buffer_t *cmds, const sprite_t *sprite,
                       const camera_t *camera, const SDL_Rect *src_rect,
                       double angle, const SDL_Point *center,
                       SDL_RendererFlip flip, Uint8 r, Uint8 g, Uint8 b);
-
-/*
- * Sort sprite indices by z_index using quicksort
- * Populates render_order with indices sorted by ascending z_index.
- * Time complexity: O(n log n) average case.
- *
- * sprites:      Array of sprites to reference for z_index values
- * render_order: Output array of indices, sorted by z_index
- * count:        Number of sprites
- */
-void sprite_sort_by_z(const sprite_t *sprites, int *render_order, int count);
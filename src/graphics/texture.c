@@ -3,10 +3,132 @@
  */
 
 #include "graphics/texture.h"
+#include "util/log.h"
 #include <SDL2/SDL_image.h>
-#include <stdio.h>
 #include <string.h>
 
+/* Running totals for texture_memory_bytes() and texture_memory_saved_bytes() */
+static size_t g_texture_bytes = 0;
+static size_t g_texture_saved = 0;
+
+/* Formats already warned about as unsupported, so each is reported once */
+static bool g_format_warned[TEXTURE_FORMAT_COUNT];
+
+static const char *const FORMAT_NAMES[TEXTURE_FORMAT_COUNT] = {
+    "ARGB8888", "ARGB4444", "RGB565", "indexed"
+};
+
+static size_t texture_bytes(SDL_Texture *texture) {
+    Uint32 format;
+    int width, height;
+    if (SDL_QueryTexture(texture, &format, NULL, &width, &height) != 0) {
+        return 0;
+    }
+    return (size_t)width * (size_t)height * SDL_BYTESPERPIXEL(format);
+}
+
+/* Bytes the texture would take at 32-bit, minus what it takes */
+static size_t texture_saved_bytes(SDL_Texture *texture) {
+    int width, height;
+    if (SDL_QueryTexture(texture, NULL, NULL, &width, &height) != 0) {
+        return 0;
+    }
+    size_t full = (size_t)width * (size_t)height * 4;
+    size_t bytes = texture_bytes(texture);
+    return bytes < full ? full - bytes : 0;
+}
+
+static void track_texture(SDL_Texture *texture) {
+    g_texture_bytes += texture_bytes(texture);
+    g_texture_saved += texture_saved_bytes(texture);
+}
+
+/*
+ * SDL pixel format a texture is uploaded in
+ * Falls back to 32-bit when the renderer can't hold the requested format
+ * natively - SDL would otherwise keep a converted 32-bit copy alongside.
+ */
+static Uint32 upload_format(SDL_Renderer *renderer, texture_format_t format) {
+    Uint32 wanted;
+    switch (format) {
+        case TEXTURE_FORMAT_ARGB4444: wanted = SDL_PIXELFORMAT_ARGB4444; break;
+        case TEXTURE_FORMAT_RGB565:   wanted = SDL_PIXELFORMAT_RGB565;   break;
+        default:                      return SDL_PIXELFORMAT_ARGB8888;
+    }
+
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0) {
+        for (Uint32 i = 0; i < info.num_texture_formats; i++) {
+            if (info.texture_formats[i] == wanted) {
+                return wanted;
+            }
+        }
+    }
+
+    if (!g_format_warned[format]) {
+        g_format_warned[format] = true;
+        LOG_INFO(LOG_CAT_RENDER,
+                 "Renderer has no %s textures, using ARGB8888", FORMAT_NAMES[format]);
+    }
+    return SDL_PIXELFORMAT_ARGB8888;
+}
+
+/*
+ * True when every pixel of a 16- or 32-bit surface has full alpha
+ */
+static bool surface_is_opaque(const SDL_Surface *surface) {
+    if (!SDL_ISPIXELFORMAT_ALPHA(surface->format->format)) {
+        return true;
+    }
+
+    Uint32 amask = surface->format->Amask;
+    int bpp = surface->format->BytesPerPixel;
+    for (int y = 0; y < surface->h; y++) {
+        const Uint8 *row = (const Uint8 *)surface->pixels + y * surface->pitch;
+        for (int x = 0; x < surface->w; x++) {
+            Uint32 pixel = bpp == 4 ? ((const Uint32 *)row)[x] : ((const Uint16 *)row)[x];
+            if ((pixel & amask) != amask) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * Convert a surface to the texture format and upload it
+ * The surface is left for the caller to free.
+ */
+static SDL_Texture *upload_surface(SDL_Renderer *renderer, SDL_Surface *surface,
+                                   texture_format_t format) {
+    Uint32 pixel_format = upload_format(renderer, format);
+
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, pixel_format, 0);
+    if (!converted) {
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to convert surface: %s", SDL_GetError());
+        return NULL;
+    }
+
+    SDL_Texture *texture = SDL_CreateTexture(renderer, pixel_format, SDL_TEXTUREACCESS_STATIC,
+                                             converted->w, converted->h);
+    if (texture && SDL_UpdateTexture(texture, NULL, converted->pixels, converted->pitch) != 0) {
+        SDL_DestroyTexture(texture);
+        texture = NULL;
+    }
+    bool opaque = surface_is_opaque(converted);
+    SDL_FreeSurface(converted);
+
+    if (!texture) {
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to create texture: %s", SDL_GetError());
+        return NULL;
+    }
+
+    /* Blend only when some pixel is see-through - opaque copies just overwrite */
+    SDL_SetTextureBlendMode(texture, opaque ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+    track_texture(texture);
+    return texture;
+}
+
 void texture_manager_init(texture_manager_t *tm, SDL_Renderer *renderer) {
     tm->count = 0;
     tm->renderer = renderer;
@@ -15,10 +137,16 @@ void texture_manager_init(texture_manager_t *tm, SDL_Renderer *renderer) {
         tm->entries[i].texture = NULL;
         tm->entries[i].width = 0;
         tm->entries[i].height = 0;
+        tm->entries[i].format = TEXTURE_FORMAT_ARGB8888;
     }
 }
 
 SDL_Texture *texture_load(texture_manager_t *tm, const char *path) {
+    return texture_load_format(tm, path, TEXTURE_POLICY_SPRITES);
+}
+
+SDL_Texture *texture_load_format(texture_manager_t *tm, const char *path,
+                                 texture_format_t format) {
     /* Check if already loaded */
     for (int i = 0; i < tm->count; i++) {
         if (strcmp(tm->entries[i].path, path) == 0) {
@@ -28,23 +156,27 @@ SDL_Texture *texture_load(texture_manager_t *tm, const char *path) {
 
     /* Check capacity */
     if (tm->count >= TEXTURE_MAX_ENTRIES) {
-        fprintf(stderr, "Texture manager full, cannot load: %s\n", path);
+        LOG_ERROR(LOG_CAT_RENDER, "Texture manager full, cannot load: %s", path);
         return NULL;
     }
 
-    /* Load the texture */
-    SDL_Texture *texture = IMG_LoadTexture(tm->renderer, path);
-    if (!texture) {
-        fprintf(stderr, "Failed to load texture '%s': %s\n", path, IMG_GetError());
+    /* Decode, then convert to the requested format at upload */
+    SDL_Surface *surface = IMG_Load(path);
+    if (!surface) {
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to load texture '%s': %s", path, IMG_GetError());
         return NULL;
     }
+    if (format == TEXTURE_FORMAT_INDEXED && !SDL_ISPIXELFORMAT_INDEXED(surface->format->format)) {
+        LOG_INFO(LOG_CAT_RENDER, "Texture '%s' has no palette, uploading as ARGB8888", path);
+    }
 
-    /* Enable alpha blending */
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-
-    /* Query texture dimensions */
-    int width, height;
-    SDL_QueryTexture(texture, NULL, NULL, &width, &height);
+    SDL_Texture *texture = upload_surface(tm->renderer, surface, format);
+    int width = surface->w;
+    int height = surface->h;
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        return NULL;
+    }
 
     /* Store in cache */
     texture_entry_t *entry = &tm->entries[tm->count];
@@ -53,9 +185,12 @@ SDL_Texture *texture_load(texture_manager_t *tm, const char *path) {
     entry->texture = texture;
     entry->width = width;
     entry->height = height;
+    entry->format = format;
     tm->count++;
 
-    printf("Loaded texture: %s (%dx%d)\n", path, width, height);
+    LOG_INFO(LOG_CAT_RENDER, "Loaded texture: %s (%dx%d, %s, %lu bytes%s)", path, width, height,
+             FORMAT_NAMES[format], (unsigned long)texture_bytes(texture),
+             texture_is_opaque(texture) ? ", opaque" : "");
     return texture;
 }
 
@@ -83,31 +218,49 @@ bool texture_get_size(texture_manager_t *tm, const char *path,
 void texture_manager_cleanup(texture_manager_t *tm) {
     for (int i = 0; i < tm->count; i++) {
         if (tm->entries[i].texture) {
-            SDL_DestroyTexture(tm->entries[i].texture);
+            texture_destroy(tm->entries[i].texture);
             tm->entries[i].texture = NULL;
         }
         tm->entries[i].path[0] = '\0';
     }
     tm->count = 0;
-    printf("Texture manager cleaned up\n");
+    LOG_INFO(LOG_CAT_RENDER, "Texture manager cleaned up");
 }
 
 SDL_Texture *texture_create_colored(SDL_Renderer *renderer,
                                     int width, int height,
                                     Uint8 r, Uint8 g, Uint8 b) {
-    /* Create a 32-bit RGBA surface */
-    SDL_Surface *surface = SDL_CreateRGBSurface(
-        0,              /* flags (unused) */
-        width, height,  /* dimensions */
-        32,             /* bits per pixel */
-        0x00FF0000,     /* red mask */
-        0x0000FF00,     /* green mask */
-        0x000000FF,     /* blue mask */
-        0xFF000000      /* alpha mask */
-    );
+    return texture_create_colored_format(renderer, width, height, r, g, b,
+                                         TEXTURE_POLICY_GENERATED);
+}
+
+SDL_Texture *texture_create_colored_format(SDL_Renderer *renderer,
+                                           int width, int height,
+                                           Uint8 r, Uint8 g, Uint8 b,
+                                           texture_format_t format) {
+    SDL_Surface *surface;
+    if (format == TEXTURE_FORMAT_INDEXED) {
+        /* One palette entry - a byte per pixel until expanded at upload */
+        surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 8, SDL_PIXELFORMAT_INDEX8);
+        if (surface) {
+            SDL_Color color = { r, g, b, 255 };
+            SDL_SetPaletteColors(surface->format->palette, &color, 0, 1);
+        }
+    } else {
+        /* 32-bit ARGB staging surface, converted to the format at upload */
+        surface = SDL_CreateRGBSurface(
+            0,              /* flags (unused) */
+            width, height,  /* dimensions */
+            32,             /* bits per pixel */
+            0x00FF0000,     /* red mask */
+            0x0000FF00,     /* green mask */
+            0x000000FF,     /* blue mask */
+            0xFF000000      /* alpha mask */
+        );
+    }
 
     if (!surface) {
-        fprintf(stderr, "Failed to create surface: %s\n", SDL_GetError());
+        LOG_ERROR(LOG_CAT_RENDER, "Failed to create surface: %s", SDL_GetError());
         return NULL;
     }
 
@@ -115,14 +268,39 @@ SDL_Texture *texture_create_colored(SDL_Renderer *renderer,
     SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, r, g, b));
 
     /* Convert surface to texture for GPU-accelerated rendering */
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_Texture *texture = upload_surface(renderer, surface, format);
 
     /* Free the surface - we only need the texture now */
     SDL_FreeSurface(surface);
 
+    return texture;
+}
+
+void texture_destroy(SDL_Texture *texture) {
     if (!texture) {
-        fprintf(stderr, "Failed to create texture: %s\n", SDL_GetError());
+        return;
     }
+    size_t bytes = texture_bytes(texture);
+    size_t saved = texture_saved_bytes(texture);
+    g_texture_bytes = bytes < g_texture_bytes ? g_texture_bytes - bytes : 0;
+    g_texture_saved = saved < g_texture_saved ? g_texture_saved - saved : 0;
+    SDL_DestroyTexture(texture);
+}
 
-    return texture;
+size_t texture_memory_bytes(void) {
+    return g_texture_bytes;
+}
+
+bool texture_is_opaque(SDL_Texture *texture) {
+    SDL_BlendMode mode;
+    return texture && SDL_GetTextureBlendMode(texture, &mode) == 0 &&
+           mode == SDL_BLENDMODE_NONE;
+}
+
+size_t texture_memory_saved_bytes(void) {
+    return g_texture_saved;
+}
+
+const char *texture_format_name(texture_format_t format) {
+    return format < TEXTURE_FORMAT_COUNT ? FORMAT_NAMES[format] : "?";
 }
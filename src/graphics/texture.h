@@ -11,6 +11,21 @@
 #include <stdbool.h>
 #include "core/config.h"
 
+/*
+ * Pixel format a texture is stored in
+ * 16-bit formats halve texture memory but need renderer support (the
+ * software renderer has it, most GPU backends don't); without it the
+ * texture falls back to 32-bit. Indexed keeps the CPU-side image at one
+ * byte per pixel and expands it to 32-bit at upload.
+ */
+typedef enum {
+    TEXTURE_FORMAT_ARGB8888 = 0,  /* 32-bit, SDL's native byte order */
+    TEXTURE_FORMAT_ARGB4444,      /* 16-bit with 4-bit alpha */
+    TEXTURE_FORMAT_RGB565,        /* 16-bit opaque */
+    TEXTURE_FORMAT_INDEXED,       /* 8-bit palette, 32-bit once uploaded */
+    TEXTURE_FORMAT_COUNT
+} texture_format_t;
+
 /*
  * Texture entry - stores a loaded texture with its path identifier
  */
@@ -19,6 +34,7 @@ typedef struct {
     SDL_Texture *texture;
     int width;
     int height;
+    texture_format_t format;  /* Format requested at load */
 } texture_entry_t;
 
 /*
@@ -39,9 +55,17 @@ void texture_manager_init(texture_manager_t *tm, SDL_Renderer *renderer);
  * Load a texture from file path
  * Returns the loaded texture, or NULL on failure.
  * Caches textures - subsequent loads of the same path return cached version.
+ * Stored in the TEXTURE_POLICY_SPRITES format.
  */
 SDL_Texture *texture_load(texture_manager_t *tm, const char *path);
 
+/*
+ * Load a texture from file path, converted to the given format
+ * A cached texture is returned as is, whatever format it was loaded in.
+ */
+SDL_Texture *texture_load_format(texture_manager_t *tm, const char *path,
+                                 texture_format_t format);
+
 /*
  * Get a previously loaded texture by path
  * Returns NULL if not found (use texture_load to load first)
@@ -69,3 +93,40 @@ void texture_manager_cleanup(texture_manager_t *tm);
 SDL_Texture *texture_create_colored(SDL_Renderer *renderer,
                                     int width, int height,
                                     Uint8 r, Uint8 g, Uint8 b);
+
+/*
+ * Create a colored rectangle texture in the given format
+ * texture_create_colored uses TEXTURE_POLICY_GENERATED.
+ */
+SDL_Texture *texture_create_colored_format(SDL_Renderer *renderer,
+                                           int width, int height,
+                                           Uint8 r, Uint8 g, Uint8 b,
+                                           texture_format_t format);
+
+/*
+ * Destroy a texture from texture_load or texture_create_colored
+ * Use instead of SDL_DestroyTexture so the memory total stays accurate.
+ */
+void texture_destroy(SDL_Texture *texture);
+
+/*
+ * True for textures without any see-through pixel
+ * Detected at load and creation; such textures draw with blending off.
+ */
+bool texture_is_opaque(SDL_Texture *texture);
+
+/*
+ * Estimated bytes held by live textures created through this module
+ * (width x height x bytes per pixel of the texture's format)
+ */
+size_t texture_memory_bytes(void);
+
+/*
+ * Bytes saved by live textures compared to storing them all at 32-bit
+ */
+size_t texture_memory_saved_bytes(void);
+
+/*
+ * Short name of a format, e.g. "RGB565"
+ */
+const char *texture_format_name(texture_format_t format);
@@ -14,7 +14,7 @@
 /*
  * Input state structure - tracks current and previous frame key states
  */
-typedef struct {
+typedef struct input_state_t {
     const Uint8 *current;           /* Pointer to SDL's keyboard state */
     Uint8 previous[INPUT_MAX_KEYS]; /* Copy of last frame's state */
     int num_keys;                   /* Number of keys tracked */
@@ -45,5 +45,43 @@
 /* Debug toggle */
 #define KEY_DEBUG_TOGGLE SDL_SCANCODE_P
 
+/* Dump the sorted render command list of the next frame */
+#define KEY_RENDER_DUMP SDL_SCANCODE_F12
+
+/* Show the overdraw heatmap instead of the scene */
+#define KEY_OVERDRAW_VIEW SDL_SCANCODE_H
+
 /* STRESS_TEST - Toggle key */
 #define KEY_STRESS_TEST SDL_SCANCODE_T
+
+/* STRESS_TEST - Step the sprite count up/down, cycle scenario presets */
+#define KEY_STRESS_MORE     SDL_SCANCODE_EQUALS
+#define KEY_STRESS_LESS     SDL_SCANCODE_MINUS
+#define KEY_STRESS_SCENARIO SDL_SCANCODE_N
+
+/* Raise the scatter signal for scripted stress test sprites */
+#define KEY_BEHAVIOR_SIGNAL SDL_SCANCODE_G
+
+/* Stress sprites chase the player along the flow field */
+#define KEY_FLOW_CHASE SDL_SCANCODE_F
+
+/* Start/stop the streamed music track */
+#define KEY_MUSIC_TOGGLE SDL_SCANCODE_M
+
+/* Drop a pile of rigid boxes into the view (again to remove them) */
+#define KEY_PHYSICS_DEMO SDL_SCANCODE_B
+
+/* ============================================================================
+ * CVAR KEYS - default toggles for A/B comparisons (util/cvar.h)
+ * ============================================================================ */
+
+/* Log every cvar and its value */
+#define KEY_CVAR_DUMP SDL_SCANCODE_F1
+
+#define KEY_TOGGLE_CULL      SDL_SCANCODE_F2  /* r_cull */
+#define KEY_TOGGLE_BATCH     SDL_SCANCODE_F3  /* r_batch */
+#define KEY_TOGGLE_VSYNC     SDL_SCANCODE_F4  /* r_vsync */
+#define KEY_TOGGLE_DYNRES    SDL_SCANCODE_F5  /* r_dynres */
+#define KEY_TOGGLE_ON_DEMAND SDL_SCANCODE_F6  /* r_on_demand */
+#define KEY_TOGGLE_SIM_LOD   SDL_SCANCODE_F7  /* sim_lod */
+#define KEY_TOGGLE_LOG_ASYNC SDL_SCANCODE_F8  /* log_async */
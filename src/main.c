@@ -4,20 +4,34 @@
 
 #include "core/engine.h"
 #include "core/game_state.h"
+#include "util/alloc.h"
+#include "util/cvar.h"
+#include "util/log.h"
 
 int main(int argc, char *argv[]) {
-    (void)argc;
-    (void)argv;
+    /* Before SDL_Init, so every SDL allocation goes through the hooks */
+    alloc_track_install();
+
+    /* Lines logged from here on are written by the log thread */
+    log_init(LOG_FILE_PATH);
 
     game_state_t game = {0};
 
     if (!engine_init(&game)) {
         engine_cleanup(&game);
+        log_shutdown();
         return 1;
     }
 
+    /* Settings override the config.h defaults: config file, then arguments
+     * (name=value, @file) */
+    cvar_load_file(CVAR_CONFIG_PATH);
+    cvar_parse_args(argc, argv);
+    cvar_report_unknown();
+
     engine_run(&game);
     engine_cleanup(&game);
+    log_shutdown();
 
     return 0;
 }
@@ -0,0 +1,355 @@
+/*
+ * Knight Engine 2D - Flow Field Navigation Implementation
+ */
+
+#include "nav/flow_field.h"
+#include "util/alloc.h"
+#include "util/log.h"
+#include "util/timer.h"
+#include <stdlib.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLOW_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FLOW_SIMD_NEON 1
+#endif
+
+#define FLOW_COST_STRAIGHT 10
+#define FLOW_COST_DIAGONAL 14
+
+/* Neighbour offsets: orthogonal first, then diagonal */
+static const int NEIGHBOR_DX[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+static const int NEIGHBOR_DY[8] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+
+bool flow_field_init(flow_field_t *field, float origin_x, float origin_y,
+                     int width, int height, float cell_size) {
+    size_t cells = (size_t)width * (size_t)height;
+
+    field->width = width;
+    field->height = height;
+    field->origin_x = origin_x;
+    field->origin_y = origin_y;
+    field->cell_size = cell_size;
+    field->inv_cell_size = 1.0f / cell_size;
+    field->target_cell = -1;
+    field->dirty = true;
+    field->last_build_ms = 0.0f;
+    field->builds = 0;
+
+    field->blocked = ENGINE_CALLOC(cells, sizeof(Uint8));
+    field->moves = ENGINE_CALLOC(cells, sizeof(Uint8));
+    field->integration = ENGINE_MALLOC(sizeof(Uint32) * cells);
+    field->dir_x = ENGINE_CALLOC(cells, sizeof(float));
+    field->dir_y = ENGINE_CALLOC(cells, sizeof(float));
+    field->open_next = ENGINE_MALLOC(sizeof(int) * cells);
+    field->open_prev = ENGINE_MALLOC(sizeof(int) * cells);
+
+    if (!field->blocked || !field->moves || !field->integration || !field->dir_x ||
+        !field->dir_y || !field->open_next || !field->open_prev) {
+        LOG_ERROR(LOG_CAT_NAV, "Failed to allocate %dx%d flow field", width, height);
+        flow_field_cleanup(field);
+        return false;
+    }
+    return true;
+}
+
+void flow_field_cleanup(flow_field_t *field) {
+    ENGINE_FREE(field->blocked);
+    ENGINE_FREE(field->moves);
+    ENGINE_FREE(field->integration);
+    ENGINE_FREE(field->dir_x);
+    ENGINE_FREE(field->dir_y);
+    ENGINE_FREE(field->open_next);
+    ENGINE_FREE(field->open_prev);
+    field->blocked = NULL;
+    field->moves = NULL;
+    field->integration = NULL;
+    field->dir_x = NULL;
+    field->dir_y = NULL;
+    field->open_next = NULL;
+    field->open_prev = NULL;
+    field->target_cell = -1;
+}
+
+void flow_field_set_blocked(flow_field_t *field, int cell_x, int cell_y, bool blocked) {
+    if (cell_x < 0 || cell_y < 0 || cell_x >= field->width || cell_y >= field->height) {
+        return;
+    }
+    field->blocked[cell_y * field->width + cell_x] = blocked ? 1 : 0;
+    field->dirty = true;
+}
+
+int flow_field_cell_at(const flow_field_t *field, float x, float y) {
+    /* Clamp in float so far-away positions can't overflow the int cast */
+    float fx = (x - field->origin_x) * field->inv_cell_size;
+    float fy = (y - field->origin_y) * field->inv_cell_size;
+    float max_x = (float)(field->width - 1);
+    float max_y = (float)(field->height - 1);
+
+    fx = fx < 0.0f ? 0.0f : (fx > max_x ? max_x : fx);
+    fy = fy < 0.0f ? 0.0f : (fy > max_y ? max_y : fy);
+    return (int)fy * field->width + (int)fx;
+}
+
+/* ============================================================================
+ * INTEGRATION FIELD (Dijkstra over a bucket queue)
+ *
+ * Edge costs are small integers, so every open cell's cost lies within
+ * FLOW_COST_DIAGONAL of the cell being expanded. A ring of FLOW_BUCKETS
+ * doubly-linked lists keyed by cost therefore replaces the heap, making
+ * push, decrease-key and pop O(1) (Dial's algorithm).
+ * ============================================================================ */
+
+#define FLOW_BUCKETS 16  /* Power of two greater than FLOW_COST_DIAGONAL */
+#define FLOW_NOT_QUEUED (-2)
+
+static void bucket_unlink(flow_field_t *field, int *heads, int cell) {
+    int prev = field->open_prev[cell];
+    int next = field->open_next[cell];
+
+    if (prev >= 0) {
+        field->open_next[prev] = next;
+    } else {
+        heads[field->integration[cell] & (FLOW_BUCKETS - 1)] = next;
+    }
+    if (next >= 0) {
+        field->open_prev[next] = prev;
+    }
+    field->open_prev[cell] = FLOW_NOT_QUEUED;
+}
+
+static void bucket_push(flow_field_t *field, int *heads, int cell) {
+    int *head = &heads[field->integration[cell] & (FLOW_BUCKETS - 1)];
+
+    field->open_prev[cell] = -1;
+    field->open_next[cell] = *head;
+    if (*head >= 0) {
+        field->open_prev[*head] = cell;
+    }
+    *head = cell;
+}
+
+/*
+ * Diagonal moves may not cut the corner of a blocked cell
+ */
+static bool step_allowed(const flow_field_t *field, int x, int y, int dir) {
+    int nx = x + NEIGHBOR_DX[dir];
+    int ny = y + NEIGHBOR_DY[dir];
+
+    if (nx < 0 || ny < 0 || nx >= field->width || ny >= field->height ||
+        field->blocked[ny * field->width + nx]) {
+        return false;
+    }
+    if (dir >= 4) {
+        return !field->blocked[y * field->width + nx] &&
+               !field->blocked[ny * field->width + x];
+    }
+    return true;
+}
+
+/*
+ * Cache the legal moves out of every cell as a bitmask - obstacles change
+ * far less often than the target, so both passes skip the bounds and
+ * corner checks
+ */
+static void build_moves(flow_field_t *field) {
+    for (int y = 0; y < field->height; y++) {
+        for (int x = 0; x < field->width; x++) {
+            Uint8 mask = 0;
+            for (int dir = 0; dir < 8; dir++) {
+                if (step_allowed(field, x, y, dir)) {
+                    mask |= (Uint8)(1u << dir);
+                }
+            }
+            field->moves[y * field->width + x] = mask;
+        }
+    }
+}
+
+static void build_integration(flow_field_t *field) {
+    int cells = field->width * field->height;
+    int heads[FLOW_BUCKETS];
+    int offsets[8];
+    int open = 0;
+
+    for (int dir = 0; dir < 8; dir++) {
+        offsets[dir] = NEIGHBOR_DY[dir] * field->width + NEIGHBOR_DX[dir];
+    }
+
+    for (int i = 0; i < FLOW_BUCKETS; i++) {
+        heads[i] = -1;
+    }
+    for (int i = 0; i < cells; i++) {
+        field->integration[i] = FLOW_FIELD_UNREACHABLE;
+        field->open_prev[i] = FLOW_NOT_QUEUED;
+    }
+
+    /* The target seeds the search even if it sits on a blocked cell,
+     * so agents still converge on a player standing in a wall */
+    field->integration[field->target_cell] = 0;
+    bucket_push(field, heads, field->target_cell);
+    open = 1;
+
+    for (Uint32 current = 0; open > 0; current++) {
+        int *head = &heads[current & (FLOW_BUCKETS - 1)];
+
+        while (*head >= 0) {
+            int cell = *head;
+            bucket_unlink(field, heads, cell);
+            open--;
+
+            unsigned int moves = field->moves[cell];
+
+            for (int dir = 0; dir < 8; dir++) {
+                if (!(moves & (1u << dir))) {
+                    continue;
+                }
+
+                int next = cell + offsets[dir];
+                Uint32 cost = current + (dir < 4 ? FLOW_COST_STRAIGHT : FLOW_COST_DIAGONAL);
+                if (cost >= field->integration[next]) {
+                    continue;
+                }
+
+                if (field->open_prev[next] != FLOW_NOT_QUEUED) {
+                    bucket_unlink(field, heads, next);
+                } else {
+                    open++;
+                }
+                field->integration[next] = cost;
+                bucket_push(field, heads, next);
+            }
+        }
+    }
+}
+
+/*
+ * Point every reachable cell at its lowest-cost neighbour
+ */
+static void build_directions(flow_field_t *field) {
+    static const float INV_SQRT2 = 0.70710678f;
+    int cells = field->width * field->height;
+    int offsets[8];
+
+    for (int dir = 0; dir < 8; dir++) {
+        offsets[dir] = NEIGHBOR_DY[dir] * field->width + NEIGHBOR_DX[dir];
+    }
+
+    for (int cell = 0; cell < cells; cell++) {
+        Uint32 best = field->integration[cell];
+        unsigned int moves = field->moves[cell];
+        int best_dir = -1;
+
+        if (best != FLOW_FIELD_UNREACHABLE && best != 0) {
+            for (int dir = 0; dir < 8; dir++) {
+                if ((moves & (1u << dir)) && field->integration[cell + offsets[dir]] < best) {
+                    best = field->integration[cell + offsets[dir]];
+                    best_dir = dir;
+                }
+            }
+        }
+
+        if (best_dir < 0) {
+            field->dir_x[cell] = 0.0f;
+            field->dir_y[cell] = 0.0f;
+        } else {
+            float scale = best_dir < 4 ? 1.0f : INV_SQRT2;
+            field->dir_x[cell] = NEIGHBOR_DX[best_dir] * scale;
+            field->dir_y[cell] = NEIGHBOR_DY[best_dir] * scale;
+        }
+    }
+}
+
+bool flow_field_update(flow_field_t *field, float target_x, float target_y) {
+    int cell = flow_field_cell_at(field, target_x, target_y);
+    if (cell == field->target_cell && !field->dirty) {
+        return false;
+    }
+
+    Uint64 start = timer_now();
+    if (field->dirty) {
+        build_moves(field);
+        field->dirty = false;
+    }
+    field->target_cell = cell;
+    build_integration(field);
+    build_directions(field);
+
+    field->last_build_ms = timer_elapsed_ms(start, timer_now());
+    field->builds++;
+    return true;
+}
+
+/* ============================================================================
+ * SAMPLING
+ * ============================================================================ */
+
+void flow_field_sample(const flow_field_t *field, const float *xs, const float *ys,
+                       int count, float *out_x, float *out_y) {
+    int i = 0;
+
+    if (field->target_cell < 0) {
+        for (; i < count; i++) {
+            out_x[i] = 0.0f;
+            out_y[i] = 0.0f;
+        }
+        return;
+    }
+
+    /* Cell math is done in float: clamp, truncate, then row * width + col.
+     * Exact for grids below 2^24 cells. */
+#if defined(FLOW_SIMD_SSE2)
+    __m128 origin_x = _mm_set1_ps(field->origin_x);
+    __m128 origin_y = _mm_set1_ps(field->origin_y);
+    __m128 inv = _mm_set1_ps(field->inv_cell_size);
+    __m128 zero = _mm_setzero_ps();
+    __m128 max_x = _mm_set1_ps((float)(field->width - 1));
+    __m128 max_y = _mm_set1_ps((float)(field->height - 1));
+    __m128 width = _mm_set1_ps((float)field->width);
+    for (; i + 4 <= count; i += 4) {
+        __m128 fx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(xs + i), origin_x), inv);
+        __m128 fy = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(ys + i), origin_y), inv);
+        fx = _mm_min_ps(_mm_max_ps(fx, zero), max_x);
+        fy = _mm_min_ps(_mm_max_ps(fy, zero), max_y);
+        __m128 cx = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+        __m128 cy = _mm_cvtepi32_ps(_mm_cvttps_epi32(fy));
+
+        int idx[4];
+        _mm_storeu_si128((__m128i *)(void *)idx,
+                         _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(cy, width), cx)));
+        for (int k = 0; k < 4; k++) {
+            out_x[i + k] = field->dir_x[idx[k]];
+            out_y[i + k] = field->dir_y[idx[k]];
+        }
+    }
+#elif defined(FLOW_SIMD_NEON)
+    float32x4_t origin_x = vdupq_n_f32(field->origin_x);
+    float32x4_t origin_y = vdupq_n_f32(field->origin_y);
+    float32x4_t inv = vdupq_n_f32(field->inv_cell_size);
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t max_x = vdupq_n_f32((float)(field->width - 1));
+    float32x4_t max_y = vdupq_n_f32((float)(field->height - 1));
+    int32x4_t width = vdupq_n_s32(field->width);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t fx = vmulq_f32(vsubq_f32(vld1q_f32(xs + i), origin_x), inv);
+        float32x4_t fy = vmulq_f32(vsubq_f32(vld1q_f32(ys + i), origin_y), inv);
+        fx = vminq_f32(vmaxq_f32(fx, zero), max_x);
+        fy = vminq_f32(vmaxq_f32(fy, zero), max_y);
+
+        int idx[4];
+        vst1q_s32(idx, vmlaq_s32(vcvtq_s32_f32(fx), vcvtq_s32_f32(fy), width));
+        for (int k = 0; k < 4; k++) {
+            out_x[i + k] = field->dir_x[idx[k]];
+            out_y[i + k] = field->dir_y[idx[k]];
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        int cell = flow_field_cell_at(field, xs[i], ys[i]);
+        out_x[i] = field->dir_x[cell];
+        out_y[i] = field->dir_y[cell];
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Knight Engine 2D - Flow Field Navigation
+ *
+ * Steers any number of agents toward one target without per-agent path
+ * searches. The world is divided into a grid of cells; one Dijkstra pass
+ * outward from the target's cell produces an integration field (path cost
+ * to the target, 10 per straight step and 14 per diagonal), and every cell
+ * then stores the unit direction to its cheapest neighbour. Moving an
+ * agent is a cell lookup, so cost per agent is constant no matter how
+ * many agents share the field.
+ *
+ * The field is rebuilt only when the target moves into a different cell
+ * or the obstacles change. Sampling converts a batch of positions to cell
+ * indices four at a time (SSE2/NEON, scalar fallback) and gathers the
+ * directions.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+/* Integration value of cells the target cannot be reached from */
+#define FLOW_FIELD_UNREACHABLE 0xFFFFFFFFu
+
+/*
+ * Flow field over a fixed world-space grid
+ */
+typedef struct {
+    int width, height;         /* Grid size in cells */
+    float origin_x, origin_y;  /* World position of cell (0, 0)'s top-left */
+    float cell_size;
+    float inv_cell_size;
+    Uint8 *blocked;            /* 1 = impassable, per cell */
+    Uint8 *moves;              /* Legal neighbour steps per cell (bit per direction) */
+    Uint32 *integration;       /* Path cost to the target cell */
+    float *dir_x, *dir_y;      /* Unit direction toward the target, per cell */
+    int *open_next;            /* Dijkstra open set: bucket list links per cell */
+    int *open_prev;
+    int target_cell;           /* Cell the field points to, -1 = not built */
+    bool dirty;                /* Obstacles changed since the last build */
+    /* Statistics */
+    float last_build_ms;       /* Time of the most recent rebuild */
+    int builds;                /* Rebuilds since init */
+} flow_field_t;
+
+/*
+ * Allocate a width x height cell grid whose top-left corner sits at
+ * (origin_x, origin_y) in world space. All cells start passable.
+ * Returns true on success, false on allocation failure.
+ */
+bool flow_field_init(flow_field_t *field, float origin_x, float origin_y,
+                     int width, int height, float cell_size);
+
+/*
+ * Free grid storage
+ */
+void flow_field_cleanup(flow_field_t *field);
+
+/*
+ * Mark a cell passable or impassable (takes effect on the next update)
+ */
+void flow_field_set_blocked(flow_field_t *field, int cell_x, int cell_y, bool blocked);
+
+/*
+ * Cell index containing a world position (clamped to the grid)
+ */
+int flow_field_cell_at(const flow_field_t *field, float x, float y);
+
+/*
+ * Point the field at a world position
+ * Rebuilds only if the target changed cell or obstacles changed.
+ * Returns true when a rebuild happened.
+ */
+bool flow_field_update(flow_field_t *field, float target_x, float target_y);
+
+/*
+ * Look up the steering direction for count positions (structure of arrays)
+ * Positions outside the grid use the nearest edge cell. Agents in the
+ * target cell or with no route get (0, 0).
+ */
+void flow_field_sample(const flow_field_t *field, const float *xs, const float *ys,
+                       int count, float *out_x, float *out_y);
@@ -0,0 +1,322 @@
+/*
+ * Knight Engine 2D - Box Collision Implementation
+ *
+ * Follows the reference-face clipping scheme from Box2D Lite.
+ */
+
+#include "physics/collide.h"
+#include <math.h>
+
+/* Box edges, numbered around the box (counter-clockwise in box space) */
+enum {
+    EDGE_NONE = 0,
+    EDGE_1,
+    EDGE_2,
+    EDGE_3,
+    EDGE_4
+};
+
+/* Separating axis candidates */
+enum {
+    AXIS_FACE_A_X,
+    AXIS_FACE_A_Y,
+    AXIS_FACE_B_X,
+    AXIS_FACE_B_Y
+};
+
+typedef struct {
+    float x, y;
+} vec2_t;
+
+/* 2x2 rotation, stored by columns */
+typedef struct {
+    vec2_t col1, col2;
+} mat22_t;
+
+/*
+ * Edge ids packed into a contact feature: the edges on box 1 and box 2
+ * that the point entered and left through
+ */
+typedef struct {
+    Uint8 in_edge1, out_edge1, in_edge2, out_edge2;
+} feature_t;
+
+typedef struct {
+    vec2_t v;
+    feature_t fp;
+} clip_vertex_t;
+
+static vec2_t v2(float x, float y) {
+    vec2_t r = { x, y };
+    return r;
+}
+
+static vec2_t v2_add(vec2_t a, vec2_t b) { return v2(a.x + b.x, a.y + b.y); }
+static vec2_t v2_sub(vec2_t a, vec2_t b) { return v2(a.x - b.x, a.y - b.y); }
+static vec2_t v2_scale(vec2_t a, float s) { return v2(a.x * s, a.y * s); }
+static vec2_t v2_neg(vec2_t a) { return v2(-a.x, -a.y); }
+static vec2_t v2_abs(vec2_t a) { return v2(fabsf(a.x), fabsf(a.y)); }
+static float v2_dot(vec2_t a, vec2_t b) { return a.x * b.x + a.y * b.y; }
+
+static mat22_t mat_rotation(float angle) {
+    float c = cosf(angle);
+    float s = sinf(angle);
+    mat22_t m = { { c, s }, { -s, c } };
+    return m;
+}
+
+static mat22_t mat_transpose(mat22_t m) {
+    mat22_t t = { { m.col1.x, m.col2.x }, { m.col1.y, m.col2.y } };
+    return t;
+}
+
+static mat22_t mat_abs(mat22_t m) {
+    mat22_t a = { v2_abs(m.col1), v2_abs(m.col2) };
+    return a;
+}
+
+static vec2_t mat_mul_v(mat22_t m, vec2_t v) {
+    return v2(m.col1.x * v.x + m.col2.x * v.y, m.col1.y * v.x + m.col2.y * v.y);
+}
+
+static mat22_t mat_mul(mat22_t a, mat22_t b) {
+    mat22_t m = { mat_mul_v(a, b.col1), mat_mul_v(a, b.col2) };
+    return m;
+}
+
+static Uint32 feature_pack(feature_t f) {
+    return (Uint32)f.in_edge1 | ((Uint32)f.out_edge1 << 8) |
+           ((Uint32)f.in_edge2 << 16) | ((Uint32)f.out_edge2 << 24);
+}
+
+static feature_t feature_flip(feature_t f) {
+    feature_t r = { f.in_edge2, f.out_edge2, f.in_edge1, f.out_edge1 };
+    return r;
+}
+
+/*
+ * Clip a segment to the half-plane dot(normal, v) <= offset
+ * Returns the number of output vertices (0-2).
+ */
+static int clip_segment(clip_vertex_t out[2], const clip_vertex_t in[2],
+                        vec2_t normal, float offset, Uint8 clip_edge) {
+    int count = 0;
+    float d0 = v2_dot(normal, in[0].v) - offset;
+    float d1 = v2_dot(normal, in[1].v) - offset;
+
+    if (d0 <= 0.0f) {
+        out[count++] = in[0];
+    }
+    if (d1 <= 0.0f) {
+        out[count++] = in[1];
+    }
+
+    /* Endpoints on opposite sides - add the intersection point */
+    if (d0 * d1 < 0.0f) {
+        float t = d0 / (d0 - d1);
+        out[count].v = v2_add(in[0].v, v2_scale(v2_sub(in[1].v, in[0].v), t));
+        if (d0 > 0.0f) {
+            out[count].fp = in[0].fp;
+            out[count].fp.in_edge1 = clip_edge;
+            out[count].fp.in_edge2 = EDGE_NONE;
+        } else {
+            out[count].fp = in[1].fp;
+            out[count].fp.out_edge1 = clip_edge;
+            out[count].fp.out_edge2 = EDGE_NONE;
+        }
+        count++;
+    }
+    return count;
+}
+
+/*
+ * Find the edge of the incident box most anti-parallel to the reference
+ * face normal, in world space
+ */
+static void incident_edge(clip_vertex_t c[2], vec2_t h, vec2_t pos,
+                          mat22_t rot, vec2_t normal) {
+    /* Normal in the incident box's frame, pointing back at the reference */
+    vec2_t n = v2_neg(mat_mul_v(mat_transpose(rot), normal));
+    vec2_t n_abs = v2_abs(n);
+    feature_t none = { EDGE_NONE, EDGE_NONE, EDGE_NONE, EDGE_NONE };
+
+    c[0].fp = none;
+    c[1].fp = none;
+
+    if (n_abs.x > n_abs.y) {
+        if (n.x > 0.0f) {
+            c[0].v = v2(h.x, -h.y);
+            c[0].fp.in_edge2 = EDGE_3;
+            c[0].fp.out_edge2 = EDGE_4;
+            c[1].v = v2(h.x, h.y);
+            c[1].fp.in_edge2 = EDGE_4;
+            c[1].fp.out_edge2 = EDGE_1;
+        } else {
+            c[0].v = v2(-h.x, h.y);
+            c[0].fp.in_edge2 = EDGE_1;
+            c[0].fp.out_edge2 = EDGE_2;
+            c[1].v = v2(-h.x, -h.y);
+            c[1].fp.in_edge2 = EDGE_2;
+            c[1].fp.out_edge2 = EDGE_3;
+        }
+    } else {
+        if (n.y > 0.0f) {
+            c[0].v = v2(h.x, h.y);
+            c[0].fp.in_edge2 = EDGE_4;
+            c[0].fp.out_edge2 = EDGE_1;
+            c[1].v = v2(-h.x, h.y);
+            c[1].fp.in_edge2 = EDGE_1;
+            c[1].fp.out_edge2 = EDGE_2;
+        } else {
+            c[0].v = v2(-h.x, -h.y);
+            c[0].fp.in_edge2 = EDGE_2;
+            c[0].fp.out_edge2 = EDGE_3;
+            c[1].v = v2(h.x, -h.y);
+            c[1].fp.in_edge2 = EDGE_3;
+            c[1].fp.out_edge2 = EDGE_4;
+        }
+    }
+
+    c[0].v = v2_add(pos, mat_mul_v(rot, c[0].v));
+    c[1].v = v2_add(pos, mat_mul_v(rot, c[1].v));
+}
+
+int physics_collide_boxes(physics_contact_t contacts[2],
+                          const physics_body_t *a, const physics_body_t *b, float margin) {
+    vec2_t h_a = v2(a->half_w, a->half_h);
+    vec2_t h_b = v2(b->half_w, b->half_h);
+    vec2_t pos_a = v2(a->x, a->y);
+    vec2_t pos_b = v2(b->x, b->y);
+    mat22_t rot_a = mat_rotation(a->angle);
+    mat22_t rot_b = mat_rotation(b->angle);
+    mat22_t rot_a_t = mat_transpose(rot_a);
+    mat22_t rot_b_t = mat_transpose(rot_b);
+
+    vec2_t dp = v2_sub(pos_b, pos_a);
+    vec2_t d_a = mat_mul_v(rot_a_t, dp);
+    vec2_t d_b = mat_mul_v(rot_b_t, dp);
+
+    mat22_t c = mat_mul(rot_a_t, rot_b);
+    mat22_t abs_c = mat_abs(c);
+    mat22_t abs_c_t = mat_transpose(abs_c);
+
+    /* Separating axis test on both boxes' face normals */
+    vec2_t face_a = v2_sub(v2_sub(v2_abs(d_a), h_a), mat_mul_v(abs_c, h_b));
+    if (face_a.x > margin || face_a.y > margin) {
+        return 0;
+    }
+    vec2_t face_b = v2_sub(v2_sub(v2_abs(d_b), mat_mul_v(abs_c_t, h_a)), h_b);
+    if (face_b.x > margin || face_b.y > margin) {
+        return 0;
+    }
+
+    /* Pick the axis of least penetration, biased toward box a's faces so
+     * the choice doesn't flicker between nearly equal axes */
+    const float relative_tol = 0.95f;
+    const float absolute_tol = 0.01f;
+    int axis = AXIS_FACE_A_X;
+    float separation = face_a.x;
+    vec2_t normal = d_a.x > 0.0f ? rot_a.col1 : v2_neg(rot_a.col1);
+
+    if (face_a.y > relative_tol * separation + absolute_tol * h_a.y) {
+        axis = AXIS_FACE_A_Y;
+        separation = face_a.y;
+        normal = d_a.y > 0.0f ? rot_a.col2 : v2_neg(rot_a.col2);
+    }
+    if (face_b.x > relative_tol * separation + absolute_tol * h_b.x) {
+        axis = AXIS_FACE_B_X;
+        separation = face_b.x;
+        normal = d_b.x > 0.0f ? rot_b.col1 : v2_neg(rot_b.col1);
+    }
+    if (face_b.y > relative_tol * separation + absolute_tol * h_b.y) {
+        axis = AXIS_FACE_B_Y;
+        normal = d_b.y > 0.0f ? rot_b.col2 : v2_neg(rot_b.col2);
+    }
+
+    /* Reference face and side planes of the chosen box */
+    vec2_t front_normal, side_normal;
+    clip_vertex_t incident[2];
+    float front, neg_side, pos_side, side;
+    Uint8 neg_edge, pos_edge;
+
+    switch (axis) {
+        case AXIS_FACE_A_X:
+            front_normal = normal;
+            front = v2_dot(pos_a, front_normal) + h_a.x;
+            side_normal = rot_a.col2;
+            side = v2_dot(pos_a, side_normal);
+            neg_side = -side + h_a.y;
+            pos_side = side + h_a.y;
+            neg_edge = EDGE_3;
+            pos_edge = EDGE_1;
+            incident_edge(incident, h_b, pos_b, rot_b, front_normal);
+            break;
+        case AXIS_FACE_A_Y:
+            front_normal = normal;
+            front = v2_dot(pos_a, front_normal) + h_a.y;
+            side_normal = rot_a.col1;
+            side = v2_dot(pos_a, side_normal);
+            neg_side = -side + h_a.x;
+            pos_side = side + h_a.x;
+            neg_edge = EDGE_2;
+            pos_edge = EDGE_4;
+            incident_edge(incident, h_b, pos_b, rot_b, front_normal);
+            break;
+        case AXIS_FACE_B_X:
+            front_normal = v2_neg(normal);
+            front = v2_dot(pos_b, front_normal) + h_b.x;
+            side_normal = rot_b.col2;
+            side = v2_dot(pos_b, side_normal);
+            neg_side = -side + h_b.y;
+            pos_side = side + h_b.y;
+            neg_edge = EDGE_3;
+            pos_edge = EDGE_1;
+            incident_edge(incident, h_a, pos_a, rot_a, front_normal);
+            break;
+        default:
+            front_normal = v2_neg(normal);
+            front = v2_dot(pos_b, front_normal) + h_b.y;
+            side_normal = rot_b.col1;
+            side = v2_dot(pos_b, side_normal);
+            neg_side = -side + h_b.x;
+            pos_side = side + h_b.x;
+            neg_edge = EDGE_2;
+            pos_edge = EDGE_4;
+            incident_edge(incident, h_a, pos_a, rot_a, front_normal);
+            break;
+    }
+
+    /* Clip the incident edge to the reference face's side planes */
+    clip_vertex_t clip1[2], clip2[2];
+    if (clip_segment(clip1, incident, v2_neg(side_normal), neg_side, neg_edge) < 2) {
+        return 0;
+    }
+    if (clip_segment(clip2, clip1, side_normal, pos_side, pos_edge) < 2) {
+        return 0;
+    }
+
+    /* Keep the points behind (or within margin of) the reference face */
+    int count = 0;
+    for (int i = 0; i < 2; i++) {
+        float sep = v2_dot(front_normal, clip2[i].v) - front;
+        if (sep > margin) {
+            continue;
+        }
+
+        /* Slide the point onto the reference face */
+        vec2_t p = v2_sub(clip2[i].v, v2_scale(front_normal, sep));
+        feature_t fp = clip2[i].fp;
+        if (axis == AXIS_FACE_B_X || axis == AXIS_FACE_B_Y) {
+            fp = feature_flip(fp);
+        }
+
+        physics_contact_t *ct = &contacts[count++];
+        ct->x = p.x;
+        ct->y = p.y;
+        ct->normal_x = normal.x;
+        ct->normal_y = normal.y;
+        ct->separation = sep;
+        ct->feature = feature_pack(fp);
+    }
+    return count;
+}
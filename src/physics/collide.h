@@ -0,0 +1,22 @@
+/*
+ * Knight Engine 2D - Box Collision
+ *
+ * Narrowphase for two boxes (axis-aligned or oriented). Finds the axis of
+ * least penetration with the separating axis test, then clips the
+ * incident box's edge against the reference face's side planes, giving
+ * up to two contact points. Each point records which edges produced it so
+ * contacts can be matched across steps for warm starting.
+ */
+
+#pragma once
+
+#include "physics/physics.h"
+
+/*
+ * Collide two boxes, filling up to 2 contacts (normals point from a to b)
+ * Points up to margin apart are reported too, with positive separation.
+ * Returns the number of contacts, 0 if the boxes are further apart.
+ * Accumulated impulses in the output are left for the caller to set.
+ */
+int physics_collide_boxes(physics_contact_t contacts[2],
+                          const physics_body_t *a, const physics_body_t *b, float margin);
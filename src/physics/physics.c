@@ -0,0 +1,856 @@
+/*
+ * Knight Engine 2D - Rigid Body Physics Implementation
+ */
+
+#include "physics/physics.h"
+#include "physics/collide.h"
+#include "core/config.h"
+#include "util/alloc.h"
+#include "util/log.h"
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PHYSICS_ARBITERS_INITIAL 256
+#define PHYSICS_GRID_MIN_BUCKETS 1024
+
+static int next_pow2(int n) {
+    int p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+static bool body_is_active(const physics_body_t *body) {
+    return !(body->flags & (PHYSICS_BODY_STATIC | PHYSICS_BODY_ASLEEP));
+}
+
+static void body_update_bounds(physics_body_t *body) {
+    float ext_x = body->half_w;
+    float ext_y = body->half_h;
+
+    if (body->angle != 0.0f) {
+        float c = fabsf(cosf(body->angle));
+        float s = fabsf(sinf(body->angle));
+        ext_x = c * body->half_w + s * body->half_h;
+        ext_y = s * body->half_w + c * body->half_h;
+    }
+
+    /* Padded so pairs are found while still speculative */
+    ext_x += PHYSICS_SPECULATIVE_DISTANCE * 0.5f;
+    ext_y += PHYSICS_SPECULATIVE_DISTANCE * 0.5f;
+    body->min_x = body->x - ext_x;
+    body->max_x = body->x + ext_x;
+    body->min_y = body->y - ext_y;
+    body->max_y = body->y + ext_y;
+}
+
+static bool bounds_overlap(const physics_body_t *a, const physics_body_t *b) {
+    return a->min_x <= b->max_x && b->min_x <= a->max_x &&
+           a->min_y <= b->max_y && b->min_y <= a->max_y;
+}
+
+/* ============================================================================
+ * WORLD LIFETIME
+ * ============================================================================ */
+
+bool physics_world_init(physics_world_t *world, int capacity,
+                        float gravity_x, float gravity_y) {
+    memset(world, 0, sizeof(*world));
+    world->body_capacity = capacity;
+    world->gravity_x = gravity_x;
+    world->gravity_y = gravity_y;
+    world->arbiter_capacity = PHYSICS_ARBITERS_INITIAL;
+    world->grid_mask = next_pow2(capacity * 2 > PHYSICS_GRID_MIN_BUCKETS
+                                     ? capacity * 2 : PHYSICS_GRID_MIN_BUCKETS) - 1;
+    world->grid_item_capacity = capacity * 4;
+    world->grid_dirty = true;
+
+    world->bodies = ENGINE_CALLOC((size_t)capacity, sizeof(physics_body_t));
+    world->arbiters = ENGINE_MALLOC(sizeof(physics_arbiter_t) * (size_t)world->arbiter_capacity);
+    world->arbiters_prev = ENGINE_MALLOC(sizeof(physics_arbiter_t) * (size_t)world->arbiter_capacity);
+    world->awake = ENGINE_MALLOC(sizeof(int) * (size_t)capacity);
+    world->grid_start = ENGINE_MALLOC(sizeof(int) * (size_t)(world->grid_mask + 2));
+    world->grid_items = ENGINE_MALLOC(sizeof(int) * (size_t)world->grid_item_capacity);
+    world->query_stamp = ENGINE_CALLOC((size_t)capacity, sizeof(int));
+    world->island_parent = ENGINE_MALLOC(sizeof(int) * (size_t)capacity);
+    world->island_sleep = ENGINE_MALLOC(sizeof(float) * (size_t)capacity);
+
+    if (!world->bodies || !world->arbiters || !world->arbiters_prev || !world->awake ||
+        !world->grid_start || !world->grid_items || !world->query_stamp ||
+        !world->island_parent || !world->island_sleep) {
+        LOG_ERROR(LOG_CAT_PHYSICS, "Failed to allocate physics world for %d bodies", capacity);
+        physics_world_cleanup(world);
+        return false;
+    }
+    return true;
+}
+
+void physics_world_cleanup(physics_world_t *world) {
+    ENGINE_FREE(world->bodies);
+    ENGINE_FREE(world->arbiters);
+    ENGINE_FREE(world->arbiters_prev);
+    ENGINE_FREE(world->pair_table);
+    ENGINE_FREE(world->awake);
+    ENGINE_FREE(world->grid_start);
+    ENGINE_FREE(world->grid_items);
+    ENGINE_FREE(world->query_stamp);
+    ENGINE_FREE(world->island_parent);
+    ENGINE_FREE(world->island_sleep);
+    memset(world, 0, sizeof(*world));
+}
+
+void physics_world_clear(physics_world_t *world) {
+    world->body_count = 0;
+    world->arbiter_count = 0;
+    world->arbiter_prev_count = 0;
+    world->awake_count = 0;
+    world->awake_dirty = false;
+    world->grid_dirty = true;
+    world->stat_awake = 0;
+    world->stat_islands = 0;
+    world->stat_contacts = 0;
+    world->stat_pairs = 0;
+}
+
+/* ============================================================================
+ * BODIES
+ * ============================================================================ */
+
+int physics_body_add(physics_world_t *world, const physics_body_def_t *def) {
+    if (world->body_count >= world->body_capacity) {
+        return -1;
+    }
+
+    int index = world->body_count++;
+    physics_body_t *body = &world->bodies[index];
+    memset(body, 0, sizeof(*body));
+
+    body->x = def->x;
+    body->y = def->y;
+    body->angle = def->aabb ? 0.0f : def->angle;
+    body->half_w = def->width * 0.5f;
+    body->half_h = def->height * 0.5f;
+    body->friction = def->friction;
+    body->restitution = def->restitution;
+    body->island_next = index;
+
+    if (def->density > 0.0f) {
+        float mass = def->density * def->width * def->height;
+        float inertia = mass * (def->width * def->width + def->height * def->height) / 12.0f;
+        body->inv_mass = 1.0f / mass;
+        body->inv_inertia = def->aabb ? 0.0f : 1.0f / inertia;
+        world->awake_dirty = true;
+    } else {
+        body->flags |= PHYSICS_BODY_STATIC;
+        world->grid_dirty = true;
+    }
+    if (def->aabb) {
+        body->flags |= PHYSICS_BODY_AABB;
+    }
+
+    body_update_bounds(body);
+    return index;
+}
+
+/*
+ * Wake every body in a sleeping island. When append is set the bodies are
+ * added to the end of the awake list (which the caller re-sorts); otherwise
+ * the list is rebuilt at the start of the next step.
+ */
+static int island_wake(physics_world_t *world, int body, bool append) {
+    int woken = 0;
+    int current = body;
+
+    do {
+        physics_body_t *b = &world->bodies[current];
+        int next = b->island_next;
+
+        b->flags &= (Uint8)~PHYSICS_BODY_ASLEEP;
+        b->sleep_time = 0.0f;
+        b->island_next = current;
+        if (append) {
+            world->awake[world->awake_count++] = current;
+        }
+        woken++;
+        current = next;
+    } while (current != body);
+
+    world->grid_dirty = true;
+    if (!append) {
+        world->awake_dirty = true;
+    }
+    return woken;
+}
+
+void physics_body_wake(physics_world_t *world, int body) {
+    if (body < 0 || body >= world->body_count) {
+        return;
+    }
+    physics_body_t *b = &world->bodies[body];
+    if (b->flags & PHYSICS_BODY_ASLEEP) {
+        island_wake(world, body, false);
+    }
+    b->sleep_time = 0.0f;
+}
+
+void physics_body_apply_impulse(physics_world_t *world, int body, float ix, float iy) {
+    if (body < 0 || body >= world->body_count) {
+        return;
+    }
+    physics_body_t *b = &world->bodies[body];
+    if (b->flags & PHYSICS_BODY_STATIC) {
+        return;
+    }
+    physics_body_wake(world, body);
+    b->vel_x += ix * b->inv_mass;
+    b->vel_y += iy * b->inv_mass;
+}
+
+int physics_sleeping_count(const physics_world_t *world) {
+    int count = 0;
+    for (int i = 0; i < world->body_count; i++) {
+        if (world->bodies[i].flags & PHYSICS_BODY_ASLEEP) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/* ============================================================================
+ * BROADPHASE
+ * ============================================================================ */
+
+static const physics_body_t *g_sort_bodies;
+
+static int compare_min_x(const void *a, const void *b) {
+    float xa = g_sort_bodies[*(const int *)a].min_x;
+    float xb = g_sort_bodies[*(const int *)b].min_x;
+    return (xa > xb) - (xa < xb);
+}
+
+static void awake_sort_full(physics_world_t *world) {
+    g_sort_bodies = world->bodies;
+    qsort(world->awake, (size_t)world->awake_count, sizeof(int), compare_min_x);
+}
+
+/* Bodies move little per step, so the list stays nearly sorted */
+static void awake_sort_incremental(physics_world_t *world) {
+    const physics_body_t *bodies = world->bodies;
+    int *awake = world->awake;
+
+    for (int i = 1; i < world->awake_count; i++) {
+        int item = awake[i];
+        float key = bodies[item].min_x;
+        int j = i - 1;
+        while (j >= 0 && bodies[awake[j]].min_x > key) {
+            awake[j + 1] = awake[j];
+            j--;
+        }
+        awake[j + 1] = item;
+    }
+}
+
+static void awake_rebuild(physics_world_t *world) {
+    world->awake_count = 0;
+    for (int i = 0; i < world->body_count; i++) {
+        if (body_is_active(&world->bodies[i])) {
+            world->awake[world->awake_count++] = i;
+        }
+    }
+    world->awake_dirty = false;
+}
+
+static inline int grid_coord(float v) {
+    return (int)floorf(v * (1.0f / PHYSICS_GRID_CELL));
+}
+
+static inline int grid_hash(const physics_world_t *world, int cx, int cy) {
+    return (int)(((Uint32)cx * 73856093u) ^ ((Uint32)cy * 19349663u)) & world->grid_mask;
+}
+
+/*
+ * Rebuild the spatial hash over static and sleeping bodies with a
+ * counting sort, so each bucket's bodies are contiguous
+ */
+static bool grid_rebuild(physics_world_t *world) {
+    int buckets = world->grid_mask + 1;
+    int *start = world->grid_start;
+    int total = 0;
+
+    memset(start, 0, sizeof(int) * (size_t)(buckets + 1));
+    for (int i = 0; i < world->body_count; i++) {
+        const physics_body_t *b = &world->bodies[i];
+        if (body_is_active(b)) {
+            continue;
+        }
+        for (int cy = grid_coord(b->min_y); cy <= grid_coord(b->max_y); cy++) {
+            for (int cx = grid_coord(b->min_x); cx <= grid_coord(b->max_x); cx++) {
+                start[grid_hash(world, cx, cy)]++;
+                total++;
+            }
+        }
+    }
+
+    if (total > world->grid_item_capacity) {
+        int capacity = next_pow2(total);
+        int *items = ENGINE_REALLOC(world->grid_items, sizeof(int) * (size_t)capacity);
+        if (!items) {
+            LOG_ERROR(LOG_CAT_PHYSICS, "Failed to grow physics grid to %d entries", capacity);
+            return false;
+        }
+        world->grid_items = items;
+        world->grid_item_capacity = capacity;
+    }
+
+    /* Running totals give each bucket's end; filling backwards leaves the start */
+    for (int h = 1; h < buckets; h++) {
+        start[h] += start[h - 1];
+    }
+    start[buckets] = total;
+
+    for (int i = 0; i < world->body_count; i++) {
+        const physics_body_t *b = &world->bodies[i];
+        if (body_is_active(b)) {
+            continue;
+        }
+        for (int cy = grid_coord(b->min_y); cy <= grid_coord(b->max_y); cy++) {
+            for (int cx = grid_coord(b->min_x); cx <= grid_coord(b->max_x); cx++) {
+                world->grid_items[--start[grid_hash(world, cx, cy)]] = i;
+            }
+        }
+    }
+
+    world->grid_item_count = total;
+    world->grid_dirty = false;
+    return true;
+}
+
+/* ============================================================================
+ * NARROWPHASE
+ * ============================================================================ */
+
+static bool arbiters_reserve(physics_world_t *world) {
+    if (world->arbiter_count < world->arbiter_capacity) {
+        return true;
+    }
+
+    int capacity = world->arbiter_capacity * 2;
+    physics_arbiter_t *current = ENGINE_REALLOC(world->arbiters, sizeof(physics_arbiter_t) * (size_t)capacity);
+    if (!current) {
+        LOG_ERROR(LOG_CAT_PHYSICS, "Failed to grow physics contacts to %d", capacity);
+        return false;
+    }
+    world->arbiters = current;
+
+    physics_arbiter_t *prev = ENGINE_REALLOC(world->arbiters_prev, sizeof(physics_arbiter_t) * (size_t)capacity);
+    if (!prev) {
+        LOG_ERROR(LOG_CAT_PHYSICS, "Failed to grow physics contacts to %d", capacity);
+        return false;
+    }
+    world->arbiters_prev = prev;
+    world->arbiter_capacity = capacity;
+    return true;
+}
+
+static inline Uint32 pair_hash(int a, int b) {
+    return (Uint32)a * 2654435761u ^ (Uint32)b * 40503u;
+}
+
+static const physics_arbiter_t *pair_find_prev(const physics_world_t *world, int a, int b) {
+    if (!world->pair_table) {
+        return NULL;
+    }
+
+    int slot = (int)(pair_hash(a, b) & (Uint32)world->pair_table_mask);
+    while (world->pair_table[slot] >= 0) {
+        const physics_arbiter_t *arb = &world->arbiters_prev[world->pair_table[slot]];
+        if (arb->a == a && arb->b == b) {
+            return arb;
+        }
+        slot = (slot + 1) & world->pair_table_mask;
+    }
+    return NULL;
+}
+
+/*
+ * Index last step's arbiters by body pair (open addressing, load <= 50%)
+ */
+static void pair_table_build(physics_world_t *world) {
+    int size = next_pow2(world->arbiter_prev_count * 2 > 64 ? world->arbiter_prev_count * 2 : 64);
+
+    if (size - 1 != world->pair_table_mask || !world->pair_table) {
+        int *table = ENGINE_REALLOC(world->pair_table, sizeof(int) * (size_t)size);
+        if (!table) {
+            /* Losing warm starting only costs convergence */
+            ENGINE_FREE(world->pair_table);
+            world->pair_table = NULL;
+            return;
+        }
+        world->pair_table = table;
+        world->pair_table_mask = size - 1;
+    }
+
+    memset(world->pair_table, 0xFF, sizeof(int) * (size_t)size);
+    for (int i = 0; i < world->arbiter_prev_count; i++) {
+        const physics_arbiter_t *arb = &world->arbiters_prev[i];
+        int slot = (int)(pair_hash(arb->a, arb->b) & (Uint32)world->pair_table_mask);
+        while (world->pair_table[slot] >= 0) {
+            slot = (slot + 1) & world->pair_table_mask;
+        }
+        world->pair_table[slot] = i;
+    }
+}
+
+/*
+ * Collide a candidate pair and record its manifold, carrying over the
+ * impulses of contacts that existed last step
+ */
+static void narrowphase_pair(physics_world_t *world, int a, int b) {
+    if (a > b) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+
+    world->stat_pairs++;
+
+    physics_contact_t contacts[2];
+    const physics_body_t *body_a = &world->bodies[a];
+    const physics_body_t *body_b = &world->bodies[b];
+    int count = physics_collide_boxes(contacts, body_a, body_b, PHYSICS_SPECULATIVE_DISTANCE);
+    if (count == 0 || !arbiters_reserve(world)) {
+        return;
+    }
+
+    physics_arbiter_t *arb = &world->arbiters[world->arbiter_count++];
+    arb->a = a;
+    arb->b = b;
+    arb->contact_count = count;
+    arb->friction = sqrtf(body_a->friction * body_b->friction);
+    arb->restitution = body_a->restitution > body_b->restitution
+                           ? body_a->restitution : body_b->restitution;
+
+    const physics_arbiter_t *prev = pair_find_prev(world, a, b);
+    for (int i = 0; i < count; i++) {
+        contacts[i].pn = 0.0f;
+        contacts[i].pt = 0.0f;
+        if (prev) {
+            for (int j = 0; j < prev->contact_count; j++) {
+                if (prev->contacts[j].feature == contacts[i].feature) {
+                    contacts[i].pn = prev->contacts[j].pn;
+                    contacts[i].pt = prev->contacts[j].pt;
+                    break;
+                }
+            }
+        }
+        arb->contacts[i] = contacts[i];
+    }
+}
+
+/*
+ * Query the static/sleeping hash for every awake body. Sleeping bodies
+ * it touches - the narrowphase finds contacts, not just overlapping
+ * bounds - are woken (with their islands) and appended to the awake
+ * list, so they get queried in turn. Returns the number woken.
+ */
+static int broadphase_inactive(physics_world_t *world) {
+    physics_body_t *bodies = world->bodies;
+    int woken = 0;
+
+    for (int n = 0; n < world->awake_count; n++) {
+        int a = world->awake[n];
+        const physics_body_t *body = &bodies[a];
+
+        if (world->query_id == INT_MAX) {
+            memset(world->query_stamp, 0, sizeof(int) * (size_t)world->body_capacity);
+            world->query_id = 0;
+        }
+        int stamp = ++world->query_id;
+
+        for (int cy = grid_coord(body->min_y); cy <= grid_coord(body->max_y); cy++) {
+            for (int cx = grid_coord(body->min_x); cx <= grid_coord(body->max_x); cx++) {
+                int h = grid_hash(world, cx, cy);
+                for (int k = world->grid_start[h]; k < world->grid_start[h + 1]; k++) {
+                    int other = world->grid_items[k];
+                    if (world->query_stamp[other] == stamp) {
+                        continue;
+                    }
+                    world->query_stamp[other] = stamp;
+
+                    if (!bounds_overlap(body, &bodies[other])) {
+                        continue;
+                    }
+                    if (bodies[other].flags & PHYSICS_BODY_STATIC) {
+                        narrowphase_pair(world, a, other);
+                    } else if (bodies[other].flags & PHYSICS_BODY_ASLEEP) {
+                        /* Only tested here - once awake, the sweep records the pair */
+                        physics_contact_t contacts[2];
+                        if (physics_collide_boxes(contacts, body, &bodies[other],
+                                                  PHYSICS_SPECULATIVE_DISTANCE) > 0) {
+                            woken += island_wake(world, other, true);
+                        }
+                    }
+                    /* Otherwise it was woken earlier this step - the sweep finds it */
+                }
+            }
+        }
+    }
+    return woken;
+}
+
+/* Sweep and prune along x over the sorted awake list */
+static void broadphase_awake(physics_world_t *world) {
+    const physics_body_t *bodies = world->bodies;
+    const int *awake = world->awake;
+
+    for (int i = 0; i < world->awake_count; i++) {
+        const physics_body_t *a = &bodies[awake[i]];
+        for (int j = i + 1; j < world->awake_count; j++) {
+            const physics_body_t *b = &bodies[awake[j]];
+            if (b->min_x > a->max_x) {
+                break;
+            }
+            if (a->min_y <= b->max_y && b->min_y <= a->max_y) {
+                narrowphase_pair(world, awake[i], awake[j]);
+            }
+        }
+    }
+}
+
+/* ============================================================================
+ * SOLVER
+ * ============================================================================ */
+
+static void arbiter_prestep(physics_world_t *world, physics_arbiter_t *arb, float inv_dt) {
+    physics_body_t *a = &world->bodies[arb->a];
+    physics_body_t *b = &world->bodies[arb->b];
+
+    for (int i = 0; i < arb->contact_count; i++) {
+        physics_contact_t *c = &arb->contacts[i];
+        float r1x = c->x - a->x, r1y = c->y - a->y;
+        float r2x = c->x - b->x, r2y = c->y - b->y;
+        float nx = c->normal_x, ny = c->normal_y;
+        float tx = ny, ty = -nx;
+
+        c->r1x = r1x;
+        c->r1y = r1y;
+        c->r2x = r2x;
+        c->r2y = r2y;
+
+        float rn1 = r1x * nx + r1y * ny;
+        float rn2 = r2x * nx + r2y * ny;
+        float k_normal = a->inv_mass + b->inv_mass +
+                         a->inv_inertia * (r1x * r1x + r1y * r1y - rn1 * rn1) +
+                         b->inv_inertia * (r2x * r2x + r2y * r2y - rn2 * rn2);
+        c->mass_normal = 1.0f / k_normal;
+
+        float rt1 = r1x * tx + r1y * ty;
+        float rt2 = r2x * tx + r2y * ty;
+        float k_tangent = a->inv_mass + b->inv_mass +
+                          a->inv_inertia * (r1x * r1x + r1y * r1y - rt1 * rt1) +
+                          b->inv_inertia * (r2x * r2x + r2y * r2y - rt2 * rt2);
+        c->mass_tangent = 1.0f / k_tangent;
+
+        /* A speculative contact lets the bodies close the gap this step but
+         * no further; an overlapping one is pushed apart beyond the slop by
+         * the bias velocities instead */
+        float overlap = c->separation + PHYSICS_ALLOWED_PENETRATION;
+        c->bias = c->separation > 0.0f ? -c->separation * inv_dt : 0.0f;
+        c->position_bias = -PHYSICS_BIAS_FACTOR * inv_dt * (overlap < 0.0f ? overlap : 0.0f);
+        c->pn_bias = 0.0f;
+
+        /* Bounce fast impacts */
+        float dvx = b->vel_x - b->ang_vel * r2y - a->vel_x + a->ang_vel * r1y;
+        float dvy = b->vel_y + b->ang_vel * r2x - a->vel_y - a->ang_vel * r1x;
+        float vn = dvx * nx + dvy * ny;
+        if (vn < -PHYSICS_RESTITUTION_THRESHOLD && -arb->restitution * vn > c->bias) {
+            c->bias = -arb->restitution * vn;
+        }
+    }
+}
+
+/*
+ * Apply last step's accumulated impulses. Runs after every pre-step so the
+ * bounce test above sees the velocities before any contact acted.
+ */
+static void arbiter_warm_start(physics_world_t *world, const physics_arbiter_t *arb) {
+    physics_body_t *a = &world->bodies[arb->a];
+    physics_body_t *b = &world->bodies[arb->b];
+
+    for (int i = 0; i < arb->contact_count; i++) {
+        const physics_contact_t *c = &arb->contacts[i];
+        float r1x = c->r1x, r1y = c->r1y;
+        float r2x = c->r2x, r2y = c->r2y;
+        float tx = c->normal_y, ty = -c->normal_x;
+
+        float px = c->pn * c->normal_x + c->pt * tx;
+        float py = c->pn * c->normal_y + c->pt * ty;
+        a->vel_x -= a->inv_mass * px;
+        a->vel_y -= a->inv_mass * py;
+        a->ang_vel -= a->inv_inertia * (r1x * py - r1y * px);
+        b->vel_x += b->inv_mass * px;
+        b->vel_y += b->inv_mass * py;
+        b->ang_vel += b->inv_inertia * (r2x * py - r2y * px);
+    }
+}
+
+static void arbiter_apply_impulse(physics_world_t *world, physics_arbiter_t *arb) {
+    physics_body_t *a = &world->bodies[arb->a];
+    physics_body_t *b = &world->bodies[arb->b];
+
+    for (int i = 0; i < arb->contact_count; i++) {
+        physics_contact_t *c = &arb->contacts[i];
+        float r1x = c->r1x, r1y = c->r1y;
+        float r2x = c->r2x, r2y = c->r2y;
+        float nx = c->normal_x, ny = c->normal_y;
+        float tx = ny, ty = -nx;
+
+        /* Normal impulse, accumulated total clamped to push only */
+        float dvx = b->vel_x - b->ang_vel * r2y - a->vel_x + a->ang_vel * r1y;
+        float dvy = b->vel_y + b->ang_vel * r2x - a->vel_y - a->ang_vel * r1x;
+        float vn = dvx * nx + dvy * ny;
+        float dpn = c->mass_normal * (-vn + c->bias);
+        float pn0 = c->pn;
+        c->pn = pn0 + dpn > 0.0f ? pn0 + dpn : 0.0f;
+        dpn = c->pn - pn0;
+
+        float px = dpn * nx, py = dpn * ny;
+        a->vel_x -= a->inv_mass * px;
+        a->vel_y -= a->inv_mass * py;
+        a->ang_vel -= a->inv_inertia * (r1x * py - r1y * px);
+        b->vel_x += b->inv_mass * px;
+        b->vel_y += b->inv_mass * py;
+        b->ang_vel += b->inv_inertia * (r2x * py - r2y * px);
+
+        /* Overlap correction on the bias velocities only */
+        float bvx = b->bias_vel_x - b->bias_ang_vel * r2y - a->bias_vel_x + a->bias_ang_vel * r1y;
+        float bvy = b->bias_vel_y + b->bias_ang_vel * r2x - a->bias_vel_y - a->bias_ang_vel * r1x;
+        float vnb = bvx * nx + bvy * ny;
+        float dpnb = c->mass_normal * (-vnb + c->position_bias);
+        float pnb0 = c->pn_bias;
+        c->pn_bias = pnb0 + dpnb > 0.0f ? pnb0 + dpnb : 0.0f;
+        dpnb = c->pn_bias - pnb0;
+
+        px = dpnb * nx;
+        py = dpnb * ny;
+        a->bias_vel_x -= a->inv_mass * px;
+        a->bias_vel_y -= a->inv_mass * py;
+        a->bias_ang_vel -= a->inv_inertia * (r1x * py - r1y * px);
+        b->bias_vel_x += b->inv_mass * px;
+        b->bias_vel_y += b->inv_mass * py;
+        b->bias_ang_vel += b->inv_inertia * (r2x * py - r2y * px);
+
+        /* Friction impulse, accumulated total inside the friction cone */
+        dvx = b->vel_x - b->ang_vel * r2y - a->vel_x + a->ang_vel * r1y;
+        dvy = b->vel_y + b->ang_vel * r2x - a->vel_y - a->ang_vel * r1x;
+        float vt = dvx * tx + dvy * ty;
+        float dpt = c->mass_tangent * -vt;
+        float max_pt = arb->friction * c->pn;
+        float pt0 = c->pt;
+        float pt = pt0 + dpt;
+        c->pt = pt < -max_pt ? -max_pt : (pt > max_pt ? max_pt : pt);
+        dpt = c->pt - pt0;
+
+        px = dpt * tx;
+        py = dpt * ty;
+        a->vel_x -= a->inv_mass * px;
+        a->vel_y -= a->inv_mass * py;
+        a->ang_vel -= a->inv_inertia * (r1x * py - r1y * px);
+        b->vel_x += b->inv_mass * px;
+        b->vel_y += b->inv_mass * py;
+        b->ang_vel += b->inv_inertia * (r2x * py - r2y * px);
+    }
+}
+
+/* ============================================================================
+ * ISLANDS
+ * ============================================================================ */
+
+static int island_find(int *parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+/*
+ * Group awake bodies into islands through their contacts and put islands
+ * that have been at rest long enough to sleep
+ */
+static void islands_update(physics_world_t *world, float dt) {
+    physics_body_t *bodies = world->bodies;
+    int *parent = world->island_parent;
+    float *sleep = world->island_sleep;
+    const float lin_sq = PHYSICS_SLEEP_LINEAR * PHYSICS_SLEEP_LINEAR;
+
+    for (int n = 0; n < world->awake_count; n++) {
+        int i = world->awake[n];
+        parent[i] = i;
+    }
+
+    /* Static bodies don't join islands, or the whole floor would be one */
+    for (int i = 0; i < world->arbiter_count; i++) {
+        const physics_arbiter_t *arb = &world->arbiters[i];
+        if ((bodies[arb->a].flags | bodies[arb->b].flags) & PHYSICS_BODY_STATIC) {
+            continue;
+        }
+        int ra = island_find(parent, arb->a);
+        int rb = island_find(parent, arb->b);
+        if (ra != rb) {
+            parent[ra] = rb;
+        }
+    }
+
+    /* Each island sleeps on its most restless body's timer */
+    for (int n = 0; n < world->awake_count; n++) {
+        int i = world->awake[n];
+        physics_body_t *b = &bodies[i];
+        if (b->vel_x * b->vel_x + b->vel_y * b->vel_y > lin_sq ||
+            fabsf(b->ang_vel) > PHYSICS_SLEEP_ANGULAR) {
+            b->sleep_time = 0.0f;
+        } else {
+            b->sleep_time += dt;
+        }
+        sleep[i] = INFINITY;
+    }
+
+    int islands = 0;
+    for (int n = 0; n < world->awake_count; n++) {
+        int i = world->awake[n];
+        int root = island_find(parent, i);
+        if (root == i) {
+            islands++;
+        }
+        if (bodies[i].sleep_time < sleep[root]) {
+            sleep[root] = bodies[i].sleep_time;
+        }
+    }
+    world->stat_islands = islands;
+
+    /* Link sleeping islands into rings: roots first, then members after them */
+    bool any_sleep = false;
+    for (int n = 0; n < world->awake_count; n++) {
+        int i = world->awake[n];
+        if (parent[i] == i && sleep[i] >= PHYSICS_TIME_TO_SLEEP) {
+            bodies[i].island_next = i;
+            any_sleep = true;
+        }
+    }
+    if (!any_sleep) {
+        return;
+    }
+
+    int kept = 0;
+    for (int n = 0; n < world->awake_count; n++) {
+        int i = world->awake[n];
+        int root = island_find(parent, i);
+        if (sleep[root] < PHYSICS_TIME_TO_SLEEP) {
+            world->awake[kept++] = i;
+            continue;
+        }
+
+        physics_body_t *b = &bodies[i];
+        b->flags |= PHYSICS_BODY_ASLEEP;
+        b->vel_x = 0.0f;
+        b->vel_y = 0.0f;
+        b->ang_vel = 0.0f;
+        if (root != i) {
+            b->island_next = bodies[root].island_next;
+            bodies[root].island_next = i;
+        }
+    }
+    world->awake_count = kept;
+    world->grid_dirty = true;
+}
+
+/* ============================================================================
+ * STEP
+ * ============================================================================ */
+
+void physics_world_step(physics_world_t *world, float dt) {
+    if (dt <= 0.0f) {
+        return;
+    }
+    float inv_dt = 1.0f / dt;
+    physics_body_t *bodies = world->bodies;
+
+    /* Last step's manifolds become the warm-start source */
+    physics_arbiter_t *swap = world->arbiters_prev;
+    world->arbiters_prev = world->arbiters;
+    world->arbiters = swap;
+    world->arbiter_prev_count = world->arbiter_count;
+    world->arbiter_count = 0;
+    world->stat_pairs = 0;
+    pair_table_build(world);
+
+    bool resort = world->awake_dirty;
+    if (world->awake_dirty) {
+        awake_rebuild(world);
+    }
+    for (int n = 0; n < world->awake_count; n++) {
+        body_update_bounds(&bodies[world->awake[n]]);
+    }
+    if (world->grid_dirty && !grid_rebuild(world)) {
+        return;
+    }
+
+    /* Broadphase and narrowphase */
+    if (broadphase_inactive(world) > 0) {
+        resort = true;
+    }
+    if (resort) {
+        awake_sort_full(world);
+    } else {
+        awake_sort_incremental(world);
+    }
+    broadphase_awake(world);
+
+    /* Forces */
+    for (int n = 0; n < world->awake_count; n++) {
+        physics_body_t *b = &bodies[world->awake[n]];
+        b->vel_x += world->gravity_x * dt;
+        b->vel_y += world->gravity_y * dt;
+    }
+
+    /* Contact impulses */
+    for (int i = 0; i < world->arbiter_count; i++) {
+        arbiter_prestep(world, &world->arbiters[i], inv_dt);
+    }
+    for (int i = 0; i < world->arbiter_count; i++) {
+        arbiter_warm_start(world, &world->arbiters[i]);
+    }
+    for (int iter = 0; iter < PHYSICS_ITERATIONS; iter++) {
+        for (int i = 0; i < world->arbiter_count; i++) {
+            arbiter_apply_impulse(world, &world->arbiters[i]);
+        }
+    }
+
+    /* Integrate velocities, including this step's overlap correction */
+    for (int n = 0; n < world->awake_count; n++) {
+        physics_body_t *b = &bodies[world->awake[n]];
+        b->x += (b->vel_x + b->bias_vel_x) * dt;
+        b->y += (b->vel_y + b->bias_vel_y) * dt;
+        b->angle += (b->ang_vel + b->bias_ang_vel) * dt;
+        b->bias_vel_x = 0.0f;
+        b->bias_vel_y = 0.0f;
+        b->bias_ang_vel = 0.0f;
+    }
+
+    int contacts = 0;
+    for (int i = 0; i < world->arbiter_count; i++) {
+        contacts += world->arbiters[i].contact_count;
+    }
+    world->stat_contacts = contacts;
+
+    /* Bodies put to sleep keep these bounds in the hash */
+    for (int n = 0; n < world->awake_count; n++) {
+        body_update_bounds(&bodies[world->awake[n]]);
+    }
+
+    islands_update(world, dt);
+    world->stat_awake = world->awake_count;
+}
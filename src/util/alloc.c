@@ -0,0 +1,244 @@
+/*
+ * Knight Engine 2D - Allocation Tracking Implementation
+ */
+
+#include "util/alloc.h"
+#include "core/config.h"
+#include "util/log.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define ALLOC_HAVE_BACKTRACE 1
+#else
+#define ALLOC_HAVE_BACKTRACE 0
+#endif
+
+#define ALLOC_MAX_REPORTED_SITES 64
+#define ALLOC_BACKTRACE_DEPTH    8
+
+/* Main-thread state - only touched from that thread */
+static SDL_threadID g_main_thread = 0;
+static alloc_phase_t g_phase = ALLOC_PHASE_OTHER;
+static alloc_frame_stats_t g_frame;
+static alloc_frame_stats_t g_last;
+static Uint32 g_frame_index = 0;
+
+/* Call sites already reported, so each is printed once */
+static Uint64 g_reported[ALLOC_MAX_REPORTED_SITES];
+static int g_reported_count = 0;
+
+static SDL_atomic_t g_other_threads;
+
+static const char *const PHASE_NAMES[ALLOC_PHASE_COUNT] = {
+    "other", "input", "sim", "events", "audio", "render", "present"
+};
+
+#if ALLOC_HOT_PATH_CHECK
+
+/* Phases that must not allocate once warmed up */
+static const bool PHASE_HOT[ALLOC_PHASE_COUNT] = {
+    false, false, true, false, false, true, false
+};
+
+static bool site_already_reported(Uint64 site) {
+    for (int i = 0; i < g_reported_count; i++) {
+        if (g_reported[i] == site) {
+            return true;
+        }
+    }
+    if (g_reported_count < ALLOC_MAX_REPORTED_SITES) {
+        g_reported[g_reported_count++] = site;
+    }
+    return false;
+}
+
+/*
+ * Report an allocation on the hot path
+ * Engine sites are known by file and line; SDL sites by the stack.
+ */
+static void report_hot_allocation(size_t size, const char *file, int line) {
+    Uint64 site;
+#if ALLOC_HAVE_BACKTRACE
+    void *frames[ALLOC_BACKTRACE_DEPTH];
+    int depth = 0;
+#endif
+
+    if (file) {
+        site = ((Uint64)(uintptr_t)file << 16) ^ (Uint64)line;
+    } else {
+#if ALLOC_HAVE_BACKTRACE
+        depth = backtrace(frames, ALLOC_BACKTRACE_DEPTH);
+        site = 1469598103934665603ULL;
+        for (int i = 0; i < depth; i++) {
+            site = (site ^ (Uint64)(uintptr_t)frames[i]) * 1099511628211ULL;
+        }
+#else
+        site = 0;
+#endif
+    }
+    if (site_already_reported(site)) {
+        return;
+    }
+
+    /* The logger formats into preallocated rings, so it never allocates back into here */
+    if (file) {
+        LOG_WARN(LOG_CAT_ENGINE, "[ALLOC] %lu bytes allocated in %s phase (frame %u) at %s:%d",
+                 (unsigned long)size, PHASE_NAMES[g_phase], g_frame_index, file, line);
+    } else {
+        LOG_WARN(LOG_CAT_ENGINE, "[ALLOC] %lu bytes allocated by SDL in %s phase (frame %u)%s",
+                 (unsigned long)size, PHASE_NAMES[g_phase], g_frame_index,
+                 ALLOC_HAVE_BACKTRACE ? ", stack:" : "");
+#if ALLOC_HAVE_BACKTRACE
+        /* libc malloc, not SDL's - no allocation hook is re-entered */
+        char **symbols = backtrace_symbols(frames, depth);
+        for (int i = 0; symbols && i < depth; i++) {
+            LOG_WARN(LOG_CAT_ENGINE, "[ALLOC]   %s", symbols[i]);
+        }
+        free(symbols);
+#endif
+    }
+
+#if ALLOC_HOT_PATH_CHECK >= 2
+    log_shutdown();  /* Write the report out before dying */
+    abort();
+#endif
+}
+
+#endif /* ALLOC_HOT_PATH_CHECK */
+
+static void record_alloc(size_t size, const char *file, int line) {
+    if (SDL_ThreadID() != g_main_thread) {
+        SDL_AtomicAdd(&g_other_threads, 1);
+        return;
+    }
+
+    g_frame.count[g_phase]++;
+    g_frame.bytes[g_phase] += size;
+    g_frame.total_count++;
+    g_frame.total_bytes += size;
+
+#if ALLOC_HOT_PATH_CHECK
+    if (PHASE_HOT[g_phase] && g_frame_index > ALLOC_WARMUP_FRAMES) {
+        report_hot_allocation(size, file, line);
+    }
+#else
+    (void)file;
+    (void)line;
+#endif
+}
+
+static void record_free(void) {
+    if (SDL_ThreadID() == g_main_thread) {
+        g_frame.frees++;
+    }
+}
+
+/* ============================================================================
+ * ENGINE ALLOCATOR
+ * ============================================================================ */
+
+void *alloc_malloc(size_t size, const char *file, int line) {
+    record_alloc(size, file, line);
+    return malloc(size);
+}
+
+void *alloc_calloc(size_t count, size_t size, const char *file, int line) {
+    record_alloc(count * size, file, line);
+    return calloc(count, size);
+}
+
+void *alloc_realloc(void *ptr, size_t size, const char *file, int line) {
+    record_alloc(size, file, line);
+    return realloc(ptr, size);
+}
+
+void alloc_free(void *ptr) {
+    if (ptr) {
+        record_free();
+    }
+    free(ptr);
+}
+
+/* ============================================================================
+ * SDL HOOKS
+ * ============================================================================ */
+
+#if SDL_VERSION_ATLEAST(2, 0, 7)
+
+static SDL_malloc_func g_sdl_malloc;
+static SDL_calloc_func g_sdl_calloc;
+static SDL_realloc_func g_sdl_realloc;
+static SDL_free_func g_sdl_free;
+
+static void *SDLCALL hook_malloc(size_t size) {
+    record_alloc(size, NULL, 0);
+    return g_sdl_malloc(size);
+}
+
+static void *SDLCALL hook_calloc(size_t count, size_t size) {
+    record_alloc(count * size, NULL, 0);
+    return g_sdl_calloc(count, size);
+}
+
+static void *SDLCALL hook_realloc(void *ptr, size_t size) {
+    record_alloc(size, NULL, 0);
+    return g_sdl_realloc(ptr, size);
+}
+
+static void SDLCALL hook_free(void *ptr) {
+    if (ptr) {
+        record_free();
+    }
+    g_sdl_free(ptr);
+}
+
+#endif
+
+bool alloc_track_install(void) {
+    g_main_thread = SDL_ThreadID();
+
+#if SDL_VERSION_ATLEAST(2, 0, 7)
+    SDL_GetMemoryFunctions(&g_sdl_malloc, &g_sdl_calloc, &g_sdl_realloc, &g_sdl_free);
+    if (SDL_SetMemoryFunctions(hook_malloc, hook_calloc, hook_realloc, hook_free) != 0) {
+        LOG_ERROR(LOG_CAT_ENGINE, "Failed to install SDL memory hooks: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+#else
+    LOG_WARN(LOG_CAT_ENGINE, "SDL too old for memory hooks - tracking engine allocations only");
+    return false;
+#endif
+}
+
+/* ============================================================================
+ * FRAME STATISTICS
+ * ============================================================================ */
+
+void alloc_frame_begin(void) {
+    g_last = g_frame;
+    memset(&g_frame, 0, sizeof(g_frame));
+    g_phase = ALLOC_PHASE_OTHER;
+    g_frame_index++;
+}
+
+void alloc_set_phase(alloc_phase_t phase) {
+    g_phase = phase;
+}
+
+const alloc_frame_stats_t *alloc_last_frame(void) {
+    return &g_last;
+}
+
+int alloc_other_thread_count(void) {
+    return SDL_AtomicGet(&g_other_threads);
+}
+
+int alloc_hot_path_reports(void) {
+    return g_reported_count;
+}
+
+const char *alloc_phase_name(alloc_phase_t phase) {
+    return phase < ALLOC_PHASE_COUNT ? PHASE_NAMES[phase] : "?";
+}
@@ -0,0 +1,101 @@
+/*
+ * Knight Engine 2D - Allocation Tracking
+ *
+ * Counts heap allocations per frame and per engine phase, both the
+ * engine's own (through the ENGINE_MALLOC family, which records the
+ * calling file and line) and SDL's (through hooks installed with
+ * SDL_SetMemoryFunctions, attributed by return address).
+ *
+ * The steady-state hot path should not allocate. With ALLOC_HOT_PATH_CHECK
+ * enabled, any allocation made during a hot phase (game_update, render)
+ * after ALLOC_WARMUP_FRAMES is reported once per call site, or aborts the
+ * program at level 2. SDL call sites print as addresses; resolve them
+ * with addr2line -e knight_engine_2d <address>.
+ *
+ * Only the main thread's allocations are attributed to phases; other
+ * threads (audio callback, workers) are counted in one atomic total.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Engine phases allocations are attributed to
+ */
+typedef enum {
+    ALLOC_PHASE_OTHER = 0,  /* Startup, shutdown, anything unmarked */
+    ALLOC_PHASE_INPUT,      /* Events, input, toggles */
+    ALLOC_PHASE_SIM,        /* Fixed-step game_update (hot) */
+    ALLOC_PHASE_EVENTS,
+    ALLOC_PHASE_AUDIO,
+    ALLOC_PHASE_RENDER,     /* engine_render (hot) */
+    ALLOC_PHASE_PRESENT,
+    ALLOC_PHASE_COUNT
+} alloc_phase_t;
+
+/*
+ * Allocation counts for one frame (main thread)
+ */
+typedef struct {
+    Uint32 count[ALLOC_PHASE_COUNT];  /* malloc/calloc/realloc calls */
+    Uint64 bytes[ALLOC_PHASE_COUNT];  /* Bytes requested */
+    Uint32 frees;
+    Uint32 total_count;
+    Uint64 total_bytes;
+} alloc_frame_stats_t;
+
+/*
+ * Engine allocator - use instead of malloc/calloc/realloc/free
+ */
+#define ENGINE_MALLOC(size)       alloc_malloc((size), __FILE__, __LINE__)
+#define ENGINE_CALLOC(n, size)    alloc_calloc((n), (size), __FILE__, __LINE__)
+#define ENGINE_REALLOC(ptr, size) alloc_realloc((ptr), (size), __FILE__, __LINE__)
+#define ENGINE_FREE(ptr)          alloc_free(ptr)
+
+void *alloc_malloc(size_t size, const char *file, int line);
+void *alloc_calloc(size_t count, size_t size, const char *file, int line);
+void *alloc_realloc(void *ptr, size_t size, const char *file, int line);
+void alloc_free(void *ptr);
+
+/*
+ * Route SDL's allocations through the tracker
+ * Call first thing in main, before SDL_Init, so nothing SDL allocated
+ * beforehand is freed through the hooks. The calling thread becomes the
+ * main thread. Returns false if SDL is too old to support it (engine
+ * allocations are still tracked).
+ */
+bool alloc_track_install(void);
+
+/*
+ * Start a new frame: the previous frame's counts become the last frame's
+ * stats and the phase resets to ALLOC_PHASE_OTHER
+ */
+void alloc_frame_begin(void);
+
+/*
+ * Attribute subsequent main-thread allocations to a phase
+ */
+void alloc_set_phase(alloc_phase_t phase);
+
+/*
+ * Counts of the last completed frame
+ */
+const alloc_frame_stats_t *alloc_last_frame(void);
+
+/*
+ * Allocations made by other threads since startup
+ */
+int alloc_other_thread_count(void);
+
+/*
+ * Hot-path allocation sites reported so far
+ */
+int alloc_hot_path_reports(void);
+
+/*
+ * Short name of a phase, e.g. "render"
+ */
+const char *alloc_phase_name(alloc_phase_t phase);
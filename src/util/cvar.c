@@ -0,0 +1,385 @@
+/*
+ * Knight Engine 2D - Console Variables Implementation
+ */
+
+#include "util/cvar.h"
+#include "core/config.h"
+#include "input/input.h"
+#include "util/log.h"
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    const char *help;
+    cvar_type_t type;
+    void *value;               /* bool *, int * or float * */
+    float min, max;            /* Equal = unclamped */
+    cvar_changed_fn changed;
+    void *user;
+    char default_text[32];     /* Value at registration, for cvar_dump */
+} cvar_t;
+
+/* A value set before its cvar registered */
+typedef struct {
+    char name[CVAR_NAME_MAX];
+    char text[CVAR_VALUE_MAX];
+} cvar_pending_t;
+
+typedef struct {
+    SDL_Scancode key;
+    char name[CVAR_NAME_MAX];
+} cvar_binding_t;
+
+static cvar_t g_vars[CVAR_MAX_VARS];
+static int g_var_count = 0;
+static cvar_pending_t g_pending[CVAR_MAX_PENDING];
+static int g_pending_count = 0;
+static cvar_binding_t g_bindings[CVAR_MAX_BINDINGS];
+static int g_binding_count = 0;
+static Uint32 g_changes = 0;
+
+static cvar_t *find(const char *name) {
+    for (int i = 0; i < g_var_count; i++) {
+        if (strcmp(g_vars[i].name, name) == 0) {
+            return &g_vars[i];
+        }
+    }
+    return NULL;
+}
+
+static void format_value(const cvar_t *var, char *out, size_t size) {
+    switch (var->type) {
+        case CVAR_BOOL:
+            snprintf(out, size, "%d", *(bool *)var->value ? 1 : 0);
+            break;
+        case CVAR_INT:
+            snprintf(out, size, "%d", *(int *)var->value);
+            break;
+        case CVAR_FLOAT:
+            snprintf(out, size, "%g", *(float *)var->value);
+            break;
+    }
+}
+
+static bool parse_bool(const char *text, bool *out) {
+    static const char *const on[] = { "1", "true", "on", "yes" };
+    static const char *const off[] = { "0", "false", "off", "no" };
+    for (int i = 0; i < 4; i++) {
+        if (SDL_strcasecmp(text, on[i]) == 0) {
+            *out = true;
+            return true;
+        }
+        if (SDL_strcasecmp(text, off[i]) == 0) {
+            *out = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Parse, clamp and store - returns false if the text doesn't parse
+ * changed is set when the stored value differs from before.
+ */
+static bool assign(cvar_t *var, const char *text, bool *changed) {
+    bool clamp = var->min != var->max;
+    char *end = NULL;
+    errno = 0;
+
+    switch (var->type) {
+        case CVAR_BOOL: {
+            bool v;
+            if (!parse_bool(text, &v)) {
+                return false;
+            }
+            *changed = *(bool *)var->value != v;
+            *(bool *)var->value = v;
+            return true;
+        }
+        case CVAR_INT: {
+            long v = strtol(text, &end, 0);
+            if (end == text || *end != '\0' || errno == ERANGE) {
+                return false;
+            }
+            if (clamp) {
+                v = v < (long)var->min ? (long)var->min : v > (long)var->max ? (long)var->max : v;
+            }
+            *changed = *(int *)var->value != (int)v;
+            *(int *)var->value = (int)v;
+            return true;
+        }
+        case CVAR_FLOAT: {
+            float v = strtof(text, &end);
+            if (end == text || *end != '\0' || errno == ERANGE || v != v) {
+                return false;
+            }
+            if (clamp) {
+                v = v < var->min ? var->min : v > var->max ? var->max : v;
+            }
+            *changed = *(float *)var->value != v;
+            *(float *)var->value = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool set_var(cvar_t *var, const char *text) {
+    bool changed = false;
+    if (!assign(var, text, &changed)) {
+        LOG_WARN(LOG_CAT_ENGINE, "[CVAR] %s: can't use \"%s\"", var->name, text);
+        return false;
+    }
+    if (changed) {
+        char value[32];
+        format_value(var, value, sizeof(value));
+        LOG_INFO(LOG_CAT_ENGINE, "[CVAR] %s = %s", var->name, value);
+        g_changes++;
+        if (var->changed) {
+            var->changed(var->user);
+        }
+    }
+    return true;
+}
+
+static bool add(const char *name, cvar_type_t type, void *value, float min, float max,
+                const char *help, cvar_changed_fn changed, void *user) {
+    if (find(name)) {
+        LOG_WARN(LOG_CAT_ENGINE, "[CVAR] %s registered twice", name);
+        return false;
+    }
+    if (g_var_count == CVAR_MAX_VARS) {
+        LOG_ERROR(LOG_CAT_ENGINE, "[CVAR] No room for %s (CVAR_MAX_VARS)", name);
+        return false;
+    }
+
+    cvar_t *var = &g_vars[g_var_count++];
+    var->name = name;
+    var->help = help ? help : "";
+    var->type = type;
+    var->value = value;
+    var->min = min;
+    var->max = max;
+    var->changed = changed;
+    var->user = user;
+    format_value(var, var->default_text, sizeof(var->default_text));
+
+    /* Apply values given before registration, in the order they came */
+    int kept = 0;
+    for (int i = 0; i < g_pending_count; i++) {
+        if (strcmp(g_pending[i].name, name) == 0) {
+            set_var(var, g_pending[i].text);
+        } else {
+            g_pending[kept++] = g_pending[i];
+        }
+    }
+    g_pending_count = kept;
+    return true;
+}
+
+bool cvar_register_bool(const char *name, bool *value, const char *help,
+                        cvar_changed_fn changed, void *user) {
+    return add(name, CVAR_BOOL, value, 0.0f, 0.0f, help, changed, user);
+}
+
+bool cvar_register_int(const char *name, int *value, int min, int max,
+                       const char *help, cvar_changed_fn changed, void *user) {
+    return add(name, CVAR_INT, value, (float)min, (float)max, help, changed, user);
+}
+
+bool cvar_register_float(const char *name, float *value, float min, float max,
+                         const char *help, cvar_changed_fn changed, void *user) {
+    return add(name, CVAR_FLOAT, value, min, max, help, changed, user);
+}
+
+bool cvar_set(const char *name, const char *text) {
+    cvar_t *var = find(name);
+    if (var) {
+        return set_var(var, text);
+    }
+
+    if (strlen(name) >= CVAR_NAME_MAX || strlen(text) >= CVAR_VALUE_MAX ||
+        g_pending_count == CVAR_MAX_PENDING) {
+        LOG_WARN(LOG_CAT_ENGINE, "[CVAR] Can't hold %s=%s until it registers", name, text);
+        return false;
+    }
+    cvar_pending_t *p = &g_pending[g_pending_count++];
+    strcpy(p->name, name);
+    strcpy(p->text, text);
+    return true;
+}
+
+bool cvar_toggle(const char *name) {
+    cvar_t *var = find(name);
+    if (!var || var->type != CVAR_BOOL) {
+        LOG_WARN(LOG_CAT_ENGINE, "[CVAR] %s is not a registered bool", name);
+        return false;
+    }
+    return set_var(var, *(bool *)var->value ? "0" : "1");
+}
+
+bool cvar_bind(SDL_Scancode key, const char *name) {
+    if (key <= SDL_SCANCODE_UNKNOWN || key >= INPUT_MAX_KEYS) {
+        LOG_WARN(LOG_CAT_ENGINE, "[CVAR] Can't bind %s: key out of range", name);
+        return false;
+    }
+    if (strlen(name) >= CVAR_NAME_MAX) {
+        LOG_WARN(LOG_CAT_ENGINE, "[CVAR] Can't bind %s: name too long", name);
+        return false;
+    }
+
+    /* Rebinding a key replaces what it toggled */
+    cvar_binding_t *b = NULL;
+    for (int i = 0; i < g_binding_count; i++) {
+        if (g_bindings[i].key == key) {
+            b = &g_bindings[i];
+        }
+    }
+    if (!b) {
+        if (g_binding_count == CVAR_MAX_BINDINGS) {
+            LOG_WARN(LOG_CAT_ENGINE, "[CVAR] No room to bind %s (CVAR_MAX_BINDINGS)", name);
+            return false;
+        }
+        b = &g_bindings[g_binding_count++];
+    }
+    b->key = key;
+    strcpy(b->name, name);
+    return true;
+}
+
+void cvar_poll_bindings(const input_state_t *input) {
+    for (int i = 0; i < g_binding_count; i++) {
+        if (input_key_pressed(input, g_bindings[i].key)) {
+            cvar_toggle(g_bindings[i].name);
+        }
+    }
+}
+
+/* Next whitespace-separated word of *s, NUL-terminated in place */
+static char *next_word(char **s) {
+    char *p = *s;
+    while (isspace((unsigned char)*p)) {
+        p++;
+    }
+    if (*p == '\0') {
+        *s = p;
+        return NULL;
+    }
+    char *word = p;
+    while (*p && !isspace((unsigned char)*p)) {
+        p++;
+    }
+    if (*p) {
+        *p++ = '\0';
+    }
+    *s = p;
+    return word;
+}
+
+bool cvar_load_file(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+
+    char line[256];
+    int line_number = 0;
+    while (fgets(line, sizeof(line), f)) {
+        line_number++;
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        /* "name = value" reads the same as "name value" */
+        char *eq = strchr(line, '=');
+        if (eq) {
+            *eq = ' ';
+        }
+
+        char *rest = line;
+        char *first = next_word(&rest);
+        if (!first) {
+            continue;
+        }
+        char *second = next_word(&rest);
+        char *third = next_word(&rest);
+
+        if (strcmp(first, "bind") == 0 && second && third) {
+            SDL_Scancode key = SDL_GetScancodeFromName(second);
+            if (key == SDL_SCANCODE_UNKNOWN) {
+                LOG_WARN(LOG_CAT_ENGINE, "[CVAR] %s:%d: unknown key \"%s\"",
+                         path, line_number, second);
+            } else {
+                cvar_bind(key, third);
+            }
+        } else if (second && !third) {
+            cvar_set(first, second);
+        } else {
+            LOG_WARN(LOG_CAT_ENGINE, "[CVAR] %s:%d: expected \"name value\" or "
+                     "\"bind KEY name\"", path, line_number);
+        }
+    }
+    fclose(f);
+    LOG_INFO(LOG_CAT_ENGINE, "[CVAR] Loaded %s", path);
+    return true;
+}
+
+void cvar_parse_args(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *eq = strchr(arg, '=');
+
+        if (arg[0] == '@') {
+            if (!cvar_load_file(arg + 1)) {
+                LOG_WARN(LOG_CAT_ENGINE, "[CVAR] Can't open %s", arg + 1);
+            }
+        } else if (eq && eq != arg && (size_t)(eq - arg) < CVAR_NAME_MAX) {
+            char name[CVAR_NAME_MAX];
+            memcpy(name, arg, (size_t)(eq - arg));
+            name[eq - arg] = '\0';
+            cvar_set(name, eq + 1);
+        } else {
+            LOG_WARN(LOG_CAT_ENGINE, "[CVAR] Ignoring argument \"%s\" - expected name=value "
+                     "or @file", arg);
+        }
+    }
+}
+
+void cvar_dump(void) {
+    LOG_INFO(LOG_CAT_ENGINE, "[CVAR] %d variables (%u changes):", g_var_count, g_changes);
+    for (int i = 0; i < g_var_count; i++) {
+        const cvar_t *var = &g_vars[i];
+        char value[32];
+        char key[48] = "";
+        format_value(var, value, sizeof(value));
+        for (int b = 0; b < g_binding_count; b++) {
+            if (strcmp(g_bindings[b].name, var->name) == 0) {
+                snprintf(key, sizeof(key), " [%s]", SDL_GetScancodeName(g_bindings[b].key));
+            }
+        }
+        LOG_INFO(LOG_CAT_ENGINE, "[CVAR]   %-16s %-8s (default %s)%s - %s",
+                 var->name, value, var->default_text, key, var->help);
+    }
+    cvar_report_unknown();
+}
+
+void cvar_report_unknown(void) {
+    for (int i = 0; i < g_pending_count; i++) {
+        LOG_WARN(LOG_CAT_ENGINE, "[CVAR] %s=%s: no such variable",
+                 g_pending[i].name, g_pending[i].text);
+    }
+}
+
+Uint32 cvar_changes(void) {
+    return g_changes;
+}
+
+void cvar_shutdown(void) {
+    g_var_count = 0;
+    g_pending_count = 0;
+    g_binding_count = 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Knight Engine 2D - Console Variables
+ *
+ * Named, typed runtime settings for A/B testing engine features without
+ * rebuilding. A cvar is bound to a variable its owner already reads - a
+ * struct field or a module static - so a hot-path read is a plain load;
+ * the registry only parses, clamps and writes the value, then calls the
+ * owner's change callback for settings that need applying (vsync).
+ *
+ * Values come from, in order:
+ *
+ *   CVAR_CONFIG_PATH           "name value" lines, # comments, and
+ *                              "bind KEY name" toggle bindings
+ *   command line               name=value, or @path to read another file
+ *   bound keys while running   bool cvars flip, every change is logged
+ *
+ *   knight_engine_2d r_cull=0 stress=1 stress_count=200000
+ *
+ * main() reads the file and command line after engine_init, so the
+ * engine has started with the config.h defaults by then: a value takes
+ * effect through the owner's change callback or its next read, and
+ * anything only read during init (renderer creation, window setup) is not
+ * affected. Names set before their cvar is registered are kept and
+ * applied when it registers. config.h values stay the defaults.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+/* Forward declaration */
+typedef struct input_state_t input_state_t;
+
+typedef enum {
+    CVAR_BOOL,
+    CVAR_INT,
+    CVAR_FLOAT
+} cvar_type_t;
+
+/*
+ * Called after the value changed - including when a value set before
+ * registration is applied, so the owner must be ready by then
+ */
+typedef void (*cvar_changed_fn)(void *user);
+
+/*
+ * Bind a variable - value must outlive the registry (until cvar_shutdown)
+ * min/max clamp int and float values; equal bounds leave them unclamped.
+ */
+bool cvar_register_bool(const char *name, bool *value, const char *help,
+                        cvar_changed_fn changed, void *user);
+bool cvar_register_int(const char *name, int *value, int min, int max,
+                       const char *help, cvar_changed_fn changed, void *user);
+bool cvar_register_float(const char *name, float *value, float min, float max,
+                         const char *help, cvar_changed_fn changed, void *user);
+
+/*
+ * Parse text into a cvar ("1", "off", "0.5", ...). An unregistered name
+ * is held until the cvar registers. Returns false if the text doesn't
+ * parse, or the pending list is full.
+ */
+bool cvar_set(const char *name, const char *text);
+
+/*
+ * Flip a bool cvar. Returns false for unknown or non-bool cvars.
+ */
+bool cvar_toggle(const char *name);
+
+/*
+ * Read "name value" settings and "bind KEY name" lines from a file
+ * Returns false if the file can't be opened.
+ */
+bool cvar_load_file(const char *path);
+
+/*
+ * Apply name=value arguments and @path files, in order
+ * Arguments of any other form are reported and skipped.
+ */
+void cvar_parse_args(int argc, char *argv[]);
+
+/*
+ * Bind a key to toggle a bool cvar, replacing the key's previous binding
+ * Config files name keys as SDL does ("F2", "Keypad 5").
+ */
+bool cvar_bind(SDL_Scancode key, const char *name);
+
+/*
+ * Toggle the cvars whose bound key was pressed this frame
+ */
+void cvar_poll_bindings(const input_state_t *input);
+
+/*
+ * Log every cvar with its value, then any names still unregistered
+ */
+void cvar_dump(void);
+
+/*
+ * Warn about values set for names no cvar has registered (typos)
+ */
+void cvar_report_unknown(void);
+
+/*
+ * Changes applied since startup - tags telemetry so A/B segments can be
+ * told apart
+ */
+Uint32 cvar_changes(void);
+
+/*
+ * Forget every cvar, pending value and binding
+ */
+void cvar_shutdown(void);
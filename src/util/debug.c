@@ -6,17 +6,18 @@
 #include "core/config.h"
 #include "core/game_state.h"
 #include "graphics/camera.h"
+#include "graphics/render_cmd.h"
 #include "graphics/renderer.h"
-#include "graphics/texture.h"
+#include "physics/physics.h"
+#include "util/log.h"
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-void debug_draw_rect(SDL_Renderer *renderer, const camera_t *camera,
+void debug_draw_rect(render_cmd_buffer_t *cmds, const camera_t *camera,
                      float world_x, float world_y, int width, int height,
                      Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
     int screen_x, screen_y;
@@ -24,11 +25,11 @@ void debug_draw_rect(SDL_Renderer *renderer, const camera_t *camera,
 
     SDL_Rect rect = { screen_x, screen_y, width, height };
 
-    SDL_SetRenderDrawColor(renderer, r, g, b, a);
-    SDL_RenderDrawRect(renderer, &rect);
+    render_cmd_rect(cmds, render_key(RENDER_LAYER_DEBUG, 0, 0), &rect,
+                    false, r, g, b, a);
 }
 
-void debug_fill_rect(SDL_Renderer *renderer, const camera_t *camera,
+void debug_fill_rect(render_cmd_buffer_t *cmds, const camera_t *camera,
                      float world_x, float world_y, int width, int height,
                      Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
     int screen_x, screen_y;
@@ -36,11 +37,11 @@ void debug_fill_rect(SDL_Renderer *renderer, const camera_t *camera,
 
     SDL_Rect rect = { screen_x, screen_y, width, height };
 
-    SDL_SetRenderDrawColor(renderer, r, g, b, a);
-    SDL_RenderFillRect(renderer, &rect);
+    render_cmd_rect(cmds, render_key(RENDER_LAYER_DEBUG, 0, 0), &rect,
+                    true, r, g, b, a);
 }
 
-void debug_draw_rect_rotated(SDL_Renderer *renderer, const camera_t *camera,
+void debug_draw_rect_rotated(render_cmd_buffer_t *cmds, const camera_t *camera,
                              float world_x, float world_y, int width, int height,
                              double angle, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
     int screen_x, screen_y;
@@ -76,47 +77,78 @@ void debug_draw_rect_rotated(SDL_Renderer *renderer, const camera_t *camera,
     }
 
     /* Draw lines between corners */
-    SDL_SetRenderDrawColor(renderer, r, g, b, a);
-    SDL_RenderDrawLine(renderer, corners[0].x, corners[0].y, corners[1].x, corners[1].y);
-    SDL_RenderDrawLine(renderer, corners[1].x, corners[1].y, corners[2].x, corners[2].y);
-    SDL_RenderDrawLine(renderer, corners[2].x, corners[2].y, corners[3].x, corners[3].y);
-    SDL_RenderDrawLine(renderer, corners[3].x, corners[3].y, corners[0].x, corners[0].y);
+    Uint64 key = render_key(RENDER_LAYER_DEBUG, 0, 0);
+    for (int i = 0; i < 4; i++) {
+        int next = (i + 1) % 4;
+        render_cmd_line(cmds, key, corners[i].x, corners[i].y,
+                        corners[next].x, corners[next].y, r, g, b, a);
+    }
 }
 
-void debug_stress_test_toggle(game_state_t *game) {
-    if (game->stress_test_active) {
-        /* Despawn: destroy textures and reset count */
-        for (int i = game->stress_test_base_index; i < game->sprite_count; i++) {
-            if (game->sprites[i].texture) {
-                SDL_DestroyTexture(game->sprites[i].texture);
-            }
-        }
-        game->sprite_count = game->stress_test_base_index;
-        game->stress_test_active = false;
-        printf("[STRESS_TEST] Disabled - %d sprites now active\n", game->sprite_count);
-    } else {
-        /* Spawn stress test sprites */
-        game->stress_test_base_index = game->sprite_count;
-        int spawned = 0;
-        for (int i = 0; i < STRESS_TEST_SPRITE_COUNT && game->sprite_count < SPRITE_MAX_COUNT; i++) {
-            sprite_t *spr = &game->sprites[game->sprite_count++];
-            spr->texture = texture_create_colored(renderer_get_sdl(&game->renderer), 32, 32,
-                (Uint8)(rand() % 256), (Uint8)(rand() % 256), (Uint8)(rand() % 256));
-            /* Scatter across a larger world area */
-            spr->x = (float)(rand() % (WINDOW_WIDTH * 2)) - WINDOW_WIDTH / 2;
-            spr->y = (float)(rand() % (WINDOW_HEIGHT * 2)) - WINDOW_HEIGHT / 2;
-            spr->vel_x = (float)(rand() % 100 - 50);
-            spr->vel_y = (float)(rand() % 100 - 50);
-            spr->width = 32;
-            spr->height = 32;
-            spr->z_index = 30 + (rand() % 20);
-            spr->angle = (double)(rand() % 360);
-            spr->flip = SDL_FLIP_NONE;
-            spr->show_debug_bounds = false;
-            spawned++;
+void debug_physics_demo_toggle(game_state_t *game) {
+    physics_world_t *world = &game->physics;
+
+    physics_world_clear(world);
+    game->physics_demo_active = !game->physics_demo_active;
+    if (!game->physics_demo_active) {
+        LOG_INFO(LOG_CAT_PHYSICS, "[PHYSICS] Demo DISABLED");
+        return;
+    }
+
+    /* Floor and walls framing the current view */
+    float left = game->camera.x;
+    float top = game->camera.y;
+    float wall = 40.0f;
+    physics_body_def_t bounds[3] = {
+        { left + WINDOW_WIDTH / 2.0f, top + WINDOW_HEIGHT - wall / 2.0f,
+          (float)WINDOW_WIDTH, wall, 0.0f, 0.0f, 0.6f, 0.0f, true },
+        { left + wall / 2.0f, top + WINDOW_HEIGHT / 2.0f,
+          wall, (float)WINDOW_HEIGHT, 0.0f, 0.0f, 0.6f, 0.0f, true },
+        { left + WINDOW_WIDTH - wall / 2.0f, top + WINDOW_HEIGHT / 2.0f,
+          wall, (float)WINDOW_HEIGHT, 0.0f, 0.0f, 0.6f, 0.0f, true },
+    };
+    for (int i = 0; i < 3; i++) {
+        physics_body_add(world, &bounds[i]);
+    }
+
+    /* Boxes in loose rows above the floor, alternating axis-aligned and
+     * tilted oriented boxes */
+    int columns = (int)((WINDOW_WIDTH - wall * 2.0f) / 48.0f);
+    for (int i = 0; i < PHYSICS_DEMO_BOXES; i++) {
+        physics_body_def_t def;
+        def.width = (float)(16 + rand() % 24);
+        def.height = (float)(16 + rand() % 24);
+        def.x = left + wall + 24.0f + (float)(i % columns) * 48.0f + (float)(rand() % 9 - 4);
+        def.y = top + WINDOW_HEIGHT * 0.6f - (float)(i / columns) * 48.0f;
+        def.angle = (float)(rand() % 100 - 50) / 100.0f;
+        def.density = 1.0f;
+        def.friction = 0.6f;
+        def.restitution = 0.1f;
+        def.aabb = (i % 2) == 0;
+        physics_body_add(world, &def);
+    }
+
+    LOG_INFO(LOG_CAT_PHYSICS, "[PHYSICS] Demo ENABLED (%d bodies)", world->body_count);
+}
+
+void debug_draw_physics(render_cmd_buffer_t *cmds, const camera_t *camera,
+                        const physics_world_t *world) {
+    for (int i = 0; i < world->body_count; i++) {
+        const physics_body_t *body = &world->bodies[i];
+        Uint8 r = 255, g = 165, b = 0;  /* Awake - orange */
+
+        if (body->flags & PHYSICS_BODY_STATIC) {
+            r = 220;
+            g = 220;
+            b = 220;
+        } else if (body->flags & PHYSICS_BODY_ASLEEP) {
+            r = 80;
+            g = 110;
+            b = 200;
         }
-        game->stress_test_active = true;
-        printf("[STRESS_TEST] Enabled - spawned %d sprites (%d total)\n",
-               spawned, game->sprite_count);
+
+        debug_draw_rect_rotated(cmds, camera, body->x - body->half_w, body->y - body->half_h,
+                                (int)(body->half_w * 2.0f), (int)(body->half_h * 2.0f),
+                                body->angle * 180.0 / M_PI, r, g, b, 255);
     }
 }
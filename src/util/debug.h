@@ -2,6 +2,8 @@
  * Knight Engine 2D - Debug Utilities
  *
  * Visual debugging tools for rendering debug information.
+ * Debug shapes are recorded into the debug layer of the render command
+ * buffer, so they always draw on top of the world.
  */
 
 #pragma once
@@ -11,12 +13,14 @@
 /* Forward declarations */
 typedef struct camera_t camera_t;
 typedef struct game_state_t game_state_t;
+typedef struct physics_world_t physics_world_t;
+typedef struct render_cmd_buffer_t render_cmd_buffer_t;
 
 /*
  * Draw a colored rectangle outline (for collision boxes, debug bounds, etc.)
  * Uses world coordinates - converts to screen space using camera.
  */
-void debug_draw_rect(SDL_Renderer *renderer, const camera_t *camera,
+void debug_draw_rect(render_cmd_buffer_t *cmds, const camera_t *camera,
                      float world_x, float world_y, int width, int height,
                      Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
@@ -24,7 +28,7 @@ void debug_draw_rect(SDL_Renderer *renderer, const camera_t *camera,
  * Draw a filled colored rectangle (for debug visualization)
  * Uses world coordinates - converts to screen space using camera.
  */
-void debug_fill_rect(SDL_Renderer *renderer, const camera_t *camera,
+void debug_fill_rect(render_cmd_buffer_t *cmds, const camera_t *camera,
                      float world_x, float world_y, int width, int height,
                      Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
@@ -32,11 +36,18 @@ void debug_fill_rect(SDL_Renderer *renderer, const camera_t *camera,
  * Draw a rotated rectangle outline (for debug bounds on rotated sprites)
  * Angle is in degrees (clockwise), rotation is around the center of the rect.
  */
-void debug_draw_rect_rotated(SDL_Renderer *renderer, const camera_t *camera,
+void debug_draw_rect_rotated(render_cmd_buffer_t *cmds, const camera_t *camera,
                              float world_x, float world_y, int width, int height,
                              double angle, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
 /*
- * Toggle stress test mode - spawns/despawns test sprites for performance testing
+ * Toggle the physics demo - builds a walled floor around the current view
+ * and drops a pile of boxes into it, or clears the world
  */
-void debug_stress_test_toggle(game_state_t *game);
+void debug_physics_demo_toggle(game_state_t *game);
+
+/*
+ * Draw every physics body as a box outline, colored static/awake/asleep
+ */
+void debug_draw_physics(render_cmd_buffer_t *cmds, const camera_t *camera,
+                        const physics_world_t *world);
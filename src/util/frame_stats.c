@@ -0,0 +1,156 @@
+/*
+ * Knight Engine 2D - Rolling Frame Statistics Implementation
+ */
+
+#include "util/frame_stats.h"
+#include <math.h>
+#include <string.h>
+
+static const char *const SERIES_NAMES[FRAME_SERIES_COUNT] = {
+    "frame", "work", "input", "sim", "events", "audio", "render", "present"
+};
+
+/* Lower edge of the histogram, in milliseconds (1 us) */
+#define BUCKET_BASE_MS 0.001f
+
+/*
+ * Histogram bucket of a time: FRAME_STATS_STEPS per doubling above
+ * BUCKET_BASE_MS, everything below in bucket 0 and above in the last
+ */
+static int bucket_index(float ms) {
+    if (!(ms > BUCKET_BASE_MS)) {
+        return 0;
+    }
+    int exponent;
+    float mantissa = frexpf(ms / BUCKET_BASE_MS, &exponent);  /* [0.5, 1) */
+    int bucket = (exponent - 1) * FRAME_STATS_STEPS +
+                 (int)((mantissa * 2.0f - 1.0f) * FRAME_STATS_STEPS);
+    return bucket < FRAME_STATS_BUCKETS ? bucket : FRAME_STATS_BUCKETS - 1;
+}
+
+/* Upper edge of a bucket in milliseconds */
+static float bucket_upper_ms(int bucket) {
+    int octave = bucket / FRAME_STATS_STEPS;
+    int step = bucket % FRAME_STATS_STEPS;
+    return ldexpf(BUCKET_BASE_MS * (1.0f + (float)(step + 1) / FRAME_STATS_STEPS), octave);
+}
+
+static void window_push(frame_window_t *w, float ms) {
+    Uint32 pos = w->pushed++;
+    int slot = (int)(pos % FRAME_STATS_WINDOW);
+
+    /* Evict the sample this slot held */
+    if (w->count == FRAME_STATS_WINDOW) {
+        w->sum -= w->samples[slot];
+        w->histogram[w->bucket_of[slot]]--;
+        Uint32 oldest = pos - FRAME_STATS_WINDOW;
+        if (w->min_count > 0 && w->min_queue[w->min_head] == oldest) {
+            w->min_head = (w->min_head + 1) % FRAME_STATS_WINDOW;
+            w->min_count--;
+        }
+        if (w->max_count > 0 && w->max_queue[w->max_head] == oldest) {
+            w->max_head = (w->max_head + 1) % FRAME_STATS_WINDOW;
+            w->max_count--;
+        }
+    } else {
+        w->count++;
+    }
+
+    int bucket = bucket_index(ms);
+    w->samples[slot] = ms;
+    w->bucket_of[slot] = (Uint8)bucket;
+    w->histogram[bucket]++;
+    w->sum += ms;
+
+    /* Drop queue tails the new sample dominates, then append it */
+    while (w->min_count > 0) {
+        int tail = (w->min_head + w->min_count - 1) % FRAME_STATS_WINDOW;
+        if (w->samples[w->min_queue[tail] % FRAME_STATS_WINDOW] < ms) {
+            break;
+        }
+        w->min_count--;
+    }
+    w->min_queue[(w->min_head + w->min_count++) % FRAME_STATS_WINDOW] = pos;
+
+    while (w->max_count > 0) {
+        int tail = (w->max_head + w->max_count - 1) % FRAME_STATS_WINDOW;
+        if (w->samples[w->max_queue[tail] % FRAME_STATS_WINDOW] > ms) {
+            break;
+        }
+        w->max_count--;
+    }
+    w->max_queue[(w->max_head + w->max_count++) % FRAME_STATS_WINDOW] = pos;
+}
+
+void frame_stats_init(frame_stats_t *fs) {
+    memset(fs, 0, sizeof(*fs));
+}
+
+void frame_stats_record(frame_stats_t *fs, const frame_sample_t *sample) {
+    for (int s = 0; s < FRAME_SERIES_COUNT; s++) {
+        if (sample->ms[s] >= 0.0f) {
+            window_push(&fs->series[s], sample->ms[s]);
+        }
+    }
+    fs->frames++;
+}
+
+void frame_stats_push(frame_stats_t *fs, frame_series_t series, float ms) {
+    window_push(&fs->series[series], ms);
+}
+
+float frame_stats_mean(const frame_stats_t *fs, frame_series_t series) {
+    const frame_window_t *w = &fs->series[series];
+    return w->count > 0 ? (float)(w->sum / w->count) : 0.0f;
+}
+
+float frame_stats_min(const frame_stats_t *fs, frame_series_t series) {
+    const frame_window_t *w = &fs->series[series];
+    if (w->min_count == 0) {
+        return 0.0f;
+    }
+    return w->samples[w->min_queue[w->min_head] % FRAME_STATS_WINDOW];
+}
+
+float frame_stats_max(const frame_stats_t *fs, frame_series_t series) {
+    const frame_window_t *w = &fs->series[series];
+    if (w->max_count == 0) {
+        return 0.0f;
+    }
+    return w->samples[w->max_queue[w->max_head] % FRAME_STATS_WINDOW];
+}
+
+float frame_stats_percentile(const frame_stats_t *fs, frame_series_t series,
+                             float fraction) {
+    const frame_window_t *w = &fs->series[series];
+    if (w->count == 0) {
+        return 0.0f;
+    }
+
+    /* Smallest bucket with at least fraction of the samples at or below it */
+    int needed = (int)ceilf(fraction * (float)w->count);
+    if (needed < 1) {
+        needed = 1;
+    }
+    int seen = 0;
+    int bucket = 0;
+    for (; bucket < FRAME_STATS_BUCKETS - 1; bucket++) {
+        seen += w->histogram[bucket];
+        if (seen >= needed) {
+            break;
+        }
+    }
+
+    float max = frame_stats_max(fs, series);
+    float upper = bucket_upper_ms(bucket);
+    return upper < max ? upper : max;
+}
+
+float frame_stats_fps(const frame_stats_t *fs) {
+    float mean = frame_stats_mean(fs, FRAME_SERIES_FRAME);
+    return mean > 0.0f ? 1000.0f / mean : 0.0f;
+}
+
+const char *frame_stats_series_name(frame_series_t series) {
+    return series < FRAME_SERIES_COUNT ? SERIES_NAMES[series] : "?";
+}
@@ -0,0 +1,111 @@
+/*
+ * Knight Engine 2D - Rolling Frame Statistics
+ *
+ * Keeps the last FRAME_STATS_WINDOW frames of frame time, work time and
+ * per-phase times in ring buffers and answers rolling queries in
+ * constant time:
+ *
+ *   mean      running sum over the window
+ *   min/max   monotonic queues of window positions (amortized O(1) push)
+ *   p95/p99   fixed-bucket histogram of the window - FRAME_STATS_OCTAVES
+ *             doublings from 1 us, FRAME_STATS_STEPS buckets each, so a
+ *             percentile is within ~9% and never above the window max
+ *
+ * Queries are cheap enough for the HUD, debug output, telemetry and
+ * benchmarks to read them every frame.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "core/config.h"
+
+/*
+ * Measured series - the whole frame, the work before present, and each
+ * phase of the engine loop
+ */
+typedef enum {
+    FRAME_SERIES_FRAME,    /* Wall time since the previous frame */
+    FRAME_SERIES_WORK,     /* Frame work before present */
+    FRAME_SERIES_INPUT,
+    FRAME_SERIES_SIM,
+    FRAME_SERIES_EVENTS,
+    FRAME_SERIES_AUDIO,
+    FRAME_SERIES_RENDER,
+    FRAME_SERIES_PRESENT,
+    FRAME_SERIES_COUNT
+} frame_series_t;
+
+#define FRAME_STATS_STEPS   8   /* Histogram buckets per doubling */
+#define FRAME_STATS_OCTAVES 20  /* 1 us to ~1 s */
+#define FRAME_STATS_BUCKETS (FRAME_STATS_STEPS * FRAME_STATS_OCTAVES)
+
+/*
+ * Rolling window of one series
+ */
+typedef struct {
+    float samples[FRAME_STATS_WINDOW];  /* Ring, oldest at head when full */
+    Uint8 bucket_of[FRAME_STATS_WINDOW];
+    Uint16 histogram[FRAME_STATS_BUCKETS];
+    double sum;
+    Uint32 pushed;                      /* Samples ever pushed */
+    int count;                          /* Samples in the window */
+    /* Monotonic queues of positions (pushed counts) - front is the min/max */
+    Uint32 min_queue[FRAME_STATS_WINDOW];
+    Uint32 max_queue[FRAME_STATS_WINDOW];
+    int min_head, min_count;
+    int max_head, max_count;
+} frame_window_t;
+
+/*
+ * One frame's times in milliseconds - a negative value marks a phase that
+ * didn't run (render and present of a skipped frame) and is left out
+ */
+typedef struct {
+    float ms[FRAME_SERIES_COUNT];
+} frame_sample_t;
+
+typedef struct {
+    frame_window_t series[FRAME_SERIES_COUNT];
+    Uint32 frames;                      /* Frames recorded since init */
+} frame_stats_t;
+
+/*
+ * Empty every window
+ */
+void frame_stats_init(frame_stats_t *fs);
+
+/*
+ * Add one frame, dropping the oldest once the window is full
+ */
+void frame_stats_record(frame_stats_t *fs, const frame_sample_t *sample);
+
+/*
+ * Add one value to a single series (benchmarks timing one thing)
+ */
+void frame_stats_push(frame_stats_t *fs, frame_series_t series, float ms);
+
+/*
+ * Rolling queries over the window - 0 when the series is empty
+ */
+float frame_stats_mean(const frame_stats_t *fs, frame_series_t series);
+float frame_stats_min(const frame_stats_t *fs, frame_series_t series);
+float frame_stats_max(const frame_stats_t *fs, frame_series_t series);
+
+/*
+ * Value below which fraction (0..1) of the window falls, e.g. 0.99
+ * Resolved to a histogram bucket's upper edge, capped at the window max.
+ */
+float frame_stats_percentile(const frame_stats_t *fs, frame_series_t series,
+                             float fraction);
+
+/*
+ * Frames per second from the mean frame time
+ */
+float frame_stats_fps(const frame_stats_t *fs);
+
+/*
+ * Short name of a series ("frame", "sim", ...)
+ */
+const char *frame_stats_series_name(frame_series_t series);
@@ -0,0 +1,322 @@
+/*
+ * Knight Engine 2D - Asynchronous Logger Implementation
+ */
+
+#include "util/log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#define LOG_THREAD_LOCAL __declspec(thread)
+#else
+#define LOG_THREAD_LOCAL _Thread_local
+#endif
+
+/*
+ * One queued line
+ */
+typedef struct {
+    Uint32 sequence;    /* Global call order, for merging the rings */
+    Uint8 level;
+    char text[LOG_LINE_MAX];
+} log_line_t;
+
+/*
+ * Single-producer/single-consumer ring - the owning thread writes, the
+ * writer thread (or a caller holding g_drain_lock) reads. Positions only
+ * grow; slot = position % size.
+ */
+typedef struct {
+    log_line_t lines[LOG_RING_LINES];
+    SDL_atomic_t write_pos;
+    SDL_atomic_t read_pos;
+    SDL_atomic_t owned;   /* 1 while a live thread writes here */
+} log_ring_t;
+
+static log_ring_t g_rings[LOG_MAX_THREADS];
+static SDL_TLSID g_ring_tls = 0;      /* Releases a thread's ring when it exits */
+static SDL_atomic_t g_sequence;
+static SDL_atomic_t g_dropped;
+static SDL_atomic_t g_wake_pending;   /* Set by the first line since the last drain */
+
+/* Ring index + 1 of the calling thread, 0 until one is claimed */
+static LOG_THREAD_LOCAL int t_ring = 0;
+
+static int g_level = LOG_DEFAULT_LEVEL;
+static bool g_category_disabled[LOG_CAT_COUNT];
+
+/* Writer thread */
+static SDL_Thread *g_thread = NULL;
+static SDL_sem *g_wake = NULL;         /* Lives from log_init to log_shutdown */
+static SDL_mutex *g_drain_lock = NULL; /* One thread drains the rings at a time */
+static SDL_atomic_t g_running;
+static FILE *g_file = NULL;           /* NULL writes to stdout/stderr */
+static Uint32 g_dropped_reported = 0;
+
+/*
+ * Write one line to its destination - writer thread, or the caller when
+ * the logger isn't running
+ */
+static void emit(int level, const char *text) {
+    if (g_file) {
+        fprintf(g_file, "%s\n", text);
+    } else {
+        FILE *out = level >= LOG_LEVEL_WARN ? stderr : stdout;
+        fputs(text, out);
+        fputc('\n', out);
+    }
+}
+
+/* SDL thread exit - the ring is claimable again once its lines are written */
+static void SDLCALL release_ring(void *data) {
+    SDL_AtomicSet(&g_rings[(intptr_t)data - 1].owned, 0);
+}
+
+/*
+ * The calling thread's ring, claimed on first use from the unowned rings
+ * that have been drained. Positions carry on from the previous owner, so
+ * the reader never sees them go back. NULL (and the line dropped) while
+ * every ring is in use; later calls try again.
+ */
+static log_ring_t *thread_ring(void) {
+    if (t_ring == 0) {
+        for (int r = 0; r < LOG_MAX_THREADS; r++) {
+            log_ring_t *ring = &g_rings[r];
+            if (SDL_AtomicGet(&ring->owned) ||
+                SDL_AtomicGet(&ring->read_pos) != SDL_AtomicGet(&ring->write_pos) ||
+                !SDL_AtomicCAS(&ring->owned, 0, 1)) {
+                continue;
+            }
+            t_ring = r + 1;
+            if (g_ring_tls) {
+                SDL_TLSSet(g_ring_tls, (void *)(intptr_t)t_ring, release_ring);
+            }
+            break;
+        }
+    }
+    return t_ring > 0 ? &g_rings[t_ring - 1] : NULL;
+}
+
+/*
+ * Emit queued lines from every ring in call order - see drain()
+ */
+static int drain_rings(void) {
+    /* Released rings too - their owner may have exited with lines queued */
+    int rings = LOG_MAX_THREADS;
+
+    /* Snapshot how far each ring has been written */
+    Uint32 read[LOG_MAX_THREADS];
+    Uint32 written[LOG_MAX_THREADS];
+    for (int r = 0; r < rings; r++) {
+        read[r] = (Uint32)SDL_AtomicGet(&g_rings[r].read_pos);
+        written[r] = (Uint32)SDL_AtomicGet(&g_rings[r].write_pos);
+    }
+
+    int count = 0;
+    for (;;) {
+        /* Oldest head across the rings - sequence differences survive wrap */
+        int pick = -1;
+        Uint32 oldest = 0;
+        for (int r = 0; r < rings; r++) {
+            if (read[r] == written[r]) {
+                continue;
+            }
+            Uint32 seq = g_rings[r].lines[read[r] % LOG_RING_LINES].sequence;
+            if (pick < 0 || (Sint32)(seq - oldest) < 0) {
+                pick = r;
+                oldest = seq;
+            }
+        }
+        if (pick < 0) {
+            break;
+        }
+
+        const log_line_t *line = &g_rings[pick].lines[read[pick] % LOG_RING_LINES];
+        emit(line->level, line->text);
+        read[pick]++;
+        SDL_AtomicSet(&g_rings[pick].read_pos, (int)read[pick]);
+        count++;
+    }
+
+    Uint32 dropped = (Uint32)SDL_AtomicGet(&g_dropped);
+    if (dropped != g_dropped_reported) {
+        char text[64];
+        snprintf(text, sizeof(text), "[LOG] %u lines dropped (%u total)",
+                 dropped - g_dropped_reported, dropped);
+        emit(LOG_LEVEL_WARN, text);
+        g_dropped_reported = dropped;
+    }
+
+    if (count > 0) {
+        fflush(g_file ? g_file : stdout);
+    }
+    return count;
+}
+
+/*
+ * Drained by the writer thread, and once it has stopped by whoever still
+ * finds lines queued. Returns the number of lines written.
+ */
+static int drain(void) {
+    if (g_drain_lock) {
+        SDL_LockMutex(g_drain_lock);
+    }
+    int count = drain_rings();
+    if (g_drain_lock) {
+        SDL_UnlockMutex(g_drain_lock);
+    }
+    return count;
+}
+
+static int SDLCALL writer_main(void *data) {
+    (void)data;
+    while (SDL_AtomicGet(&g_running)) {
+        SDL_SemWaitTimeout(g_wake, LOG_FLUSH_INTERVAL_MS);
+        /* Cleared first, so a line queued during the drain wakes us again */
+        SDL_AtomicSet(&g_wake_pending, 0);
+        drain();
+    }
+    return 0;
+}
+
+static bool start_writer(void) {
+    if (!g_wake || !g_drain_lock) {
+        return false;
+    }
+    SDL_AtomicSet(&g_running, 1);
+    g_thread = SDL_CreateThread(writer_main, "log", NULL);
+    if (!g_thread) {
+        fprintf(stderr, "Failed to start log thread: %s - logging synchronously\n",
+                SDL_GetError());
+        SDL_AtomicSet(&g_running, 0);
+        return false;
+    }
+    return true;
+}
+
+/* Stop the writer and write what it left - later lines go out directly.
+ * g_wake stays: other threads may be about to post it. */
+static void stop_writer(void) {
+    if (g_thread) {
+        SDL_AtomicSet(&g_running, 0);
+        SDL_SemPost(g_wake);
+        SDL_WaitThread(g_thread, NULL);
+        g_thread = NULL;
+    }
+
+    /* Anything queued after the writer's last pass */
+    drain();
+}
+
+bool log_init(const char *path) {
+    if (g_thread) {
+        return true;
+    }
+    if (path) {
+        g_file = fopen(path, "a");
+        if (!g_file) {
+            fprintf(stderr, "Failed to open log file %s - logging to the console\n", path);
+        }
+    }
+    if (!g_wake) {
+        g_wake = SDL_CreateSemaphore(0);
+    }
+    if (!g_drain_lock) {
+        g_drain_lock = SDL_CreateMutex();
+    }
+    if (!g_ring_tls) {
+        g_ring_tls = SDL_TLSCreate();  /* 0 on failure: rings are then never released */
+    }
+    if (!g_wake || !g_drain_lock) {
+        fprintf(stderr, "Failed to set up the log thread: %s - logging synchronously\n",
+                SDL_GetError());
+        return false;
+    }
+    return start_writer();
+}
+
+void log_shutdown(void) {
+    stop_writer();
+    if (g_wake) {
+        SDL_DestroySemaphore(g_wake);
+        g_wake = NULL;
+    }
+    if (g_drain_lock) {
+        SDL_DestroyMutex(g_drain_lock);
+        g_drain_lock = NULL;
+    }
+    if (g_file) {
+        fclose(g_file);
+        g_file = NULL;
+    }
+}
+
+bool log_set_async(bool async) {
+    if (async && !g_thread) {
+        start_writer();
+    } else if (!async && g_thread) {
+        stop_writer();
+    }
+    return g_thread != NULL;
+}
+
+void log_set_level(int level) {
+    g_level = level;
+}
+
+void log_set_category(log_category_t category, bool enabled) {
+    if (category < LOG_CAT_COUNT) {
+        g_category_disabled[category] = !enabled;
+    }
+}
+
+bool log_enabled(int level, log_category_t category) {
+    return level >= g_level && category < LOG_CAT_COUNT && !g_category_disabled[category];
+}
+
+void log_write(int level, log_category_t category, const char *fmt, ...) {
+    if (!log_enabled(level, category)) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+
+    /* Not running - write through, as printf did */
+    if (!SDL_AtomicGet(&g_running)) {
+        char text[LOG_LINE_MAX];
+        vsnprintf(text, sizeof(text), fmt, args);
+        va_end(args);
+        emit(level, text);
+        return;
+    }
+
+    log_ring_t *ring = thread_ring();
+    Uint32 write = ring ? (Uint32)SDL_AtomicGet(&ring->write_pos) : 0;
+    if (!ring || write - (Uint32)SDL_AtomicGet(&ring->read_pos) >= LOG_RING_LINES) {
+        va_end(args);
+        SDL_AtomicAdd(&g_dropped, 1);
+        return;
+    }
+
+    /* Format in place; the position store publishes the line */
+    log_line_t *line = &ring->lines[write % LOG_RING_LINES];
+    line->sequence = (Uint32)SDL_AtomicAdd(&g_sequence, 1);
+    line->level = (Uint8)level;
+    vsnprintf(line->text, sizeof(line->text), fmt, args);
+    va_end(args);
+    SDL_AtomicSet(&ring->write_pos, (int)(write + 1));
+
+    /* The writer stopped while the line was queued (log_set_async) - its
+     * last pass may have missed it, so write it out here */
+    if (!SDL_AtomicGet(&g_running)) {
+        drain();
+    } else if (SDL_AtomicCAS(&g_wake_pending, 0, 1)) {
+        SDL_SemPost(g_wake);
+    }
+}
+
+Uint32 log_dropped(void) {
+    return (Uint32)SDL_AtomicGet(&g_dropped);
+}
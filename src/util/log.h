@@ -0,0 +1,112 @@
+/*
+ * Knight Engine 2D - Asynchronous Logger
+ *
+ * Log calls format straight into a lock-free ring owned by the calling
+ * thread (one single-producer ring per thread, claimed on first use and
+ * released when a thread started with SDL_CreateThread exits) and
+ * return; a background thread merges the rings by call sequence and writes
+ * the lines to stdout/stderr or a file. A slow terminal or a full pipe
+ * stalls the writer thread, never the frame. When a ring is full the line
+ * is dropped and counted instead of blocking.
+ *
+ * Lines below LOG_COMPILE_LEVEL are compiled out entirely, arguments
+ * included. The rest are filtered at runtime by level and category.
+ * Before log_init, after log_shutdown and while asynchronous writing is
+ * switched off (log_set_async), lines are written directly.
+ *
+ * Messages are single lines without a trailing newline:
+ *
+ *   LOG_INFO(LOG_CAT_RENDER, "Loaded texture: %s", path);
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include "core/config.h"
+
+/* Levels - macros so LOG_COMPILE_LEVEL can be tested by the preprocessor */
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2  /* Warnings and errors go to stderr */
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_COUNT 4
+
+typedef enum {
+    LOG_CAT_ENGINE,     /* Lifecycle, input toggles */
+    LOG_CAT_STATS,      /* Periodic debug output and FPS log */
+    LOG_CAT_RENDER,     /* Renderer, command buffer, textures */
+    LOG_CAT_AUDIO,
+    LOG_CAT_GAME,       /* Gameplay systems: behaviors, events, transforms, stress test */
+    LOG_CAT_PHYSICS,
+    LOG_CAT_NAV,
+    LOG_CAT_TELEMETRY,
+    LOG_CAT_COUNT
+} log_category_t;
+
+/*
+ * Start the writer thread. path NULL writes to stdout/stderr, otherwise
+ * every line is appended to the file at path.
+ * Returns false if the file or thread can't be created; logging then
+ * stays synchronous.
+ */
+bool log_init(const char *path);
+
+/*
+ * Write everything still queued and stop the writer thread
+ */
+void log_shutdown(void);
+
+/*
+ * Switch between the writer thread and writing each line as it is logged
+ * (for comparing the two). Call from the main thread only.
+ * Returns whether lines are now queued for the writer thread.
+ */
+bool log_set_async(bool async);
+
+/*
+ * Runtime filters - lines below the level, or in a disabled category,
+ * are discarded before formatting
+ */
+void log_set_level(int level);
+void log_set_category(log_category_t category, bool enabled);
+
+/*
+ * Whether a line at this level and category would be kept
+ * For skipping expensive argument preparation.
+ */
+bool log_enabled(int level, log_category_t category);
+
+/*
+ * Queue one formatted line - use the LOG_* macros instead
+ */
+void log_write(int level, log_category_t category, const char *fmt, ...)
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    ;
+
+/*
+ * Lines dropped because their ring was full (or no ring was free)
+ */
+Uint32 log_dropped(void);
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(category, ...) log_write(LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(category, ...) log_write(LOG_LEVEL_INFO, category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) ((void)0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(category, ...) log_write(LOG_LEVEL_WARN, category, __VA_ARGS__)
+#else
+#define LOG_WARN(category, ...) ((void)0)
+#endif
+
+#define LOG_ERROR(category, ...) log_write(LOG_LEVEL_ERROR, category, __VA_ARGS__)
@@ -0,0 +1,287 @@
+/*
+ * Knight Engine 2D - Hardware Performance Counters Implementation
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  /* syscall() */
+#endif
+
+#include "util/perf_counters.h"
+#include "util/log.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__linux__)
+#define PERF_COUNTERS_LINUX 1
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define PERF_COUNTERS_LINUX 0
+#endif
+
+static const char *const COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "cache misses", "branch misses"
+};
+
+const char *perf_counter_name(perf_counter_t counter) {
+    return counter >= 0 && counter < PERF_COUNTER_COUNT ? COUNTER_NAMES[counter] : "?";
+}
+
+void perf_counters_init(perf_counters_t *pc) {
+    memset(pc, 0, sizeof(*pc));
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        pc->fd[c] = -1;
+        pc->slot[c] = -1;
+    }
+}
+
+#if PERF_COUNTERS_LINUX
+
+/* Group read with PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING */
+typedef struct {
+    Uint64 nr;
+    Uint64 time_enabled;
+    Uint64 time_running;
+    Uint64 values[PERF_COUNTER_COUNT];
+} group_read_t;
+
+static const Uint64 HW_EVENTS[PERF_COUNTER_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+static int open_event(Uint64 config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    /* The leader starts the whole group at once */
+    attr.disabled = group_fd < 0;
+    /* User space only - allowed at the default perf_event_paranoid of 2 */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+static int paranoid_level(void) {
+    int level = -99;
+    FILE *f = fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+    if (f) {
+        if (fscanf(f, "%d", &level) != 1) {
+            level = -99;
+        }
+        fclose(f);
+    }
+    return level;
+}
+
+static void log_unavailable(int err) {
+    if (err == EACCES || err == EPERM) {
+        int level = paranoid_level();
+        if (level != -99) {
+            LOG_WARN(LOG_CAT_STATS, "[PERF] Counters not permitted (kernel.perf_event_paranoid "
+                     "is %d; 2 or lower allows them)", level);
+        } else {
+            LOG_WARN(LOG_CAT_STATS, "[PERF] Counters not permitted: %s", strerror(err));
+        }
+    } else if (err == ENOENT || err == ENODEV || err == EOPNOTSUPP) {
+        LOG_WARN(LOG_CAT_STATS, "[PERF] No hardware counters on this CPU "
+                 "(virtual machines usually hide them)");
+    } else if (err == ENOSYS) {
+        LOG_WARN(LOG_CAT_STATS, "[PERF] Kernel has no perf_event_open");
+    } else {
+        LOG_WARN(LOG_CAT_STATS, "[PERF] Counters unavailable: %s", strerror(err));
+    }
+}
+
+bool perf_counters_open(perf_counters_t *pc) {
+    if (pc->available) {
+        return true;
+    }
+
+    /* Any event the CPU has can lead - the rest join its group */
+    int leader = -1;
+    int first_error = 0;
+    pc->opened = 0;
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        int fd = open_event(HW_EVENTS[c], leader);
+        if (fd < 0) {
+            if (!first_error) {
+                first_error = errno;
+            }
+            /* Permission applies to every event - no point trying the rest */
+            if (leader < 0 && (errno == EACCES || errno == EPERM || errno == ENOSYS)) {
+                break;
+            }
+            continue;
+        }
+        if (leader < 0) {
+            leader = fd;
+        }
+        pc->fd[c] = fd;
+        pc->slot[c] = pc->opened++;
+    }
+
+    if (leader < 0) {
+        log_unavailable(first_error);
+        perf_counters_close(pc);
+        return false;
+    }
+
+    if (ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP) < 0 ||
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) < 0) {
+        log_unavailable(errno);
+        perf_counters_close(pc);
+        return false;
+    }
+
+    pc->available = true;
+    char missing[64] = "";
+    int len = 0;
+    for (int c = 0; c < PERF_COUNTER_COUNT && len < (int)sizeof(missing); c++) {
+        if (pc->fd[c] < 0) {
+            len += snprintf(missing + len, sizeof(missing) - (size_t)len, "%s%s",
+                            len ? ", " : " (no ", COUNTER_NAMES[c]);
+        }
+    }
+    LOG_INFO(LOG_CAT_STATS, "[PERF] Counting %d hardware events%s%s", pc->opened,
+             missing, len ? ")" : "");
+    perf_counters_begin(pc);
+    return true;
+}
+
+void perf_counters_close(perf_counters_t *pc) {
+    /* Members before the leader */
+    for (int c = PERF_COUNTER_COUNT - 1; c >= 0; c--) {
+        if (pc->fd[c] >= 0) {
+            close(pc->fd[c]);
+        }
+        pc->fd[c] = -1;
+        pc->slot[c] = -1;
+    }
+    pc->opened = 0;
+    pc->available = false;
+}
+
+bool perf_counters_read(const perf_counters_t *pc, perf_sample_t *out) {
+    memset(out, 0, sizeof(*out));
+    if (!pc->available) {
+        return false;
+    }
+
+    /* The leader is the first event that opened */
+    int leader = -1;
+    for (int c = 0; c < PERF_COUNTER_COUNT && leader < 0; c++) {
+        leader = pc->fd[c];
+    }
+
+    group_read_t data;
+    ssize_t got = read(leader, &data, sizeof(data));
+    if (got < (ssize_t)(3 + pc->opened) * (ssize_t)sizeof(Uint64) ||
+        data.nr != (Uint64)pc->opened) {
+        return false;
+    }
+
+    out->time_enabled = data.time_enabled;
+    out->time_running = data.time_running;
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (pc->slot[c] >= 0) {
+            out->value[c] = data.values[pc->slot[c]];
+        }
+    }
+    return true;
+}
+
+#else
+
+bool perf_counters_open(perf_counters_t *pc) {
+    (void)pc;
+    LOG_WARN(LOG_CAT_STATS, "[PERF] Hardware counters are only supported on Linux");
+    return false;
+}
+
+void perf_counters_close(perf_counters_t *pc) {
+    pc->available = false;
+}
+
+bool perf_counters_read(const perf_counters_t *pc, perf_sample_t *out) {
+    (void)pc;
+    memset(out, 0, sizeof(*out));
+    return false;
+}
+
+#endif
+
+bool perf_counters_has(const perf_counters_t *pc, perf_counter_t counter) {
+    return pc->available && pc->slot[counter] >= 0;
+}
+
+void perf_counters_begin(perf_counters_t *pc) {
+    perf_counters_read(pc, &pc->last);
+}
+
+void perf_counters_mark(perf_counters_t *pc, int region) {
+    perf_sample_t now;
+    if (!perf_counters_read(pc, &now)) {
+        return;
+    }
+
+    /* Scale up when the group was multiplexed off the PMU part of the time */
+    perf_sample_t *total = &pc->totals[region];
+    Uint64 enabled = now.time_enabled - pc->last.time_enabled;
+    Uint64 running = now.time_running - pc->last.time_running;
+    double scale = running > 0 ? (double)enabled / (double)running : 0.0;
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        total->value[c] += (Uint64)((double)(now.value[c] - pc->last.value[c]) * scale + 0.5);
+    }
+    total->time_enabled += enabled;
+    total->time_running += running;
+    pc->marks[region]++;
+    pc->last = now;
+}
+
+void perf_counters_reset(perf_counters_t *pc) {
+    memset(pc->totals, 0, sizeof(pc->totals));
+    memset(pc->marks, 0, sizeof(pc->marks));
+}
+
+const char *perf_counters_format(const perf_counters_t *pc, int region, double entities,
+                                 const char *unit, char *out, size_t size) {
+    const perf_sample_t *t = &pc->totals[region];
+    out[0] = '\0';
+    if (!pc->available || pc->marks[region] == 0 || t->time_enabled == 0) {
+        return out;
+    }
+
+    char ipc[16] = "-";
+    char cache[16] = "-";
+    char branch[16] = "-";
+    double per = entities > 0.0 ? 1.0 / entities : 0.0;
+    if (perf_counters_has(pc, PERF_CYCLES) && perf_counters_has(pc, PERF_INSTRUCTIONS) &&
+        t->value[PERF_CYCLES] > 0) {
+        snprintf(ipc, sizeof(ipc), "%.2f",
+                 (double)t->value[PERF_INSTRUCTIONS] / (double)t->value[PERF_CYCLES]);
+    }
+    if (perf_counters_has(pc, PERF_CACHE_MISSES) && per > 0.0) {
+        snprintf(cache, sizeof(cache), "%.3f", (double)t->value[PERF_CACHE_MISSES] * per);
+    }
+    if (perf_counters_has(pc, PERF_BRANCH_MISSES) && per > 0.0) {
+        snprintf(branch, sizeof(branch), "%.3f", (double)t->value[PERF_BRANCH_MISSES] * per);
+    }
+
+    int len = snprintf(out, size, "IPC %s | %s cache / %s branch misses per %s", ipc, cache,
+                       branch, unit);
+    if (t->time_running < t->time_enabled && len >= 0 && (size_t)len < size) {
+        snprintf(out + len, size - (size_t)len, " (scaled, counted %.0f%% of the time)",
+                 (double)t->time_running * 100.0 / (double)t->time_enabled);
+    }
+    return out;
+}
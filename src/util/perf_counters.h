@@ -0,0 +1,113 @@
+/*
+ * Knight Engine 2D - Hardware Performance Counters
+ *
+ * Wall-clock time says a phase is slow, not why. This opens one
+ * perf_event_open group - cycles, instructions, cache misses and branch
+ * misses - on the calling thread and reads all four with a single read()
+ * at region boundaries:
+ *
+ *   perf_counters_begin(&pc);
+ *   game_update(...);             perf_counters_mark(&pc, REGION_SIM);
+ *   render_cmd_sort(...);         perf_counters_mark(&pc, REGION_SORT);
+ *
+ * Each mark adds the counts since the previous mark to that region's
+ * totals. Low IPC with many cache misses per entity means a phase waits
+ * on memory; high IPC means it is compute-bound.
+ *
+ * Only user-space events of the opening thread are counted - worker
+ * threads and time in the kernel or driver (present) are not. When the
+ * kernel multiplexes the group with other perf users the counts are
+ * scaled by the time it was scheduled.
+ *
+ * Counters are unavailable on other platforms, in most virtual machines
+ * and when kernel.perf_event_paranoid forbids them; open then logs why
+ * and returns false, and every other call does nothing. Events the CPU
+ * lacks are left out of the group.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "core/config.h"
+
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,     /* Last-level cache misses */
+    PERF_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+} perf_counter_t;
+
+/*
+ * Counter values - raw since open when read, scaled counts when a
+ * region total
+ */
+typedef struct {
+    Uint64 value[PERF_COUNTER_COUNT];
+    Uint64 time_enabled;   /* ns the group was enabled */
+    Uint64 time_running;   /* ns it was actually on the PMU */
+} perf_sample_t;
+
+typedef struct {
+    bool available;                 /* Group open and readable */
+    int fd[PERF_COUNTER_COUNT];     /* -1 when not opened */
+    int slot[PERF_COUNTER_COUNT];   /* Position in the group read, -1 if absent */
+    int opened;                     /* Events in the group */
+    perf_sample_t last;             /* At the previous begin/mark */
+    perf_sample_t totals[PERF_COUNTERS_MAX_REGIONS];  /* Since the last reset */
+    Uint32 marks[PERF_COUNTERS_MAX_REGIONS];
+} perf_counters_t;
+
+/*
+ * Set up closed counters - no system calls
+ */
+void perf_counters_init(perf_counters_t *pc);
+
+/*
+ * Open and start the counter group on the calling thread
+ * Returns false, with the reason logged, when counters are unavailable.
+ */
+bool perf_counters_open(perf_counters_t *pc);
+
+/*
+ * Close the group; totals are kept
+ */
+void perf_counters_close(perf_counters_t *pc);
+
+/*
+ * Read every counter at once - false when unavailable or the read fails
+ */
+bool perf_counters_read(const perf_counters_t *pc, perf_sample_t *out);
+
+/*
+ * Whether an event made it into the group
+ */
+bool perf_counters_has(const perf_counters_t *pc, perf_counter_t counter);
+
+/*
+ * Start counting from here - the next mark measures from this point
+ */
+void perf_counters_begin(perf_counters_t *pc);
+
+/*
+ * Add the counts since the previous begin/mark to region
+ */
+void perf_counters_mark(perf_counters_t *pc, int region);
+
+/*
+ * Zero the region totals
+ */
+void perf_counters_reset(perf_counters_t *pc);
+
+/*
+ * Describe a region total - "IPC 1.42 | 0.120 cache / 0.031 branch misses
+ * per sprite". entities is what the region processed summed over its
+ * marks (sprites per frame times frames), unit names it. Writes "" when
+ * the region counted nothing. Returns out.
+ */
+const char *perf_counters_format(const perf_counters_t *pc, int region, double entities,
+                                 const char *unit, char *out, size_t size);
+
+const char *perf_counter_name(perf_counter_t counter);
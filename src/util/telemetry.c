@@ -0,0 +1,139 @@
+/*
+ * Knight Engine 2D - Telemetry Export Implementation
+ */
+
+#include "util/telemetry.h"
+#include "core/config.h"
+#include "util/log.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TELEMETRY_POSIX 1
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#else
+#define TELEMETRY_POSIX 0
+#endif
+
+#if TELEMETRY_POSIX
+
+bool telemetry_init(telemetry_t *tel, const char *path) {
+    memset(tel, 0, sizeof(*tel));
+    tel->fd = -1;
+
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path) || strlen(path) >= sizeof(tel->path)) {
+        LOG_ERROR(LOG_CAT_TELEMETRY, "Telemetry socket path too long: %s", path);
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        LOG_ERROR(LOG_CAT_TELEMETRY, "Failed to create telemetry socket: %s", strerror(errno));
+        return false;
+    }
+
+    /* Non-blocking, so a full reader queue drops the line instead of
+     * stalling the frame */
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        LOG_ERROR(LOG_CAT_TELEMETRY,
+                  "Failed to make telemetry socket non-blocking: %s", strerror(errno));
+        close(fd);
+        return false;
+    }
+#ifdef FD_CLOEXEC
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+#endif
+
+    tel->fd = fd;
+    strcpy(tel->path, path);
+    LOG_INFO(LOG_CAT_TELEMETRY, "Telemetry: publishing to %s", path);
+    return true;
+}
+
+void telemetry_cleanup(telemetry_t *tel) {
+    if (tel->fd >= 0) {
+        close(tel->fd);
+    }
+    tel->fd = -1;
+}
+
+bool telemetry_publish(telemetry_t *tel, const telemetry_frame_t *frame) {
+    if (tel->fd < 0) {
+        return false;
+    }
+    if (frame->frame < tel->retry_frame) {
+        tel->dropped++;
+        return false;
+    }
+
+    char line[1024];
+    int len = snprintf(line, sizeof(line),
+                       "frame=%u ms=%.3f work=%.3f input=%.3f sim=%.3f events=%.3f "
+                       "audio=%.3f render=%.3f present=%.3f steps=%d sprites=%d "
+                       "culled=%d bodies=%d awake=%d cmds=%d draws=%u binds=%u color_changes=%u "
+                       "state_changes=%u verts=%u pixels=%llu tex_bytes=%lu tex_saved=%lu "
+                       "allocs=%u alloc_bytes=%llu presented=%d cpu=%.1f p95=%.3f p99=%.3f "
+                       "cvars=%u dropped=%u\n",
+                       frame->frame, frame->frame_ms, frame->work_ms, frame->input_ms,
+                       frame->sim_ms, frame->events_ms, frame->audio_ms,
+                       frame->render_ms, frame->present_ms, frame->sim_steps,
+                       frame->sprites, frame->sprites_culled, frame->bodies, frame->bodies_awake,
+                       frame->render_cmds, frame->draw_calls, frame->texture_binds,
+                       frame->color_changes, frame->state_changes, frame->vertices,
+                       (unsigned long long)frame->pixels, (unsigned long)frame->texture_bytes,
+                       (unsigned long)frame->texture_saved,
+                       frame->allocs, (unsigned long long)frame->alloc_bytes,
+                       frame->presented ? 1 : 0, frame->cpu_percent,
+                       frame->frame_p95_ms, frame->frame_p99_ms, frame->cvar_changes,
+                       tel->dropped);
+    if (len <= 0 || len >= (int)sizeof(line)) {
+        return false;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, tel->path, sizeof(tel->path));
+
+    ssize_t sent = sendto(tel->fd, line, (size_t)len, 0,
+                          (const struct sockaddr *)&addr, sizeof(addr));
+    if (sent != len) {
+        /* No reader bound (ENOENT/ECONNREFUSED) - back off before retrying.
+         * A full reader queue (EAGAIN) just loses this line. */
+        if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            tel->retry_frame = frame->frame + TELEMETRY_RETRY_FRAMES;
+        }
+        tel->dropped++;
+        return false;
+    }
+
+    tel->sent++;
+    return true;
+}
+
+#else /* !TELEMETRY_POSIX */
+
+bool telemetry_init(telemetry_t *tel, const char *path) {
+    (void)path;
+    memset(tel, 0, sizeof(*tel));
+    tel->fd = -1;
+    return false;
+}
+
+void telemetry_cleanup(telemetry_t *tel) {
+    tel->fd = -1;
+}
+
+bool telemetry_publish(telemetry_t *tel, const telemetry_frame_t *frame) {
+    (void)tel;
+    (void)frame;
+    return false;
+}
+
+#endif
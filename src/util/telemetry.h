@@ -0,0 +1,87 @@
+/*
+ * Knight Engine 2D - Telemetry Export
+ *
+ * Publishes one line of per-frame metrics to a local Unix domain datagram
+ * socket, for dashboards and the knight_telemetry reader to pick up:
+ *
+ *   frame=1234 ms=16.668 work=3.210 input=0.012 sim=1.104 ... sprites=153
+ *
+ * Each line is space-separated key=value pairs, numbers only, so readers
+ * can aggregate fields they don't know about. The socket is non-blocking
+ * and datagrams are fire-and-forget: with no reader bound to the path, or
+ * a reader that falls behind, lines are dropped and counted, never queued
+ * on the frame. After a failed send the engine waits TELEMETRY_RETRY_FRAMES
+ * before trying again, so an absent reader costs one syscall per second.
+ *
+ * POSIX only; elsewhere every call is a no-op.
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+/*
+ * One frame's metrics - filled by the engine, all times in milliseconds
+ */
+typedef struct {
+    Uint32 frame;
+    float frame_ms;       /* Wall time since the previous frame */
+    float work_ms;        /* Frame work before present */
+    float input_ms;
+    float sim_ms;         /* Fixed-step updates */
+    float events_ms;
+    float audio_ms;
+    float render_ms;      /* Record, sort and execute */
+    float present_ms;     /* Includes the vsync wait */
+    int sim_steps;
+    int sprites;
+    int sprites_culled;   /* Outside the view, not recorded */
+    int bodies;           /* Physics bodies (0 when the demo is off) */
+    int bodies_awake;
+    int render_cmds;      /* Commands recorded this frame */
+    Uint32 draw_calls;    /* Renderer statistics, see renderer_stats_t */
+    Uint32 texture_binds;
+    Uint32 color_changes;
+    Uint32 state_changes;
+    Uint32 vertices;
+    Uint64 pixels;
+    size_t texture_bytes;
+    size_t texture_saved; /* Bytes saved by formats below 32-bit */
+    Uint32 allocs;        /* Main-thread heap allocations (last full frame) */
+    Uint64 alloc_bytes;
+    bool presented;       /* False when the frame was unchanged or hidden */
+    float cpu_percent;    /* Process CPU use over the last debug interval */
+    float frame_p95_ms;   /* Rolling frame time percentiles, see frame_stats.h */
+    float frame_p99_ms;
+    Uint32 cvar_changes;  /* Settings changes so far - a new value starts a new A/B segment */
+} telemetry_frame_t;
+
+/*
+ * Telemetry publisher state
+ */
+typedef struct {
+    int fd;                 /* Datagram socket, -1 when disabled */
+    char path[108];         /* Reader's socket path (sun_path size) */
+    Uint32 retry_frame;     /* Next frame a send is attempted after a failure */
+    Uint32 sent;
+    Uint32 dropped;         /* No reader, or the reader's queue was full */
+} telemetry_t;
+
+/*
+ * Create the non-blocking socket that sends to path
+ * The reader does not need to exist yet. Returns false (and leaves
+ * telemetry disabled) if sockets are unavailable.
+ */
+bool telemetry_init(telemetry_t *tel, const char *path);
+
+/*
+ * Close the socket
+ */
+void telemetry_cleanup(telemetry_t *tel);
+
+/*
+ * Send one frame's metrics - never blocks
+ * Returns true if the line was handed to the reader.
+ */
+bool telemetry_publish(telemetry_t *tel, const telemetry_frame_t *frame);
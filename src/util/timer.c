@@ -3,27 +3,17 @@
  */
 
 #include "util/timer.h"
-#include <stdbool.h>
+#include <time.h>
 
-void fps_counter_init(fps_counter_t *fps) {
-    fps->last_time = SDL_GetTicks();
-    fps->frame_count = 0;
-    fps->current_fps = 0.0f;
+Uint64 timer_now(void) {
+    return SDL_GetPerformanceCounter();
 }
 
-bool fps_counter_update(fps_counter_t *fps, Uint32 current_time) {
-    fps->frame_count++;
-
-    if (current_time - fps->last_time >= FPS_UPDATE_INTERVAL) {
-        fps->current_fps = fps->frame_count * 1000.0f / (current_time - fps->last_time);
-        fps->frame_count = 0;
-        fps->last_time = current_time;
-        return true;
-    }
-
-    return false;
+float timer_elapsed_ms(Uint64 start, Uint64 end) {
+    return (float)((double)(end - start) * 1000.0 /
+                   (double)SDL_GetPerformanceFrequency());
 }
 
-float fps_counter_get(const fps_counter_t *fps) {
-    return fps->current_fps;
+double timer_cpu_seconds(void) {
+    return (double)clock() / CLOCKS_PER_SEC;
 }
@@ -1,36 +1,26 @@
 /*
  * Knight Engine 2D - Timer Utilities
  *
- * FPS tracking and time management utilities.
+ * High-resolution timestamps and CPU time. Rolling frame rate and frame
+ * time statistics live in util/frame_stats.h.
  */
 
 #pragma once
 
 #include <SDL2/SDL.h>
-#include <stdbool.h>
-#include "core/config.h"
 
 /*
- * FPS counter state - tracks frame rate over time
+ * Get a high-resolution timestamp (performance counter ticks)
  */
-typedef struct {
-    Uint32 last_time;    /* Last time FPS was calculated */
-    int frame_count;     /* Frames since last calculation */
-    float current_fps;   /* Most recent calculated FPS */
-} fps_counter_t;
+Uint64 timer_now(void);
 
 /*
- * Initialize FPS counter
+ * Milliseconds elapsed between two timer_now() timestamps
  */
-void fps_counter_init(fps_counter_t *fps);
+float timer_elapsed_ms(Uint64 start, Uint64 end);
 
 /*
- * Update FPS counter - call once per frame
- * Returns true if FPS was recalculated this frame
+ * Processor time used by the whole process so far, in seconds
+ * Per clock(): all threads on POSIX systems, wall time on Windows.
  */
-bool fps_counter_update(fps_counter_t *fps, Uint32 current_time);
-
-/*
- * Get current FPS value
- */
-float fps_counter_get(const fps_counter_t *fps);
+double timer_cpu_seconds(void);
@@ -0,0 +1,549 @@
+/*
+ * Knight Engine 2D - Benchmark Harness
+ *
+ * Headless timing for engine modules. Nothing opens a window; rendering
+ * goes through a software renderer drawing into a surface. Each benchmark
+ * prints one or more result lines. Where Linux hardware counters are
+ * available, indented lines under a result give its IPC and cache and
+ * branch misses per entity (util/perf_counters.h).
+ *
+ *   knight_bench                 run every benchmark
+ *   knight_bench flow_field ...  run only the named benchmarks
+ */
+
+#include "core/config.h"
+#include "core/sim_batch.h"
+#include "graphics/render_cmd.h"
+#include "graphics/renderer.h"
+#include "graphics/texture.h"
+#include "nav/flow_field.h"
+#include "physics/physics.h"
+#include "util/frame_stats.h"
+#include "util/perf_counters.h"
+#include "util/timer.h"
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+} bench_t;
+
+/* Hardware counters, opened once - unavailable leaves them all at zero */
+static perf_counters_t g_perf;
+
+enum {
+    BENCH_PERF_RUN,        /* The whole measured loop */
+    BENCH_PERF_RECORD,     /* Render passes: recording commands */
+    BENCH_PERF_SORT,       /* render_cmd_sort */
+    BENCH_PERF_EXECUTE     /* renderer_execute and present */
+};
+
+/*
+ * Print a region's counters since perf_counters_reset under the result
+ * line - nothing when counters are unavailable
+ */
+static void bench_perf_report(const char *label, int region, double entities,
+                              const char *unit) {
+    char text[160];
+    if (perf_counters_format(&g_perf, region, entities, unit, text, sizeof(text))[0]) {
+        printf("    %-8s %s\n", label, text);
+    }
+}
+
+/* ============================================================================
+ * FLOW FIELD
+ * ============================================================================ */
+
+#define BENCH_FLOW_GRID      256     /* Cells per side */
+#define BENCH_FLOW_CELL      16.0f
+#define BENCH_FLOW_BLOCKED   20      /* Percent of cells that are walls */
+#define BENCH_FLOW_BUILDS    50
+#define BENCH_FLOW_AGENTS    100000
+#define BENCH_FLOW_PASSES    50
+
+static void bench_flow_field(void) {
+    flow_field_t field;
+    float world = BENCH_FLOW_GRID * BENCH_FLOW_CELL;
+
+    if (!flow_field_init(&field, 0.0f, 0.0f, BENCH_FLOW_GRID, BENCH_FLOW_GRID, BENCH_FLOW_CELL)) {
+        return;
+    }
+
+    srand(1234);
+    for (int y = 0; y < BENCH_FLOW_GRID; y++) {
+        for (int x = 0; x < BENCH_FLOW_GRID; x++) {
+            flow_field_set_blocked(&field, x, y, rand() % 100 < BENCH_FLOW_BLOCKED);
+        }
+    }
+
+    /* First build also caches the legal moves around the walls */
+    flow_field_update(&field, world * 0.5f, world * 0.5f);
+    printf("flow_field: first build %dx%d (%d%% walls, includes obstacle pass): %.3f ms\n",
+           BENCH_FLOW_GRID, BENCH_FLOW_GRID, BENCH_FLOW_BLOCKED, field.last_build_ms);
+
+    /* Rebuilds toward random targets, as when the target changes cell */
+    float total_ms = 0.0f, min_ms = 1e9f, max_ms = 0.0f;
+    int builds = 0;
+    for (int i = 0; i < BENCH_FLOW_BUILDS; i++) {
+        float tx = (float)(rand() % (int)world);
+        float ty = (float)(rand() % (int)world);
+        if (!flow_field_update(&field, tx, ty)) {
+            continue;
+        }
+
+        total_ms += field.last_build_ms;
+        min_ms = field.last_build_ms < min_ms ? field.last_build_ms : min_ms;
+        max_ms = field.last_build_ms > max_ms ? field.last_build_ms : max_ms;
+        builds++;
+    }
+    printf("flow_field: rebuild on target change x %d: avg %.3f ms, min %.3f ms, max %.3f ms\n",
+           builds, total_ms / (builds > 0 ? builds : 1), min_ms, max_ms);
+
+    /* Batch sampling over agents scattered across the grid */
+    float *xs = malloc(sizeof(float) * BENCH_FLOW_AGENTS);
+    float *ys = malloc(sizeof(float) * BENCH_FLOW_AGENTS);
+    float *dx = malloc(sizeof(float) * BENCH_FLOW_AGENTS);
+    float *dy = malloc(sizeof(float) * BENCH_FLOW_AGENTS);
+    if (xs && ys && dx && dy) {
+        for (int i = 0; i < BENCH_FLOW_AGENTS; i++) {
+            xs[i] = (float)rand() / RAND_MAX * world;
+            ys[i] = (float)rand() / RAND_MAX * world;
+        }
+
+        double checksum = 0.0;
+        perf_counters_reset(&g_perf);
+        Uint64 start = timer_now();
+        perf_counters_begin(&g_perf);
+        for (int pass = 0; pass < BENCH_FLOW_PASSES; pass++) {
+            flow_field_sample(&field, xs, ys, BENCH_FLOW_AGENTS, dx, dy);
+            checksum += dx[pass] + dy[pass];
+        }
+        perf_counters_mark(&g_perf, BENCH_PERF_RUN);
+        float ms = timer_elapsed_ms(start, timer_now());
+
+        printf("flow_field: sample %d agents x %d: %.3f ms/pass, %.2f ns/agent (checksum %.1f)\n",
+               BENCH_FLOW_AGENTS, BENCH_FLOW_PASSES, ms / BENCH_FLOW_PASSES,
+               ms * 1e6f / ((float)BENCH_FLOW_AGENTS * BENCH_FLOW_PASSES), checksum);
+        bench_perf_report("sample:", BENCH_PERF_RUN,
+                          (double)BENCH_FLOW_AGENTS * BENCH_FLOW_PASSES, "agent");
+    }
+
+    free(xs);
+    free(ys);
+    free(dx);
+    free(dy);
+    flow_field_cleanup(&field);
+}
+
+/* ============================================================================
+ * PHYSICS
+ * ============================================================================ */
+
+#define BENCH_PHYSICS_COLUMNS  500
+#define BENCH_PHYSICS_ROWS     10
+#define BENCH_PHYSICS_BOX      16.0f
+#define BENCH_PHYSICS_SPACING  24.0f
+#define BENCH_PHYSICS_MAX_STEPS 3000
+#define BENCH_PHYSICS_REST_STEPS 300
+
+typedef struct {
+    float total_ms, max_ms;
+    int steps;
+    double body_steps;   /* Bodies summed over the steps, for the counters */
+} bench_span_t;
+
+static void bench_physics_step(physics_world_t *world, bench_span_t *span) {
+    Uint64 start = timer_now();
+    perf_counters_begin(&g_perf);
+    physics_world_step(world, FIXED_TIMESTEP);
+    perf_counters_mark(&g_perf, BENCH_PERF_RUN);
+    float ms = timer_elapsed_ms(start, timer_now());
+
+    span->total_ms += ms;
+    span->max_ms = ms > span->max_ms ? ms : span->max_ms;
+    span->steps++;
+    span->body_steps += world->body_count;
+}
+
+static void bench_physics_report(const char *label, const bench_span_t *span,
+                                 const physics_world_t *world) {
+    printf("physics: %-24s %5d steps: avg %.3f ms, max %.3f ms "
+           "(now %d awake, %d islands, %d contacts)\n",
+           label, span->steps, span->total_ms / (span->steps > 0 ? span->steps : 1),
+           span->max_ms, world->stat_awake, world->stat_islands, world->stat_contacts);
+    bench_perf_report("step:", BENCH_PERF_RUN, span->body_steps, "body");
+    perf_counters_reset(&g_perf);
+}
+
+static void bench_physics(void) {
+    int boxes = BENCH_PHYSICS_COLUMNS * BENCH_PHYSICS_ROWS;
+    float width = BENCH_PHYSICS_COLUMNS * BENCH_PHYSICS_SPACING;
+    float height = BENCH_PHYSICS_ROWS * BENCH_PHYSICS_SPACING;
+    physics_world_t world;
+
+    if (!physics_world_init(&world, boxes + 3, 0.0f, PHYSICS_GRAVITY)) {
+        return;
+    }
+
+    /* Floor at y = 0 with walls, boxes in offset rows above it - even
+     * boxes axis-aligned, odd ones oriented and slightly tilted */
+    physics_body_def_t floor_def = { width * 0.5f, 20.0f, width + 80.0f, 40.0f,
+                                     0.0f, 0.0f, 0.6f, 0.0f, true };
+    physics_body_def_t left_def = { -20.0f, -height, 40.0f, height * 2.0f + 80.0f,
+                                    0.0f, 0.0f, 0.6f, 0.0f, true };
+    physics_body_def_t right_def = left_def;
+    right_def.x = width + 20.0f;
+    physics_body_add(&world, &floor_def);
+    physics_body_add(&world, &left_def);
+    physics_body_add(&world, &right_def);
+
+    for (int row = 0; row < BENCH_PHYSICS_ROWS; row++) {
+        for (int col = 0; col < BENCH_PHYSICS_COLUMNS; col++) {
+            int k = row * BENCH_PHYSICS_COLUMNS + col;
+            physics_body_def_t def;
+            def.x = (col + 0.5f) * BENCH_PHYSICS_SPACING + ((row & 1) ? 4.0f : -4.0f);
+            def.y = -BENCH_PHYSICS_BOX - row * BENCH_PHYSICS_SPACING;
+            def.width = BENCH_PHYSICS_BOX;
+            def.height = BENCH_PHYSICS_BOX;
+            def.angle = (k % 2) ? 0.1f * (float)(k % 7 - 3) : 0.0f;
+            def.density = 1.0f;
+            def.friction = 0.6f;
+            def.restitution = 0.1f;
+            def.aabb = (k % 2) == 0;
+            physics_body_add(&world, &def);
+        }
+    }
+
+    /* Falling and piling up, then settling until every island sleeps */
+    bench_span_t impact = { 0 }, settle = { 0 }, rest = { 0 }, wake = { 0 };
+    for (int i = 0; i < 60; i++) {
+        bench_physics_step(&world, &impact);
+    }
+    bench_physics_report("first second (impact):", &impact, &world);
+
+    while (world.stat_awake > 0 && settle.steps < BENCH_PHYSICS_MAX_STEPS) {
+        bench_physics_step(&world, &settle);
+    }
+    bench_physics_report("settling until asleep:", &settle, &world);
+
+    /* A sleeping pile should cost next to nothing */
+    for (int i = 0; i < BENCH_PHYSICS_REST_STEPS; i++) {
+        bench_physics_step(&world, &rest);
+    }
+    bench_physics_report("at rest:", &rest, &world);
+
+    /* Knock one box in the middle: only its island wakes */
+    physics_body_apply_impulse(&world, 3 + BENCH_PHYSICS_COLUMNS / 2, 0.0f, -50000.0f);
+    for (int i = 0; i < BENCH_PHYSICS_REST_STEPS; i++) {
+        bench_physics_step(&world, &wake);
+    }
+    bench_physics_report("after waking one box:", &wake, &world);
+    printf("physics: %d boxes, %d sleeping\n", boxes, physics_sleeping_count(&world));
+
+    physics_world_cleanup(&world);
+}
+
+/* ============================================================================
+ * RENDER
+ * ============================================================================ */
+
+#define BENCH_RENDER_WIDTH    800
+#define BENCH_RENDER_HEIGHT   600
+#define BENCH_RENDER_SPRITES  4000
+#define BENCH_RENDER_TEXTURES 8
+#define BENCH_RENDER_SIZE     32
+#define BENCH_RENDER_FRAMES   60
+
+/* Per-frame times of the current pass - static, it's too large for the stack */
+static frame_stats_t g_render_frames;
+
+static void bench_render_perf_report(void) {
+    double sprites = (double)BENCH_RENDER_SPRITES * BENCH_RENDER_FRAMES;
+    bench_perf_report("record:", BENCH_PERF_RECORD, sprites, "sprite");
+    bench_perf_report("sort:", BENCH_PERF_SORT, sprites, "sprite");
+    bench_perf_report("execute:", BENCH_PERF_EXECUTE, sprites, "sprite");
+}
+
+/*
+ * Draw the same random sprites for a number of frames through the
+ * software renderer, with or without material bits in the sort key
+ */
+static void bench_render_pass(renderer_t *rend, render_cmd_buffer_t *cmds,
+                              SDL_Texture **textures, const SDL_Rect *rects,
+                              const int *texture_of, bool by_material) {
+    frame_stats_init(&g_render_frames);
+    perf_counters_reset(&g_perf);
+    for (int f = 0; f < BENCH_RENDER_FRAMES; f++) {
+        Uint64 start = timer_now();
+        perf_counters_begin(&g_perf);
+        render_cmd_reset(cmds);
+        render_cmd_clear(cmds, 0, 0, 0);
+        for (int i = 0; i < BENCH_RENDER_SPRITES; i++) {
+            SDL_Texture *tex = textures[texture_of[i]];
+            Uint16 material = by_material ? render_material_from_texture(tex) : 0;
+            render_cmd_quad(cmds, render_key(RENDER_LAYER_WORLD, 0, material), tex,
+                            NULL, &rects[i], 0.0, NULL, SDL_FLIP_NONE, 255, 255, 255);
+        }
+        perf_counters_mark(&g_perf, BENCH_PERF_RECORD);
+        render_cmd_sort(cmds);
+        perf_counters_mark(&g_perf, BENCH_PERF_SORT);
+        renderer_execute(rend, cmds);
+        renderer_present(rend);
+        perf_counters_mark(&g_perf, BENCH_PERF_EXECUTE);
+        frame_stats_push(&g_render_frames, FRAME_SERIES_FRAME,
+                         timer_elapsed_ms(start, timer_now()));
+    }
+
+    float ms = frame_stats_mean(&g_render_frames, FRAME_SERIES_FRAME);
+    float p99 = frame_stats_percentile(&g_render_frames, FRAME_SERIES_FRAME, 0.99f);
+    const renderer_stats_t *stats = renderer_get_stats(rend);
+    printf("render: %d sprites, %s: %.3f ms/frame (p99 %.3f) | %u draws | "
+           "%u texture binds | %u color changes | %u vertices | %.2fx overdraw\n",
+           BENCH_RENDER_SPRITES, by_material ? "sorted by texture" : "submission order",
+           ms, p99, stats->draw_calls, stats->texture_binds, stats->color_changes,
+           stats->vertices, renderer_overdraw(rend));
+    bench_render_perf_report();
+}
+
+/*
+ * Draw the same sprites as solid-color quads: no textures, one batch
+ */
+static void bench_render_solid_pass(renderer_t *rend, render_cmd_buffer_t *cmds,
+                                    const SDL_Rect *rects, const int *texture_of) {
+    frame_stats_init(&g_render_frames);
+    perf_counters_reset(&g_perf);
+    for (int f = 0; f < BENCH_RENDER_FRAMES; f++) {
+        Uint64 start = timer_now();
+        perf_counters_begin(&g_perf);
+        render_cmd_reset(cmds);
+        render_cmd_clear(cmds, 0, 0, 0);
+        for (int i = 0; i < BENCH_RENDER_SPRITES; i++) {
+            int t = texture_of[i];
+            render_cmd_solid_quad(cmds, render_key(RENDER_LAYER_WORLD, 0, 0), &rects[i],
+                                  0.0, NULL, (Uint8)(t * 32), 128, (Uint8)(255 - t * 32));
+        }
+        perf_counters_mark(&g_perf, BENCH_PERF_RECORD);
+        render_cmd_sort(cmds);
+        perf_counters_mark(&g_perf, BENCH_PERF_SORT);
+        renderer_execute(rend, cmds);
+        renderer_present(rend);
+        perf_counters_mark(&g_perf, BENCH_PERF_EXECUTE);
+        frame_stats_push(&g_render_frames, FRAME_SERIES_FRAME,
+                         timer_elapsed_ms(start, timer_now()));
+    }
+
+    float ms = frame_stats_mean(&g_render_frames, FRAME_SERIES_FRAME);
+    float p99 = frame_stats_percentile(&g_render_frames, FRAME_SERIES_FRAME, 0.99f);
+    const renderer_stats_t *stats = renderer_get_stats(rend);
+    printf("render: %d sprites, solid color: %.3f ms/frame (p99 %.3f) | %u draws | "
+           "%u texture binds | %u color changes | %u vertices | %.2fx overdraw\n",
+           BENCH_RENDER_SPRITES, ms, p99, stats->draw_calls, stats->texture_binds,
+           stats->color_changes, stats->vertices, renderer_overdraw(rend));
+    bench_render_perf_report();
+}
+
+/*
+ * Draw the same sprites spinning, resampled every frame or copied from
+ * pre-rotated frames
+ */
+static void bench_render_rotated_pass(renderer_t *rend, render_cmd_buffer_t *cmds,
+                                      SDL_Texture **textures, const SDL_Rect *rects,
+                                      const int *texture_of, bool cached) {
+    if (cached) {
+        for (int t = 0; t < BENCH_RENDER_TEXTURES; t++) {
+            if (!renderer_cache_rotations(rend, textures[t], 0)) {
+                return;
+            }
+        }
+    }
+
+    frame_stats_init(&g_render_frames);
+    perf_counters_reset(&g_perf);
+    for (int f = 0; f < BENCH_RENDER_FRAMES; f++) {
+        Uint64 start = timer_now();
+        perf_counters_begin(&g_perf);
+        render_cmd_reset(cmds);
+        render_cmd_clear(cmds, 0, 0, 0);
+        for (int i = 0; i < BENCH_RENDER_SPRITES; i++) {
+            SDL_Texture *tex = textures[texture_of[i]];
+            double angle = fmod(i * 7.0 + f * 1.5, 360.0);
+            render_cmd_quad(cmds, render_key(RENDER_LAYER_WORLD, 0,
+                                             render_material_from_texture(tex)),
+                            tex, NULL, &rects[i], angle, NULL, SDL_FLIP_NONE, 255, 255, 255);
+        }
+        perf_counters_mark(&g_perf, BENCH_PERF_RECORD);
+        render_cmd_sort(cmds);
+        perf_counters_mark(&g_perf, BENCH_PERF_SORT);
+        renderer_execute(rend, cmds);
+        renderer_present(rend);
+        perf_counters_mark(&g_perf, BENCH_PERF_EXECUTE);
+        frame_stats_push(&g_render_frames, FRAME_SERIES_FRAME,
+                         timer_elapsed_ms(start, timer_now()));
+    }
+
+    float ms = frame_stats_mean(&g_render_frames, FRAME_SERIES_FRAME);
+    float p99 = frame_stats_percentile(&g_render_frames, FRAME_SERIES_FRAME, 0.99f);
+    const renderer_stats_t *stats = renderer_get_stats(rend);
+    printf("render: %d sprites, rotated%s: %.3f ms/frame (p99 %.3f) | %u draws | "
+           "%u pre-rotated | %lu KB cache\n",
+           BENCH_RENDER_SPRITES, cached ? ", pre-rotated frames" : "", ms, p99,
+           stats->draw_calls, stats->rotations_cached,
+           (unsigned long)(renderer_rotation_cache_bytes(rend) / 1024));
+    bench_render_perf_report();
+
+    for (int t = 0; t < BENCH_RENDER_TEXTURES; t++) {
+        renderer_uncache_rotations(rend, textures[t]);
+    }
+}
+
+static void bench_render(void) {
+    renderer_t rend;
+    render_cmd_buffer_t cmds;
+
+    if (!renderer_init_headless(&rend, BENCH_RENDER_WIDTH, BENCH_RENDER_HEIGHT)) {
+        return;
+    }
+    if (!render_cmd_buffer_init(&cmds, BENCH_RENDER_SPRITES + 1)) {
+        renderer_cleanup(&rend);
+        return;
+    }
+
+    SDL_Texture *textures[BENCH_RENDER_TEXTURES];
+    for (int t = 0; t < BENCH_RENDER_TEXTURES; t++) {
+        textures[t] = texture_create_colored(renderer_get_sdl(&rend),
+                                             BENCH_RENDER_SIZE, BENCH_RENDER_SIZE,
+                                             (Uint8)(t * 32), 128, (Uint8)(255 - t * 32));
+    }
+
+    SDL_Rect *rects = malloc(sizeof(SDL_Rect) * BENCH_RENDER_SPRITES);
+    int *texture_of = malloc(sizeof(int) * BENCH_RENDER_SPRITES);
+    if (rects && texture_of) {
+        srand(99);
+        for (int i = 0; i < BENCH_RENDER_SPRITES; i++) {
+            rects[i].x = rand() % (BENCH_RENDER_WIDTH - BENCH_RENDER_SIZE);
+            rects[i].y = rand() % (BENCH_RENDER_HEIGHT - BENCH_RENDER_SIZE);
+            rects[i].w = BENCH_RENDER_SIZE;
+            rects[i].h = BENCH_RENDER_SIZE;
+            texture_of[i] = rand() % BENCH_RENDER_TEXTURES;
+        }
+
+        bench_render_pass(&rend, &cmds, textures, rects, texture_of, false);
+        bench_render_pass(&rend, &cmds, textures, rects, texture_of, true);
+        bench_render_solid_pass(&rend, &cmds, rects, texture_of);
+        bench_render_rotated_pass(&rend, &cmds, textures, rects, texture_of, false);
+        bench_render_rotated_pass(&rend, &cmds, textures, rects, texture_of, true);
+    }
+
+    free(rects);
+    free(texture_of);
+    for (int t = 0; t < BENCH_RENDER_TEXTURES; t++) {
+        texture_destroy(textures[t]);
+    }
+    render_cmd_buffer_cleanup(&cmds);
+    renderer_cleanup(&rend);
+}
+
+/* ============================================================================
+ * BATCH SIMULATION
+ * ============================================================================ */
+
+#define BENCH_SIM_WORLDS    4096
+#define BENCH_SIM_SPRITES   16      /* Per world */
+#define BENCH_SIM_CALLS     60      /* sim_batch_step calls, new actions before each */
+#define BENCH_SIM_STEPS     10      /* Fixed steps per call */
+
+/*
+ * Step the same worlds with the same actions on thread_count threads
+ */
+static void bench_sim_batch_run(int thread_count) {
+    sim_batch_t batch;
+    if (!sim_batch_init(&batch, BENCH_SIM_WORLDS, BENCH_SIM_SPRITES, thread_count, 42)) {
+        return;
+    }
+
+    Uint32 rng = 7;
+    float total_ms = 0.0f;
+    perf_counters_reset(&g_perf);
+    for (int c = 0; c < BENCH_SIM_CALLS; c++) {
+        for (int w = 0; w < batch.world_count; w++) {
+            rng = rng * 1664525u + 1013904223u;
+            batch.actions[w] = (Uint8)(rng >> 28);
+        }
+        perf_counters_begin(&g_perf);
+        sim_batch_step(&batch, FIXED_TIMESTEP, BENCH_SIM_STEPS);
+        perf_counters_mark(&g_perf, BENCH_PERF_RUN);
+        total_ms += batch.last_run_ms;
+    }
+
+    /* Identical for every thread count - the worlds are deterministic */
+    Uint64 hits = 0;
+    for (int w = 0; w < batch.world_count; w++) {
+        hits += batch.hits[w];
+    }
+
+    printf("sim_batch: %d worlds x %d sprites, %d thread%s: %.2f M world-steps/s "
+           "(%.3f ms per %d-step call) | hits %llu\n",
+           BENCH_SIM_WORLDS, BENCH_SIM_SPRITES, batch.thread_count,
+           batch.thread_count == 1 ? "" : "s",
+           (double)batch.world_steps * 1000.0 / total_ms / 1e6,
+           total_ms / BENCH_SIM_CALLS, BENCH_SIM_STEPS, (unsigned long long)hits);
+    /* Counters follow the calling thread only - workers would go uncounted */
+    if (batch.thread_count == 1) {
+        bench_perf_report("step:", BENCH_PERF_RUN, (double)batch.world_steps, "world-step");
+    }
+    sim_batch_cleanup(&batch);
+}
+
+static void bench_sim_batch(void) {
+    bench_sim_batch_run(1);
+    bench_sim_batch_run(0);
+}
+
+/* ============================================================================
+ * DRIVER
+ * ============================================================================ */
+
+static const bench_t BENCHMARKS[] = {
+    { "flow_field", bench_flow_field },
+    { "physics", bench_physics },
+    { "render", bench_render },
+    { "sim_batch", bench_sim_batch },
+};
+
+#define BENCHMARK_COUNT ((int)(sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0])))
+
+int main(int argc, char *argv[]) {
+    int ran = 0;
+
+    perf_counters_init(&g_perf);
+    perf_counters_open(&g_perf);
+
+    for (int b = 0; b < BENCHMARK_COUNT; b++) {
+        bool selected = argc < 2;
+        for (int a = 1; a < argc; a++) {
+            if (strcmp(argv[a], BENCHMARKS[b].name) == 0) {
+                selected = true;
+            }
+        }
+        if (selected) {
+            BENCHMARKS[b].run();
+            ran++;
+        }
+    }
+
+    if (ran == 0) {
+        fprintf(stderr, "Unknown benchmark. Available:");
+        for (int b = 0; b < BENCHMARK_COUNT; b++) {
+            fprintf(stderr, " %s", BENCHMARKS[b].name);
+        }
+        fprintf(stderr, "\n");
+        perf_counters_close(&g_perf);
+        return 1;
+    }
+    perf_counters_close(&g_perf);
+    return 0;
+}
@@ -0,0 +1,238 @@
+/*
+ * Knight Engine 2D - Telemetry Reader
+ *
+ * Binds the engine's telemetry socket and tails the per-frame metric
+ * lines, printing min/avg/max of every numeric field once per interval.
+ * Fields are discovered from the lines themselves, so new metrics show up
+ * without changes here. Start it before or after the engine; the engine
+ * retries about once a second until a reader is bound.
+ *
+ *   knight_telemetry                 aggregate every second
+ *   knight_telemetry -i 5            aggregate every 5 seconds
+ *   knight_telemetry -r              print raw lines as they arrive
+ *   knight_telemetry -p /tmp/x.sock  use another socket path
+ *
+ * POSIX only (Unix domain sockets).
+ */
+
+#include "core/config.h"
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define READER_MAX_FIELDS 32
+#define READER_KEY_MAX    24
+
+typedef struct {
+    char key[READER_KEY_MAX];
+    double sum;
+    double min;
+    double max;
+    long count;
+} field_stats_t;
+
+typedef struct {
+    field_stats_t fields[READER_MAX_FIELDS];
+    int field_count;
+    long lines;
+    long missed;            /* Gaps in the frame numbering */
+    long long last_frame;   /* -1 before the first line */
+} reader_stats_t;
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static field_stats_t *stats_field(reader_stats_t *stats, const char *key, size_t len) {
+    for (int i = 0; i < stats->field_count; i++) {
+        if (strlen(stats->fields[i].key) == len &&
+            strncmp(stats->fields[i].key, key, len) == 0) {
+            return &stats->fields[i];
+        }
+    }
+    if (stats->field_count >= READER_MAX_FIELDS || len >= READER_KEY_MAX) {
+        return NULL;
+    }
+
+    field_stats_t *field = &stats->fields[stats->field_count++];
+    memset(field, 0, sizeof(*field));
+    memcpy(field->key, key, len);
+    field->key[len] = '\0';
+    return field;
+}
+
+/* Clear the numbers but keep the field order, so columns stay stable */
+static void stats_reset(reader_stats_t *stats) {
+    for (int i = 0; i < stats->field_count; i++) {
+        stats->fields[i].sum = 0.0;
+        stats->fields[i].count = 0;
+    }
+    stats->lines = 0;
+    stats->missed = 0;
+}
+
+static void stats_add_line(reader_stats_t *stats, char *line) {
+    stats->lines++;
+
+    for (char *tok = strtok(line, " \n"); tok; tok = strtok(NULL, " \n")) {
+        char *eq = strchr(tok, '=');
+        if (!eq) {
+            continue;
+        }
+        char *end;
+        double value = strtod(eq + 1, &end);
+        if (end == eq + 1) {
+            continue;
+        }
+
+        size_t key_len = (size_t)(eq - tok);
+        if (key_len == 5 && strncmp(tok, "frame", 5) == 0) {
+            long long frame = (long long)value;
+            if (stats->last_frame >= 0 && frame > stats->last_frame + 1) {
+                stats->missed += frame - stats->last_frame - 1;
+            }
+            stats->last_frame = frame;
+            continue;
+        }
+
+        field_stats_t *field = stats_field(stats, tok, key_len);
+        if (!field) {
+            continue;
+        }
+        if (field->count == 0 || value < field->min) {
+            field->min = value;
+        }
+        if (field->count == 0 || value > field->max) {
+            field->max = value;
+        }
+        field->sum += value;
+        field->count++;
+    }
+}
+
+static void stats_print(const reader_stats_t *stats, double elapsed) {
+    printf("---- %ld frames in %.1fs (%.1f/s), %ld missed ----\n",
+           stats->lines, elapsed, stats->lines / elapsed, stats->missed);
+    for (int i = 0; i < stats->field_count; i++) {
+        const field_stats_t *field = &stats->fields[i];
+        if (field->count == 0) {
+            continue;
+        }
+        printf("  %-12s avg %12.3f   min %12.3f   max %12.3f\n",
+               field->key, field->sum / field->count, field->min, field->max);
+    }
+    fflush(stdout);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-p socket_path] [-i interval_seconds] [-r]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    const char *path = TELEMETRY_SOCKET_PATH;
+    double interval = 1.0;
+    bool raw = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0) {
+            raw = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (interval <= 0.0) {
+        interval = 1.0;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "socket: %s\n", strerror(errno));
+        return 1;
+    }
+
+    /* A stale socket file from an earlier reader would block the bind */
+    unlink(path);
+    if (bind(fd, (const struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "bind %s: %s\n", path, strerror(errno));
+        close(fd);
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    printf("Listening on %s\n", path);
+    fflush(stdout);
+
+    reader_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.last_frame = -1;
+    double window_start = now_seconds();
+
+    while (!g_stop) {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        int ready = poll(&pfd, 1, 100);
+        if (ready < 0 && errno != EINTR) {
+            fprintf(stderr, "poll: %s\n", strerror(errno));
+            break;
+        }
+
+        /* Drain everything queued before checking the clock */
+        while (ready > 0) {
+            char line[1024];
+            ssize_t len = recv(fd, line, sizeof(line) - 1, MSG_DONTWAIT);
+            if (len <= 0) {
+                break;
+            }
+            line[len] = '\0';
+            if (raw) {
+                fputs(line, stdout);
+                continue;
+            }
+            stats_add_line(&stats, line);
+        }
+
+        double now = now_seconds();
+        if (!raw && now - window_start >= interval) {
+            if (stats.lines > 0) {
+                stats_print(&stats, now - window_start);
+            }
+            stats_reset(&stats);
+            window_start = now;
+        }
+    }
+
+    close(fd);
+    unlink(path);
+    return 0;
+}